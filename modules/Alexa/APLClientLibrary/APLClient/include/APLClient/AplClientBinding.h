@@ -26,6 +26,7 @@
 #include "AplCoreGuiRenderer.h"
 #include "AplOptionsInterface.h"
 #include "AplClientRenderer.h"
+#include "AplTextMeasurementBackendInterface.h"
 #include "Extensions/AplCoreExtensionInterface.h"
 #include "Extensions/AplCoreExtensionEventCallbackResultInterface.h"
 #include "Telemetry/DownloadMetricsEmitter.h"
@@ -69,6 +70,15 @@ public:
      */
     void onTelemetrySinkUpdated(APLClient::Telemetry::AplMetricsSinkInterfacePtr sink);
 
+    /**
+     * Set an in-process text measurement backend to the @c AplConfiguration. Renderers will consult it before
+     * falling back to the viewhost for text measurement.
+     *
+     * @param backend a shared pointer of @c AplTextMeasurementBackendInterface to be used, or @c nullptr to always
+     * measure on the viewhost.
+     */
+    void setTextMeasurementBackend(AplTextMeasurementBackendInterfacePtr backend);
+
 private:
     AplConfigurationPtr m_aplConfiguration;
 };
@@ -58,6 +58,15 @@ public:
      */
     bool shouldHandleMessage(const std::string& message);
 
+    /**
+     * Pass a message received from the viewhost and parsed by the caller to the @c AplClientBinding, see
+     * @c shouldHandleMessage(const std::string&). The message is not kept beyond the call.
+     *
+     * @param message The parsed message
+     * @return true if the message should be passed onwards to handleMessage, false if handling is complete
+     */
+    bool shouldHandleMessage(const rapidjson::Value& message);
+
     /**
      * Pass a message received from the viewhost to the @c AplClientBinding, should only be called if
      * @c shouldHandleMessage returns true and must be run on the same thread as @c renderDocument
@@ -65,6 +74,13 @@ public:
      */
     void handleMessage(const std::string& message);
 
+    /**
+     * Pass a message received from the viewhost and parsed by the caller to the @c AplClientBinding, see
+     * @c handleMessage(const std::string&). The message is not kept beyond the call.
+     * @param message The parsed message from the viewhost
+     */
+    void handleMessage(const rapidjson::Value& message);
+
     /**
      * Render an APL document
      * @param document The document json payload
@@ -114,6 +130,13 @@ public:
      */
     void onUpdateTick();
 
+    /**
+     * Returns how long the caller may wait before the next call to @c onUpdateTick is required
+     *
+     * @return Zero if an update is due now, @c std::chrono::milliseconds::max() if no update is scheduled
+     */
+    std::chrono::milliseconds getNextUpdateDelay();
+
     /**
      * Returns the target window Id for this renderer
      */
@@ -149,9 +172,19 @@ public:
 
     /**
      * Retrieve the active @c AplDocumentState.
+     * @param estimateSize Whether to estimate the size of the document state, which serializes its whole component
+     * hierarchy. Only needed when the live document states are bounded in bytes.
      * @return The active @c AplDocumentState.
      */
-    AplDocumentStatePtr getActiveDocumentState();
+    AplDocumentStatePtr getActiveDocumentState(bool estimateSize = false);
+
+    /**
+     * Reports the size of the backstack once a document state of the active document was added to it.
+     * @param documentState The document state added to the backstack.
+     * @param documentStates The number of document states in the backstack.
+     * @param liveBytes The estimated size in bytes of the live document states in the backstack.
+     */
+    void reportBackstackSize(const AplDocumentStatePtr& documentState, size_t documentStates, size_t liveBytes);
 
     /**
      * Restore content from provided @c AplDocumentState
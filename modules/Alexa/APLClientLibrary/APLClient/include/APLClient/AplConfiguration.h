@@ -16,9 +16,13 @@
 #ifndef APL_CLIENT_LIBRARY_APL_CONFIGURATION_H_
 #define APL_CLIENT_LIBRARY_APL_CONFIGURATION_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 
+#include "AplCoreContentCache.h"
 #include "AplOptionsInterface.h"
+#include "AplTextMeasurementBackendInterface.h"
 #include "Telemetry/AplMetricsRecorderInterface.h"
 
 namespace APLClient {
@@ -28,6 +32,11 @@ namespace APLClient {
  */
 class AplConfiguration final {
 public:
+    /**
+     * Returns the number of heap allocations the process has made so far.
+     */
+    using AllocationCounter = std::function<uint64_t()>;
+
     AplConfiguration(
             AplOptionsInterfacePtr options,
             Telemetry::AplMetricsRecorderInterfacePtr metricsRecorder = nullptr);
@@ -57,9 +66,51 @@ public:
      */
     void setMetricsRecorder(Telemetry::AplMetricsRecorderInterfacePtr metricsRecorder);
 
+    /**
+     * Returns the currently configured in-process text measurement backend.
+     *
+     * @return the current text measurement backend, or @c nullptr if measurements are delegated to the viewhost
+     */
+    AplTextMeasurementBackendInterfacePtr getTextMeasurementBackend() const;
+
+    /**
+     * Updates the in-process text measurement backend. Passing @c nullptr restores the default behavior of
+     * delegating all measurements to the viewhost.
+     *
+     * @param textMeasurementBackend the new text measurement backend to use
+     */
+    void setTextMeasurementBackend(AplTextMeasurementBackendInterfacePtr textMeasurementBackend);
+
+    /**
+     * Returns the cache of parsed documents and imported packages shared by the renderers of this configuration.
+     * This is never null.
+     *
+     * @return the content cache
+     */
+    AplCoreContentCachePtr getContentCache() const;
+
+    /**
+     * Returns the allocation counter used to report the heap allocations made per frame.
+     *
+     * @return the allocation counter, empty if the allocations are not reported
+     */
+    const AllocationCounter& getAllocationCounter() const;
+
+    /**
+     * Sets the allocation counter used to report the heap allocations made per frame. The library cannot count the
+     * allocations of the process itself, so this is provided by applications which replace the global allocation
+     * functions. It must be set before documents are rendered.
+     *
+     * @param allocationCounter the allocation counter, or an empty function to stop reporting
+     */
+    void setAllocationCounter(AllocationCounter allocationCounter);
+
 private:
     AplOptionsInterfacePtr m_aplOptions;
     Telemetry::AplMetricsRecorderInterfacePtr m_metricsRecorder;
+    AplTextMeasurementBackendInterfacePtr m_textMeasurementBackend;
+    AplCoreContentCachePtr m_contentCache;
+    AllocationCounter m_allocationCounter;
 };
 
 /// Convenience typedef
@@ -0,0 +1,94 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_CORE_CASE_MAPPING_H_
+#define APL_CLIENT_LIBRARY_APL_CORE_CASE_MAPPING_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace APLClient {
+
+/**
+ * In-process Unicode case mapping following the full case mappings of the Unicode character database, including the
+ * special casing of Turkish and Azerbaijani dotted and dotless i, the German sharp s, the Greek final sigma and the
+ * removal of Greek accents from upper case.
+ *
+ * Only the Latin, Greek and Cyrillic blocks and a set of scripts without case are covered. Strings with other
+ * characters, and locales with special casing rules which are not implemented, are left to the view host.
+ */
+class AplCoreCaseMapping {
+public:
+    /**
+     * Maps a string to upper or lower case with the rules of a locale.
+     *
+     * @param value The UTF-8 string
+     * @param locale The BCP-47 locale, the default rules are used if empty
+     * @param upper Whether to map to upper case rather than lower case
+     * @param[out] result The mapped string, only valid if @c true is returned
+     * @return @c false if the locale or some characters are not covered, or if the string is not valid UTF-8
+     */
+    static bool toCase(const std::string& value, const std::string& locale, bool upper, std::string& result);
+
+private:
+    /**
+     * Decodes a UTF-8 string.
+     *
+     * @param value The UTF-8 string
+     * @param[out] codePoints The decoded code points
+     * @return @c false if the string is not valid UTF-8
+     */
+    static bool decodeUtf8(const std::string& value, std::vector<uint32_t>& codePoints);
+
+    /**
+     * Appends the UTF-8 encoding of a code point.
+     */
+    static void encodeUtf8(uint32_t codePoint, std::string& out);
+
+    /**
+     * @return Whether the case mapping of the code point is known.
+     */
+    static bool isCovered(uint32_t codePoint);
+
+    /**
+     * @return The simple lower case mapping of a covered code point.
+     */
+    static uint32_t lowerCase(uint32_t codePoint);
+
+    /**
+     * @return The simple upper case mapping of a covered code point.
+     */
+    static uint32_t upperCase(uint32_t codePoint);
+
+    /**
+     * @return Whether the code point is a cased letter.
+     */
+    static bool isCased(uint32_t codePoint);
+
+    /**
+     * @return Whether the code point is ignored when looking for the cased letters around a sigma.
+     */
+    static bool isCaseIgnorable(uint32_t codePoint);
+
+    /**
+     * @return Whether the capital sigma at @c index of @c codePoints ends a word, and so lowers to a final sigma.
+     */
+    static bool isFinalSigma(const std::vector<uint32_t>& codePoints, size_t index);
+};
+
+}  // namespace APLClient
+
+#endif  // APL_CLIENT_LIBRARY_APL_CORE_CASE_MAPPING_H_
@@ -16,9 +16,16 @@
 #ifndef APL_CLIENT_LIBRARY_APL_CORE_CONNECTION_MANAGER_H_
 #define APL_CLIENT_LIBRARY_APL_CORE_CONNECTION_MANAGER_H_
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <future>
+#include <thread>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wreorder"
 #pragma push_macro("DEBUG")
@@ -35,7 +42,11 @@
 
 #include "AplConfiguration.h"
 #include "AplCoreViewhostMessage.h"
+#include "AplCoreDirtyEncoder.h"
+#include "AplCoreLocaleMethodsCache.h"
+#include "AplCoreLruCache.h"
 #include "AplCoreMetrics.h"
+#include "AplCoreTextMeasurementCache.h"
 #include "Extensions/AplCoreExtensionEventCallbackResultInterface.h"
 #include "Extensions/AplCoreExtensionEventHandlerInterface.h"
 #include "Extensions/AplCoreExtensionInterface.h"
@@ -58,7 +69,7 @@ class AplCoreConnectionManager
 public:
     AplCoreConnectionManager(AplConfigurationPtr config);
 
-    virtual ~AplCoreConnectionManager() = default;
+    virtual ~AplCoreConnectionManager();
 
 public:
     /// @name AplCoreExtensionEventHandlerInterface Functions
@@ -79,8 +90,15 @@ public:
      * Sets the APL Content to be rendered by the APL Core
      * @param content
      * @param token APL Presentation token for this content
+     * @param documentHash Hash of the document source, used to remember the scaling it inflates with. Zero if unknown.
+     * @param source The JSON text the content was created from, used to hibernate the document in the backstack.
+     * @c nullptr if unknown, in which case the document is never hibernated.
      */
-    virtual void setContent(const apl::ContentPtr content, const std::string& token);
+    virtual void setContent(
+        const apl::ContentPtr content,
+        const std::string& token,
+        size_t documentHash = 0,
+        AplDocumentSourcePtr source = nullptr);
 
     /**
      * Sets the APL ScalingOptions
@@ -96,12 +114,27 @@ public:
      */
     bool shouldHandleMessage(const std::string& message);
 
+    /**
+     * Receives a parsed message from the APL view host and identifies if it will require further handling. The message
+     * is not kept beyond the call.
+     * @note This function does not need to be handled on the same execution thread as other function calls
+     * @param message The message
+     * @return true if the message should be passed to @c handleMessage, false if message
+     */
+    bool shouldHandleMessage(const rapidjson::Value& message);
+
     /**
      * Receives messages from the APL view host
      * @param message The JSON Payload
      */
     void handleMessage(const std::string& message);
 
+    /**
+     * Receives a parsed message from the APL view host. The message is not kept beyond the call.
+     * @param message The message
+     */
+    void handleMessage(const rapidjson::Value& message);
+
     /**
      * Executes an APL command
      * @param command The command to execute
@@ -123,8 +156,10 @@ public:
     void interruptCommandSequence();
 
     /**
-     * Send a message to the view host and block until you get a reply
+     * Send a message to the view host and block until you get a reply. Several threads may wait for replies at the
+     * same time, each reply is matched to its request by sequence number.
      * @param message The message to send
+     * @param timeout How long to wait for the reply to this request
      * @return The resultant message or a NULL object if a response was not received.
      */
     rapidjson::Document blockingSend(
@@ -133,9 +168,22 @@ public:
 
     void provideState(unsigned int stateRequestToken);
 
-    AplCoreMetricsPtr aplCoreMetrics() const {
-        return m_AplCoreMetrics;
-    }
+    /**
+     * Returns the scaled metrics of the document being inflated or rendered. While a document is inflated
+     * speculatively, the worker performing the inflation sees the metrics chosen for that inflation.
+     *
+     * @return The scaling calculation object.
+     */
+    AplCoreMetricsPtr aplCoreMetrics() const;
+
+    /**
+     * Emits a rendering event or metric of the document being inflated or rendered. The runtime and the metrics
+     * recorder are only used from the executor thread, so a notification made by the worker of a speculative inflation
+     * is kept with the speculation, and emitted on the executor thread once the speculation is taken.
+     *
+     * @param notification The notification to emit.
+     */
+    void emitNotification(std::function<void()> notification);
 
     /**
      * Schedules an update on the root context and runs the update loop - this may result in the viewhost being
@@ -145,6 +193,14 @@ public:
      */
     void onUpdateTick();
 
+    /**
+     * Returns how long the caller may wait before the next call to @c onUpdateTick is required, allowing the update
+     * loop to sleep while nothing is dirty, animating or scheduled.
+     *
+     * @return Zero if an update is due now, @c std::chrono::milliseconds::max() if no update is scheduled
+     */
+    std::chrono::milliseconds getNextUpdateDelay();
+
     /**
      * Resets the connection manager to remove the current document
      */
@@ -184,9 +240,22 @@ public:
 
     /**
      * Retrieve the active @c AplDocumentState.
+     * @param estimateSize Whether to estimate the size of the document state, which serializes its whole component
+     * hierarchy. Only needed when the live document states are bounded in bytes.
      * @return The active @c AplDocumentState.
      */
-    AplDocumentStatePtr getActiveDocumentState();
+    AplDocumentStatePtr getActiveDocumentState(bool estimateSize = false);
+
+    /**
+     * Reports the size of the backstack once a document state of the current document was added to it. The values
+     * are reported as samples rather than running totals, the backstack shrinking as documents are restored or
+     * cleared.
+     *
+     * @param documentState The document state added to the backstack, its estimated size reported per state.
+     * @param documentStates The number of document states in the backstack.
+     * @param liveBytes The estimated size in bytes of the live document states in the backstack.
+     */
+    void reportBackstackSize(const AplDocumentStatePtr& documentState, size_t documentStates, size_t liveBytes);
 
     /**
      * Restore content from provided @c AplDocumentState
@@ -237,6 +306,139 @@ private:
      */
     void handleBuild(const rapidjson::Value& message);
 
+    /**
+     * A document inflated ahead of the view host "build" handshake, using the build message of the previous document.
+     */
+    struct SpeculativeInflation {
+        /// The serialized build message the inflation was based on.
+        std::string buildMessage;
+        /// The root config used for the inflation.
+        apl::RootConfig config;
+        /// The viewport specifications remaining after scaling.
+        std::vector<apl::ViewportSpecification> viewportSizeSpecifications;
+        /// The scaled metrics the document was inflated with.
+        AplCoreMetricsPtr aplCoreMetrics;
+        /// The inflated root context, or @c nullptr if inflation failed.
+        apl::RootContextPtr root;
+        /// Whether inflation needed a reply from the view host, which cannot be given before the handshake.
+        bool needsViewhost = false;
+        /// The number of inflation attempts made.
+        unsigned int attempts = 0;
+        /// The notifications made by the worker, emitted when the speculation is taken.
+        std::vector<std::function<void()>> notifications;
+    };
+
+    /**
+     * A candidate update of a component in a "dirty" message.
+     */
+    struct DirtyUpdate {
+        /// The unique id of the component.
+        std::string uid;
+        /// The order in which the update was added, later full updates replacing earlier ones.
+        size_t order;
+        /// The component whose dirty properties are sent, or @c nullptr if @c serialized is sent in full.
+        apl::ComponentPtr component;
+        /// The full update.
+        rapidjson::Value serialized;
+    };
+
+    /**
+     * Creates the root config for a document from a build message.
+     * @param message The build message payload
+     * @return The root config
+     */
+    apl::RootConfig createRootConfig(const rapidjson::Value& message);
+
+    /**
+     * Creates the viewport metrics described by a build message.
+     * @param message The build message payload
+     * @return The viewport metrics
+     */
+    apl::Metrics createMetrics(const rapidjson::Value& message);
+
+    /**
+     * Returns the key under which the scaling of the current document is remembered.
+     * @param buildMessage The serialized build message payload
+     * @return The key, or an empty string if the current document is not identified.
+     */
+    std::string getScalingKey(const std::string& buildMessage);
+
+    /**
+     * Inflates a document, starting from the viewport specifications left by the last successful inflation with the
+     * same @c scalingKey, so that specifications the document failed to inflate with are not tried again.
+     * @note Only @c m_aplConfiguration and @c m_scalingCache are accessed, so this may run off the message handling
+     * thread.
+     *
+     * @param content The document content
+     * @param metrics The viewport metrics
+     * @param config The root config
+     * @param scalingKey The key of the remembered scaling, see @c getScalingKey
+     * @param[in,out] specifications The viewport specifications to choose the scaling from
+     * @param[out] aplCoreMetrics The scaled metrics of the last inflation attempt
+     * @param[out] attempts The number of inflation attempts made
+     * @param beforeCreate Called before each inflation attempt, once @c aplCoreMetrics has been updated
+     * @return The root context, or @c nullptr if the document could not be inflated
+     */
+    apl::RootContextPtr inflate(
+        const apl::ContentPtr& content,
+        const apl::Metrics& metrics,
+        const apl::RootConfig& config,
+        const std::string& scalingKey,
+        std::vector<apl::ViewportSpecification>& specifications,
+        AplCoreMetricsPtr& aplCoreMetrics,
+        unsigned int* attempts,
+        const std::function<void()>& beforeCreate);
+
+    /**
+     * Inflates a document, dropping viewport specifications the document cannot be inflated with until one succeeds.
+     *
+     * @param content The document content
+     * @param metrics The viewport metrics
+     * @param config The root config
+     * @param[in,out] specifications The viewport specifications to choose the scaling from
+     * @param[out] aplCoreMetrics The scaled metrics of the last inflation attempt
+     * @param[in,out] attempts Incremented for each inflation attempt
+     * @param beforeCreate Called before each inflation attempt, once @c aplCoreMetrics has been updated
+     * @return The root context, or @c nullptr if the document could not be inflated
+     */
+    apl::RootContextPtr inflateWithScaling(
+        const apl::ContentPtr& content,
+        const apl::Metrics& metrics,
+        const apl::RootConfig& config,
+        std::vector<apl::ViewportSpecification>& specifications,
+        AplCoreMetricsPtr& aplCoreMetrics,
+        unsigned int* attempts,
+        const std::function<void()>& beforeCreate);
+
+    /**
+     * Inflates a hibernated document state again from its source and root config, with the current time, and restores
+     * the state of its components.
+     *
+     * @param documentState The hibernated document state
+     * @return The root context, or @c nullptr if the document could not be inflated
+     */
+    apl::RootContextPtr inflateDocumentState(const AplDocumentStatePtr& documentState);
+
+    /**
+     * Estimates the memory held by the live @c RootContext of the current document, from the size of its serialized
+     * component hierarchy.
+     *
+     * @return The estimated size in bytes
+     */
+    size_t estimateDocumentStateSize();
+
+    /**
+     * Starts inflating @c m_Content on a worker thread with the last build message, if the document can be inflated
+     * without the view host. Text must be measured by an in-process backend or from cached measurements for that.
+     */
+    void startSpeculativeInflation();
+
+    /**
+     * Waits for the pending speculative inflation, if any, emits its notifications and takes ownership of it.
+     * @return The speculative inflation, or @c nullptr if none was started.
+     */
+    std::shared_ptr<SpeculativeInflation> takeSpeculativeInflation();
+
     /**
      * Handles the configuration change message from the view host and send to Core.
      * @param message
@@ -385,6 +587,28 @@ private:
      */
     void processDirty(const std::set<apl::ComponentPtr>& dirty);
 
+    /**
+     * Process set of dirty components and send out the changed properties as a "dirtyDelta" message.
+     * @param dirty dirty components set.
+     */
+    void processDirtyDelta(const std::set<apl::ComponentPtr>& dirty);
+
+    /**
+     * Drops the cached visual context if a dirty component changed a property reported in the visual context.
+     * @param dirty dirty components set.
+     */
+    void invalidateVisualContext(const std::set<apl::ComponentPtr>& dirty);
+
+    /**
+     * Serialize the dirty properties of a vector graphic component along with its dirty graphic elements.
+     * @param component vector graphic component.
+     * @param allocator allocator of the message.
+     * @return serialized update.
+     */
+    rapidjson::Value serializeDirtyGraphic(
+        const apl::ComponentPtr& component,
+        rapidjson::Document::AllocatorType& allocator);
+
     /**
      * APL Core relies on operations to be performed in particular way.
      * Order and set of operations in this method should be preserved.
@@ -403,6 +627,19 @@ private:
      */
     unsigned int send(AplCoreViewhostMessage& message);
 
+    /**
+     * Send a message created with @c m_frameAllocator to the view host, serializing it into the reused frame output.
+     * @param message The message to send
+     * @return The sequence number of this message
+     */
+    unsigned int sendFrame(AplCoreViewhostMessage& message);
+
+    /**
+     * Clears @c m_frameAllocator at the end of a frame, growing its buffer if the frame did not fit.
+     * @return Whether the frame needed memory beyond the buffer
+     */
+    bool resetFrameAllocator();
+
     /**
      * Sends an error message to the view host
      * @param message The message to send to the view hsot
@@ -492,6 +729,9 @@ private:
     /// Shared pointer to the APL Content
     apl::ContentPtr m_Content;
 
+    /// The JSON text @c m_Content was created from, @c nullptr if unknown
+    AplDocumentSourcePtr m_contentSource;
+
     /// The APL presentation token for the currently rendered document
     std::string m_aplToken;
 
@@ -525,19 +765,52 @@ private:
     bool m_ScreenLock;
 
     /// Next packet sequence number
-    unsigned int m_SequenceNumber;
+    std::atomic<unsigned int> m_SequenceNumber;
+
+    /**
+     * A request sent by @c blockingSend which was answered or timed out. Settled requests are remembered for a while,
+     * so duplicate and late replies can be told apart from other messages.
+     */
+    struct SettledBlockingRequest {
+        /// Whether the request timed out before it was answered
+        bool timedOut;
+
+        /// When the request was answered or timed out
+        std::chrono::steady_clock::time_point settledTime;
+    };
+
+    /// The requests sent by @c blockingSend which are waiting for a reply, mapped to the promise of the reply
+    using PendingBlockingRequests = std::unordered_map<unsigned int, std::promise<rapidjson::Document>>;
+
+    /**
+     * Forgets the requests settled long enough ago.
+     * @note Must be called with @c m_blockingRequestsMutex held.
+     */
+    void pruneBlockingRequests();
 
-    /// The sequence number which a blockingSend is waiting for
-    unsigned int m_replyExpectedSequenceNumber;
+    /**
+     * Moves a pending request to the settled requests.
+     * @note Must be called with @c m_blockingRequestsMutex held.
+     * @param request The pending request
+     * @param timedOut Whether the request timed out
+     */
+    void settleBlockingRequest(PendingBlockingRequests::iterator request, bool timedOut);
 
-    /// Whether we are expecting a reply to a blockingSend
-    bool m_blockingSendReplyExpected;
+    /// The pending requests sent by @c blockingSend, keyed by sequence number
+    PendingBlockingRequests m_pendingBlockingRequests;
 
-    /// The pending promise from a call to blockingSend
-    std::promise<std::string> m_replyPromise;
+    /// The settled requests sent by @c blockingSend, keyed by sequence number
+    std::unordered_map<unsigned int, SettledBlockingRequest> m_settledBlockingRequests;
 
-    /// The mutex protecting blockingSend
-    std::mutex m_blockingSendMutex;
+    /// The number of entries of @c m_pendingBlockingRequests, readable without taking the lock. Text messages are only
+    /// parsed to look for replies while it is not zero.
+    std::atomic<size_t> m_pendingBlockingRequestCount;
+
+    /// The number of entries of @c m_settledBlockingRequests, readable without taking the lock
+    std::atomic<size_t> m_settledBlockingRequestCount;
+
+    /// The mutex protecting @c m_pendingBlockingRequests and @c m_settledBlockingRequests
+    std::mutex m_blockingRequestsMutex;
 
     /// Pointer to ExtensionManager
     AplCoreExtensionManagerPtr m_extensionManager;
@@ -545,7 +818,70 @@ private:
     /// Pointer to the active @c AplDocumentState to restore.
     AplDocumentStatePtr m_documentStateToRestore;
 
+    /// Text measurement cache, shared by all documents rendered through this connection manager
+    AplCoreTextMeasurementCachePtr m_textMeasurementCache;
+
+    /// Locale method cache, shared by all documents rendered through this connection manager
+    AplCoreLocaleMethodsCachePtr m_localeMethodsCache;
+
     std::chrono::steady_clock::time_point m_renderingStart;
+
+    /// The serialized payload of the last build message, used to inflate following documents speculatively.
+    std::string m_lastBuildMessage;
+
+    /// The pending speculative inflation, if any.
+    std::shared_ptr<SpeculativeInflation> m_speculation;
+
+    /// The worker performing @c m_speculation, joined before the speculation is taken.
+    std::thread m_speculationThread;
+
+    /// Hash of the source of the current document, or zero if unknown.
+    size_t m_documentHash;
+
+    /// Hash of the supported viewports payload of the current document.
+    size_t m_supportedViewportsHash;
+
+    /// Viewport specifications left after documents were inflated with fewer, keyed by @c getScalingKey.
+    AplCoreLruCache<std::string, std::vector<apl::ViewportSpecification>> m_scalingCache;
+
+    /// Whether the view host asked for dirty updates as "dirtyDelta" messages.
+    bool m_dirtyDeltaEnabled;
+
+    /// Encodes dirty updates as deltas against the values the view host already has.
+    AplCoreDirtyEncoder m_dirtyEncoder;
+
+    /// The last visual context provided, reused until the document changes in a way the visual context reports.
+    std::string m_visualContext;
+
+    /// Whether @c m_visualContext is up to date.
+    bool m_visualContextValid;
+
+    /// The buffer backing @c m_frameAllocator.
+    std::unique_ptr<char[]> m_frameBuffer;
+
+    /// The size of @c m_frameBuffer.
+    size_t m_frameBufferSize;
+
+    /// The allocator of the messages sent by the frame loop, reusing @c m_frameBuffer every frame.
+    std::unique_ptr<rapidjson::Document::AllocatorType> m_frameAllocator;
+
+    /// The serialized messages sent by the frame loop, reused every frame.
+    std::string m_frameOutput;
+
+    /// The candidate updates of the "dirty" message, reused every frame.
+    std::vector<DirtyUpdate> m_dirtyUpdates;
+
+    /// Whether data sources were used by the document, so that their errors need checking every frame.
+    bool m_dataSourcesUsed;
+
+    /// The timezone offset of the device, refreshed every @c TIMEZONE_REFRESH_INTERVAL.
+    std::chrono::milliseconds m_timezoneOffset;
+
+    /// The time @c m_timezoneOffset was last refreshed.
+    std::chrono::steady_clock::time_point m_timezoneOffsetRefreshed;
+
+    /// The speculative inflation being performed by the current thread, if any.
+    static thread_local SpeculativeInflation* s_currentSpeculation;
 };
 
 using AplCoreConnectionManagerPtr = std::shared_ptr<AplCoreConnectionManager>;
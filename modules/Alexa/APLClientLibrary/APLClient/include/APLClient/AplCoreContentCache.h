@@ -0,0 +1,131 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_CORE_CONTENT_CACHE_H_
+#define APL_CLIENT_LIBRARY_APL_CORE_CONTENT_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <rapidjson/document.h>
+
+#include "AplCoreLruCache.h"
+
+namespace APLClient {
+
+/**
+ * A bounded least-recently-used cache of parsed APL documents, keyed by a hash of the document. A single instance is
+ * shared by every renderer of a binding, so that a document sent again with other data sources is not parsed again.
+ *
+ * An @c apl::Content binds its data sources in place and can't be reused, so the cache holds the parsed JSON it is
+ * created from instead. Imported packages are not cached here, the download manager decides how long they are reused.
+ */
+class AplCoreContentCache {
+public:
+    /// The default maximum number of cached documents
+    static const size_t DEFAULT_MAX_ENTRIES;
+
+    /**
+     * Constructor
+     *
+     * @param maxEntries The maximum number of documents to keep, least recently used entries are evicted first
+     */
+    explicit AplCoreContentCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    /**
+     * Look up a document, marking it as most recently used.
+     *
+     * @param documentHash The hash of the raw document
+     * @param rawDocument The raw document
+     * @param creationTime If not @c nullptr, set to the time it took to parse the document and create its content
+     * @return The parsed document, or @c nullptr if the document is not cached
+     */
+    std::shared_ptr<const rapidjson::Document> get(
+        size_t documentHash,
+        const std::string& rawDocument,
+        std::chrono::nanoseconds* creationTime = nullptr);
+
+    /**
+     * Store a parsed document, replacing the previous one with the same hash and evicting the least recently used
+     * document if the cache is full.
+     *
+     * @param documentHash The hash of the raw document
+     * @param rawDocument The raw document, which is not kept
+     * @param document The parsed document, not cached if @c nullptr
+     * @param creationTime The time it took to parse the document and create its content, which a cache hit saves
+     */
+    void put(
+        size_t documentHash,
+        const std::string& rawDocument,
+        std::shared_ptr<const rapidjson::Document> document,
+        std::chrono::nanoseconds creationTime = std::chrono::nanoseconds::zero());
+
+    /**
+     * Remove all cached entries.
+     */
+    void clear();
+
+    /**
+     * @return The number of cached documents
+     */
+    size_t size();
+
+    /**
+     * Parses a document for the cache.
+     *
+     * @param json The JSON text
+     * @return The parsed JSON, or @c nullptr if it is not valid
+     */
+    static std::shared_ptr<const rapidjson::Document> parse(const std::string& json);
+
+    /**
+     * Copies parsed JSON, as an @c apl::Content takes ownership of the JSON it is created from. Copying is much
+     * cheaper than parsing the JSON again.
+     *
+     * @param json The parsed JSON
+     * @return The copy
+     */
+    static rapidjson::Document copy(const rapidjson::Value& json);
+
+private:
+    /// A parsed document.
+    struct Entry {
+        /// The size of the raw document, to tell documents with the same hash apart.
+        size_t size;
+        /// A second hash of the raw document, to tell documents with the same hash apart without keeping a copy.
+        uint64_t checksum;
+        /// The parsed document.
+        std::shared_ptr<const rapidjson::Document> document;
+        /// The time it took to parse the document and create its content.
+        std::chrono::nanoseconds creationTime;
+    };
+
+    /**
+     * @param rawDocument The raw document
+     * @return The FNV-1a hash of the raw document, independent from @c std::hash
+     */
+    static uint64_t checksum(const std::string& rawDocument);
+
+    /// The parsed documents by hash of the raw document
+    AplCoreLruCache<size_t, Entry> m_entries;
+};
+
+using AplCoreContentCachePtr = std::shared_ptr<AplCoreContentCache>;
+
+}  // namespace APLClient
+
+#endif  // APL_CLIENT_LIBRARY_APL_CORE_CONTENT_CACHE_H_
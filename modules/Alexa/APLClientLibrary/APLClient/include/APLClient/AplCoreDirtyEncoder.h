@@ -0,0 +1,132 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_CORE_DIRTY_ENCODER_H_
+#define APL_CLIENT_LIBRARY_APL_CORE_DIRTY_ENCODER_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreorder"
+#pragma push_macro("DEBUG")
+#pragma push_macro("TRUE")
+#pragma push_macro("FALSE")
+#undef DEBUG
+#undef TRUE
+#undef FALSE
+#include <apl/apl.h>
+#pragma pop_macro("DEBUG")
+#pragma pop_macro("TRUE")
+#pragma pop_macro("FALSE")
+#pragma GCC diagnostic pop
+
+namespace APLClient {
+
+/**
+ * Encodes the dirty component updates of a frame as deltas against the values previously sent to the view host.
+ *
+ * Properties are identified by their numeric @c apl::PropertyKey and only sent when their value differs from the
+ * last one sent for the component. The name of each property is sent once, the first time it is used, so the view
+ * host can map updates back to the "dirty" message format. Updates which the view host needs in full, such as newly
+ * inserted children, are passed through in the "dirty" message format.
+ *
+ * A frame is encoded as the JSON payload of a "dirtyDelta" message:
+ *
+ *     { "names": { "<key>": "<name>", ... },
+ *       "dirty": [ [ "<uid>", <key>, <value>, <key>, <value>, ... ] | { <dirty message update> }, ... ] }
+ *
+ * This class is not thread safe.
+ */
+class AplCoreDirtyEncoder {
+public:
+    /**
+     * Forget all values and property names sent so far, called when a new component hierarchy is sent.
+     */
+    void reset();
+
+    /**
+     * Adds an update in the "dirty" message format, replacing any update already added for the component in this
+     * frame. The update must stay valid until the frame is encoded.
+     *
+     * @param uid The unique id of the component
+     * @param update The update
+     */
+    void addSerialized(const std::string& uid, rapidjson::Value&& update);
+
+    /**
+     * Adds a dirty property, unless the view host already has its value or a full update was added for the component.
+     *
+     * @param uid The unique id of the component
+     * @param key The property key
+     * @param value The property value
+     */
+    void addProperty(const std::string& uid, int key, const apl::Object& value);
+
+    /**
+     * @param uid The unique id of a component
+     * @return @c true if an update was added for the component in this frame
+     */
+    bool contains(const std::string& uid) const;
+
+    /**
+     * Forgets the values sent for a component which was removed from the hierarchy.
+     *
+     * @param uid The unique id of the component
+     */
+    void remove(const std::string& uid);
+
+    /**
+     * @return @c true if no update was added in this frame
+     */
+    bool empty() const;
+
+    /**
+     * Encodes the frame as the payload of a "dirtyDelta" message and starts a new frame.
+     *
+     * @param allocator The allocator of the message
+     * @return The payload
+     */
+    rapidjson::Value encodeJson(rapidjson::Document::AllocatorType& allocator);
+
+private:
+    /// The update of a single component in a frame
+    struct Update {
+        /// The full update in the "dirty" message format, or null
+        rapidjson::Value serialized;
+        /// The changed properties, if @c serialized is null
+        std::vector<std::pair<int, apl::Object>> properties;
+    };
+
+    /// The updates of the current frame, ordered by component unique id
+    std::map<std::string, Update> m_frame;
+
+    /// The keys of the properties whose names were first used in the current frame
+    std::vector<int> m_newNames;
+
+    /// The keys of the properties whose names were sent
+    std::unordered_set<int> m_sentNames;
+
+    /// The values last sent for each property of each component
+    std::unordered_map<std::string, std::unordered_map<int, apl::Object>> m_sentValues;
+};
+
+}  // namespace APLClient
+
+#endif  // APL_CLIENT_LIBRARY_APL_CORE_DIRTY_ENCODER_H_
@@ -83,6 +83,23 @@ public:
     void interruptCommandSequence();
 
 private:
+    /**
+     * Downloads the packages imported by @c content, including transitive imports, and adds each one to the content
+     * as soon as it arrives. At most @c AplOptionsInterface::getMaxNumberOfConcurrentDownloads packages are
+     * downloaded at a time.
+     *
+     * @param content The content waiting for its imports
+     * @param token The token for APL payload, used to report a failure
+     * @param cImports The counter of requested imports
+     * @param[out] source The source of the document, to which the JSON text of every imported package is added
+     * @return @c false if an import could not be retrieved, in which case the failure has been reported
+     */
+    bool resolveImports(
+        const apl::ContentPtr& content,
+        const std::string& token,
+        Telemetry::AplCounterHandle& cImports,
+        AplDocumentSource& source);
+
     AplConfigurationPtr m_aplConfiguration;
 
     /**
@@ -18,29 +18,62 @@
 
 #include "AplConfiguration.h"
 #include "AplCoreConnectionManager.h"
+#include "AplCoreLocaleMethodsCache.h"
 #include "Telemetry/AplMetricsRecorderInterface.h"
 
 namespace APLClient {
 
+    /**
+     * Maps strings to upper and lower case with @c AplCoreCaseMapping, asking the viewhost only for the locales and
+     * characters it does not cover. Results are memoized in an optional @c AplCoreLocaleMethodsCache.
+     */
     class AplCoreLocaleMethods : public apl::LocaleMethods {
     public:
         /**
          * Constructor
          *
          * @param aplCoreConnectionManager Pointer to the APL Core connection manager
+         * @param config Pointer to the APL configuration
+         * @param cache Optional cache used to memoize results, may be shared between instances
          */
         AplCoreLocaleMethods(
                 AplCoreConnectionManagerPtr aplCoreConnectionManager,
-                AplConfigurationPtr config);
+                AplConfigurationPtr config,
+                AplCoreLocaleMethodsCachePtr cache = nullptr);
 
         std::string toLowerCase(const std::string &value, const std::string &locale) override;
         std::string toUpperCase(const std::string &value, const std::string &locale) override;
 
     private:
-        std::string toCase(const std::string &value, const std::string &locale, const std::string key);
+        std::string toCase(const std::string &value, const std::string &locale, const std::string &methodName);
+
+        /**
+         * Increments a counter through the connection manager, which defers it while a document is inflated
+         * speculatively.
+         *
+         * @param counter The counter to increment
+         */
+        void incrementCounter(Telemetry::AplCounterHandle* counter);
+
+        /**
+         * Asks the viewhost to apply a locale method.
+         *
+         * @param[out] result The result, only valid if @c true is returned
+         * @return @c false if the viewhost did not reply with a valid result
+         */
+        bool toCaseInViewhost(
+                const std::string &value,
+                const std::string &locale,
+                const std::string &methodName,
+                std::string &result);
+
         std::weak_ptr<AplCoreConnectionManager> m_aplCoreConnectionManager;
 
         AplConfigurationPtr m_aplConfiguration;
+        AplCoreLocaleMethodsCachePtr m_cache;
+        std::unique_ptr<Telemetry::AplCounterHandle> m_cacheHitCounter;
+        std::unique_ptr<Telemetry::AplCounterHandle> m_nativeCounter;
+        std::unique_ptr<Telemetry::AplCounterHandle> m_viewhostCounter;
     };
 
 }  // namespace APLClient
@@ -0,0 +1,91 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_CORE_LOCALE_METHODS_CACHE_H_
+#define APL_CLIENT_LIBRARY_APL_CORE_LOCALE_METHODS_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "AplCoreLruCache.h"
+
+namespace APLClient {
+
+/**
+ * A bounded least-recently-used cache of locale method results, keyed by the method, the locale and the value. A
+ * single instance is owned by each connection manager so that results survive re-inflation and subsequent documents.
+ */
+class AplCoreLocaleMethodsCache {
+public:
+    /// The default maximum number of cached results
+    static const size_t DEFAULT_MAX_ENTRIES;
+
+    /// The longest value whose result is cached, in bytes
+    static const size_t MAX_VALUE_SIZE;
+
+    /**
+     * Constructor
+     *
+     * @param maxEntries The maximum number of results to keep, least recently used entries are evicted first
+     */
+    explicit AplCoreLocaleMethodsCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    /**
+     * Look up a result, marking it as most recently used.
+     *
+     * @param method The locale method
+     * @param locale The locale
+     * @param value The value the method is applied to
+     * @param[out] result The cached result, only valid if @c true is returned
+     * @return @c true if the result was found
+     */
+    bool get(const std::string& method, const std::string& locale, const std::string& value, std::string& result);
+
+    /**
+     * Store a result, evicting the least recently used entry if the cache is full. Results of values longer than
+     * @c MAX_VALUE_SIZE are not stored.
+     *
+     * @param method The locale method
+     * @param locale The locale
+     * @param value The value the method was applied to
+     * @param result The result
+     */
+    void put(const std::string& method, const std::string& locale, const std::string& value, const std::string& result);
+
+    /**
+     * Remove all cached results.
+     */
+    void clear();
+
+    /**
+     * @return The number of cached results
+     */
+    size_t size();
+
+private:
+    /**
+     * @return The key of a result
+     */
+    static std::string buildKey(const std::string& method, const std::string& locale, const std::string& value);
+
+    /// The cached results by key
+    AplCoreLruCache<std::string, std::string> m_results;
+};
+
+using AplCoreLocaleMethodsCachePtr = std::shared_ptr<AplCoreLocaleMethodsCache>;
+
+}  // namespace APLClient
+
+#endif  // APL_CLIENT_LIBRARY_APL_CORE_LOCALE_METHODS_CACHE_H_
@@ -0,0 +1,158 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_CORE_LRU_CACHE_H_
+#define APL_CLIENT_LIBRARY_APL_CORE_LRU_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace APLClient {
+
+/**
+ * A bounded, thread safe least-recently-used cache.
+ *
+ * @tparam Key The type of the keys, which must be hashable
+ * @tparam Value The type of the cached values
+ */
+template <typename Key, typename Value>
+class AplCoreLruCache {
+public:
+    /**
+     * Constructor
+     *
+     * @param maxEntries The maximum number of entries to keep, least recently used entries are evicted first. @c 0
+     * disables the cache.
+     */
+    explicit AplCoreLruCache(size_t maxEntries) : m_maxEntries{maxEntries} {
+    }
+
+    /**
+     * Look up a value, marking it as most recently used.
+     *
+     * @param key The key
+     * @param[out] value The cached value, only valid if @c true is returned
+     * @return @c true if the key was found
+     */
+    bool get(const Key& key, Value& value);
+
+    /**
+     * Store a value, replacing the previous value of the key and evicting the least recently used entry if the cache
+     * is full.
+     *
+     * @param key The key
+     * @param value The value
+     */
+    void put(const Key& key, Value value);
+
+    /**
+     * Remove the entry of a key, if any.
+     *
+     * @param key The key
+     */
+    void remove(const Key& key);
+
+    /**
+     * Remove all cached entries.
+     */
+    void clear();
+
+    /**
+     * @return The number of cached entries
+     */
+    size_t size();
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    /// The maximum number of entries
+    const size_t m_maxEntries;
+
+    /// Entries ordered from most to least recently used
+    std::list<Entry> m_entries;
+
+    /// Index into @c m_entries by key
+    std::unordered_map<Key, typename std::list<Entry>::iterator> m_index;
+
+    /// Mutex protecting the cache
+    std::mutex m_mutex;
+};
+
+template <typename Key, typename Value>
+bool AplCoreLruCache<Key, Value>::get(const Key& key, Value& value) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return false;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    value = it->second->second;
+    return true;
+}
+
+template <typename Key, typename Value>
+void AplCoreLruCache<Key, Value>::put(const Key& key, Value value) {
+    if (m_maxEntries == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        it->second->second = std::move(value);
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+
+    if (m_entries.size() >= m_maxEntries) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+
+    m_entries.emplace_front(key, std::move(value));
+    m_index.emplace(key, m_entries.begin());
+}
+
+template <typename Key, typename Value>
+void AplCoreLruCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    m_entries.erase(it->second);
+    m_index.erase(it);
+}
+
+template <typename Key, typename Value>
+void AplCoreLruCache<Key, Value>::clear() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_index.clear();
+    m_entries.clear();
+}
+
+template <typename Key, typename Value>
+size_t AplCoreLruCache<Key, Value>::size() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_entries.size();
+}
+
+}  // namespace APLClient
+
+#endif  // APL_CLIENT_LIBRARY_APL_CORE_LRU_CACHE_H_
@@ -32,12 +32,15 @@
 
 #include "AplConfiguration.h"
 #include "AplCoreConnectionManager.h"
+#include "AplCoreTextMeasurementCache.h"
 #include "Telemetry/AplMetricsRecorderInterface.h"
 
 namespace APLClient {
 
 /**
- * Provides the ability to retrieve text measurements from a remote viewhost
+ * Provides the ability to retrieve text measurements from a remote viewhost, or from an in-process
+ * @c AplTextMeasurementBackendInterface when one is configured through @c AplConfiguration. Measurements of
+ * Text components are memoized in an optional @c AplCoreTextMeasurementCache.
  */
 class AplCoreTextMeasurement : public apl::TextMeasurement {
 public:
@@ -45,10 +48,15 @@ public:
      * Constructor
      *
      * @param aplCoreConnectionManager Pointer to the APL Core connection manager
+     * @param config Pointer to the APL configuration
+     * @param cache Optional cache used to memoize measurements, may be shared between instances
+     * @param batchMeasurementEnabled Whether the viewhost supports the @c measureBatch message, requires a cache
      */
     AplCoreTextMeasurement(
         AplCoreConnectionManagerPtr aplCoreConnectionManager,
-        AplConfigurationPtr config);
+        AplConfigurationPtr config,
+        AplCoreTextMeasurementCachePtr cache = nullptr,
+        bool batchMeasurementEnabled = false);
 
     /// @name apl::TextMeasurement Functions
     /// @{
@@ -66,8 +74,76 @@ private:
     std::weak_ptr<AplCoreConnectionManager> m_aplCoreConnectionManager;
 
     AplConfigurationPtr m_aplConfiguration;
+    AplCoreTextMeasurementCachePtr m_cache;
+    bool m_batchMeasurementEnabled;
     std::unique_ptr<Telemetry::AplCounterHandle> m_textMeasureCounter;
-    apl::LayoutSize GetValidMeasureResult(rapidjson::Document& result, AplCoreMetrics* aplCoreMetrics );
+    std::unique_ptr<Telemetry::AplCounterHandle> m_cacheHitCounter;
+    std::unique_ptr<Telemetry::AplCounterHandle> m_cacheMissCounter;
+    apl::LayoutSize GetValidMeasureResult(
+        rapidjson::Document& result,
+        AplCoreMetrics* aplCoreMetrics,
+        bool& isValid);
+
+    /**
+     * Parses a single measurement result of the form { "width": FLOAT, "height": FLOAT }.
+     *
+     * @param payload The measurement result
+     * @param aplCoreMetrics The current scaling metrics
+     * @param[out] size The measured size in core units, only valid if @c true is returned
+     * @return @c true if the result is valid
+     */
+    static bool parseMeasurePayload(
+        const rapidjson::Value& payload,
+        AplCoreMetrics* aplCoreMetrics,
+        apl::LayoutSize& size);
+
+    /**
+     * Builds the viewhost payload for a single measurement request.
+     */
+    static rapidjson::Value buildMeasurePayload(
+        apl::Component* component,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        AplCoreMetrics* aplCoreMetrics,
+        rapidjson::Document::AllocatorType& alloc);
+
+    /**
+     * Measures the component together with its uncached Text siblings in a single round-trip to the viewhost.
+     *
+     * @param[out] size The measured size, or a generic size if the viewhost did not reply with a valid result
+     * @return @c true if a batch was sent, @c false if there was nothing to batch
+     */
+    bool measureBatch(
+        const AplCoreConnectionManagerPtr& aplCoreConnectionManager,
+        apl::Component* component,
+        const std::string& cacheKey,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        apl::LayoutSize& size);
+
+    /**
+     * Builds the cache key for a measurement. Only Text components are cached, since their size depends solely on
+     * the text, its style and the layout constraints.
+     *
+     * @param component The component to measure
+     * @param width The available width
+     * @param widthMode The measure mode for the width
+     * @param height The available height
+     * @param heightMode The measure mode for the height
+     * @param aplCoreMetrics The current scaling metrics
+     * @return The key, or an empty string if the measurement should not be cached
+     */
+    static std::string buildCacheKey(
+        apl::Component* component,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        const AplCoreMetrics* aplCoreMetrics);
 
 };
 
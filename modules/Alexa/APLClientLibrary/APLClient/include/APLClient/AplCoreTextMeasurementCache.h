@@ -0,0 +1,62 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_CORE_TEXT_MEASUREMENT_CACHE_H_
+#define APL_CLIENT_LIBRARY_APL_CORE_TEXT_MEASUREMENT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreorder"
+#pragma push_macro("DEBUG")
+#pragma push_macro("TRUE")
+#pragma push_macro("FALSE")
+#undef DEBUG
+#undef TRUE
+#undef FALSE
+#include <apl/apl.h>
+#pragma pop_macro("DEBUG")
+#pragma pop_macro("TRUE")
+#pragma pop_macro("FALSE")
+#pragma GCC diagnostic pop
+
+#include "AplCoreLruCache.h"
+
+namespace APLClient {
+
+/**
+ * A bounded least-recently-used cache of text measurement results, keyed by a normalized description of the
+ * measured text, its style and the layout constraints. A single instance is owned by each renderer so that results
+ * survive re-inflation and subsequent documents.
+ */
+class AplCoreTextMeasurementCache : public AplCoreLruCache<std::string, apl::LayoutSize> {
+public:
+    /// The default maximum number of cached measurements
+    static const size_t DEFAULT_MAX_ENTRIES;
+
+    /**
+     * Constructor
+     *
+     * @param maxEntries The maximum number of measurements to keep, least recently used entries are evicted first
+     */
+    explicit AplCoreTextMeasurementCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+};
+
+using AplCoreTextMeasurementCachePtr = std::shared_ptr<AplCoreTextMeasurementCache>;
+
+}  // namespace APLClient
+
+#endif  // APL_CLIENT_LIBRARY_APL_CORE_TEXT_MEASUREMENT_CACHE_H_
@@ -32,6 +32,27 @@ const char MSG_SEQNO_TAG[] = "seqno";
 /// The payload json key in the message.
 const char MSG_PAYLOAD_TAG[] = "payload";
 
+/**
+ * A rapidjson output stream appending to a @c std::string, so that its capacity can be reused between messages.
+ */
+class AplCoreStringOutputStream {
+public:
+    typedef char Ch;
+
+    explicit AplCoreStringOutputStream(std::string& output) : mOutput(output) {
+    }
+
+    void Put(Ch c) {
+        mOutput.push_back(c);
+    }
+
+    void Flush() {
+    }
+
+private:
+    std::string& mOutput;
+};
+
 /**
  * The @c AplCoreViewhostMessage base class for messages sent to AplViewHost.
  *
@@ -51,6 +72,17 @@ public:
         mDocument.AddMember(MSG_TYPE_TAG, rapidjson::Value(type.c_str(), alloc).Move(), alloc);
     }
 
+    /**
+     * Constructor
+     * @param type The type from this message
+     * @param allocator The allocator backing this message, which must outlive it
+     */
+    AplCoreViewhostMessage(const std::string& type, rapidjson::Document::AllocatorType* allocator) :
+            mDocument(rapidjson::kObjectType, allocator) {
+        auto& alloc = mDocument.GetAllocator();
+        mDocument.AddMember(MSG_TYPE_TAG, rapidjson::Value(type.c_str(), alloc).Move(), alloc);
+    }
+
     /**
      * Sets the sequence number for this message
      * @param sequenceNumber
@@ -102,6 +134,23 @@ public:
         return std::string(buffer.GetString(), buffer.GetSize());
     }
 
+    /**
+     * Retrieves the json string representing this message into @c output, reusing its capacity
+     * @param[out] output The json string representation of message
+     */
+    void get(std::string& output) {
+        output.clear();
+        AplCoreStringOutputStream stream(output);
+        rapidjson::Writer<
+            AplCoreStringOutputStream,
+            rapidjson::UTF8<>,
+            rapidjson::UTF8<>,
+            rapidjson::CrtAllocator,
+            rapidjson::kWriteNanAndInfFlag>
+            writer(stream);
+        mDocument.Accept(writer);
+    }
+
     /**
      * Retrieves the rapidjson allocator
      * @return The allocator
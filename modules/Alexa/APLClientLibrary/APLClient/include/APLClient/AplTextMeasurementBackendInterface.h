@@ -0,0 +1,87 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef APL_CLIENT_LIBRARY_APL_TEXT_MEASUREMENT_BACKEND_INTERFACE_H_
+#define APL_CLIENT_LIBRARY_APL_TEXT_MEASUREMENT_BACKEND_INTERFACE_H_
+
+#include <memory>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreorder"
+#pragma push_macro("DEBUG")
+#pragma push_macro("TRUE")
+#pragma push_macro("FALSE")
+#undef DEBUG
+#undef TRUE
+#undef FALSE
+#include <apl/apl.h>
+#pragma pop_macro("DEBUG")
+#pragma pop_macro("TRUE")
+#pragma pop_macro("FALSE")
+#pragma GCC diagnostic pop
+
+namespace APLClient {
+
+/**
+ * The @c AplTextMeasurementBackendInterface allows clients of the APL client library to provide an in-process text
+ * measurement implementation (e.g. a font shaper with locally loaded fonts). When a backend is configured it is
+ * consulted before the viewhost, avoiding a blocking round-trip for every measured component. A backend may decline
+ * any request, in which case the measurement falls back to the viewhost.
+ *
+ * All dimensions passed to and returned from the backend are in APL Core (dp) units.
+ */
+class AplTextMeasurementBackendInterface {
+public:
+    /**
+     * Virtual destructor
+     */
+    virtual ~AplTextMeasurementBackendInterface() = default;
+
+    /**
+     * Measure the text content of the given component.
+     *
+     * @param component The component to measure
+     * @param width The available width
+     * @param widthMode The measure mode for the width
+     * @param height The available height
+     * @param heightMode The measure mode for the height
+     * @param[out] size The measured size, only valid if @c true is returned
+     * @return @c true if the backend measured the component, @c false to fall back to the viewhost
+     */
+    virtual bool measure(
+        apl::Component* component,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        apl::LayoutSize& size) = 0;
+
+    /**
+     * Calculate the baseline of the text content of the given component.
+     *
+     * @param component The component to calculate the baseline for
+     * @param width The laid out width of the component
+     * @param height The laid out height of the component
+     * @param[out] baseline The calculated baseline, only valid if @c true is returned
+     * @return @c true if the backend calculated the baseline, @c false to fall back to the viewhost
+     */
+    virtual bool baseline(apl::Component* component, float width, float height, float& baseline) = 0;
+};
+
+/// Convenience typedef
+using AplTextMeasurementBackendInterfacePtr = std::shared_ptr<AplTextMeasurementBackendInterface>;
+
+}  // namespace APLClient
+#endif  // APL_CLIENT_LIBRARY_APL_TEXT_MEASUREMENT_BACKEND_INTERFACE_H_
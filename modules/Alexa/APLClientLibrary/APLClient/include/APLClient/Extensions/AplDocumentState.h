@@ -16,8 +16,11 @@
 #ifndef ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_APL_APLDOCUMENTSTATE_H_
 #define ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_APL_APLDOCUMENTSTATE_H_
 
+#include <map>
 #include <memory>
 #include <chrono>
+#include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wreorder"
@@ -36,11 +39,63 @@
 namespace APLClient {
 namespace Extensions {
 
+/**
+ * The JSON text an APL document was rendered from, which is much smaller than the @c apl::Content created from it.
+ */
+struct AplDocumentSource {
+    /**
+     * Binds the parameters of a content to data sources, the whole data sources being bound to the "payload"
+     * parameter and the other parameters to the data source of the same name.
+     *
+     * @param content The content.
+     * @param data The JSON text of the data sources.
+     */
+    static void bindData(const apl::ContentPtr& content, const std::string& data);
+
+    /**
+     * @param request The request of an imported package.
+     * @return The key of the package in @c packages.
+     */
+    static std::string packageKey(const apl::ImportRequest& request);
+
+    /**
+     * Creates the content of the document again.
+     *
+     * @return The content, or @c nullptr if it could not be created or misses an imported package.
+     */
+    apl::ContentPtr createContent() const;
+
+    /// The JSON text of the document.
+    std::string document;
+    /// The JSON text of the data sources.
+    std::string data;
+    /// The JSON text of the packages imported by the document, directly or not, by @c packageKey.
+    std::map<std::string, std::string> packages;
+};
+
+using AplDocumentSourcePtr = std::shared_ptr<const AplDocumentSource>;
+
 /**
  * The @c AplDocumentState is an object designed to cache the state of an active APL document such that it can
  * be re-inflated and restored.  i.e. as when used in Backstack navigation.
+ *
+ * A document state is either live, keeping the whole @c RootContext, or hibernated, keeping only what is needed to
+ * inflate the document again: the JSON text of the document and of its data sources, its root config and the scroll
+ * position and page of its identified components.
  */
 struct AplDocumentState {
+    /**
+     * The state of an identified component which is restored after the document is inflated again.
+     */
+    struct ComponentState {
+        /// The id of the component, as assigned by the document.
+        std::string id;
+        /// The update which restores the state.
+        apl::UpdateType type;
+        /// The value of the update.
+        float value;
+    };
+
     /**
      * Default Constructor.
      */
@@ -51,14 +106,40 @@ struct AplDocumentState {
      * @param token The presentation token for the document.
      * @param rootContext The @c RootContext pointer for the document.
      * @param metrics The derived @c AplCoreMetrics for the document.
+     * @param source The JSON text the document was rendered from, @c nullptr if it can't be hibernated.
      */
     AplDocumentState(
         std::string token,
         apl::RootContextPtr rootContext,
-        std::shared_ptr<apl::MetricsTransform> metrics) :
+        std::shared_ptr<apl::MetricsTransform> metrics,
+        AplDocumentSourcePtr source = nullptr) :
             token{std::move(token)},
             rootContext{std::move(rootContext)},
-            metrics{std::move(metrics)} {};
+            metrics{std::move(metrics)},
+            source{std::move(source)} {
+        if (this->rootContext) {
+            rootConfig = this->rootContext->getRootConfig();
+        }
+    };
+
+    /**
+     * Releases the @c RootContext of a live document state, keeping what is needed to inflate it again. Document
+     * states without a source are kept live.
+     */
+    void hibernate();
+
+    /**
+     * @return Whether the document state was hibernated and needs to be inflated again to be restored.
+     */
+    bool isHibernated() const {
+        return !rootContext && source;
+    }
+
+    /**
+     * Restores the captured component states onto the @c RootContext the hibernated document was inflated into.
+     * @param root The @c RootContext inflated from this document state.
+     */
+    void restoreComponentStates(const apl::RootContextPtr& root) const;
 
     /// The id for the document state, as defined by the client or assigned in back navigation.
     std::string id;
@@ -70,6 +151,21 @@ struct AplDocumentState {
     std::shared_ptr<apl::MetricsTransform> metrics;
     /// The configuration change that needs to be applied to the restoring documentState.
     apl::ConfigurationChange configurationChange;
+    /// The JSON text the document was rendered from, kept to inflate a hibernated document again.
+    AplDocumentSourcePtr source;
+    /// The root config of the document, kept to inflate a hibernated document again.
+    apl::RootConfig rootConfig;
+    /// The states of the identified components, captured when the document state is hibernated.
+    std::vector<ComponentState> componentStates;
+    /// The estimated size in bytes of the live document state, zero once hibernated.
+    size_t estimatedSize = 0;
+
+private:
+    /**
+     * Captures the state of a component and of its descendants.
+     * @param component The component.
+     */
+    void captureComponentStates(const apl::ComponentPtr& component);
 };
 
 using AplDocumentStatePtr = std::shared_ptr<AplDocumentState>;
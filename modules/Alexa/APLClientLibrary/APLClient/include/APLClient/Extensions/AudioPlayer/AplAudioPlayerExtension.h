@@ -16,6 +16,7 @@
 #ifndef ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_APL_EXTENSIONS_AUDIOPLAYER_APLAUDIOPLAYEREXTENSION_H
 #define ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_APL_EXTENSIONS_AUDIOPLAYER_APLAUDIOPLAYEREXTENSION_H
 
+#include <chrono>
 #include <iostream>
 
 #include "APLClient/Extensions/AplCoreExtensionInterface.h"
@@ -86,9 +87,28 @@ public:
      *
      * @param offset The current offsetInMilliseconds for the active audioItem received from
      * https://developer.amazon.com/en-US/docs/alexa/alexa-voice-service/audioplayer.html#play
+     * The published offset never drops below the one published last, until the player activity changes.
      */
     void updatePlaybackProgress(int offset);
 
+    /**
+     * Sets the granularity of the offset published to the playbackState apl::LiveMap while audio is playing. Offsets
+     * passed to @c updatePlaybackProgress are rounded down to a multiple of the granularity, so that documents are only
+     * updated when the bound value changes. A granularity of zero publishes every offset.
+     *
+     * @param granularity The granularity of the published offset.
+     */
+    void setPlaybackProgressGranularity(std::chrono::milliseconds granularity);
+
+    /**
+     * Extrapolates the offset of the playing audioItem from the last reported one, and returns how long it is until
+     * the published offset is due to change, which is when @c updatePlaybackProgress should next be called. The
+     * extrapolated offset is only used for scheduling, the published offset is always a reported one.
+     *
+     * @return The delay until the next progress update, @c std::chrono::milliseconds::max() if audio is not playing.
+     */
+    std::chrono::milliseconds getNextPlaybackProgressDelay() const;
+
     /**
      * Used to inform the extension of the active @c AudioPlayer.Presentation.APL presentationSession.
      * @param id The identifier of the active presentation session.
@@ -205,9 +225,31 @@ private:
     /// The @c apl::LiveMap for AudioPlayer playbackState data.
     apl::LiveMapPtr m_playbackState;
 
+    /**
+     * Publishes an offset to the playbackState apl::LiveMap if it differs from the published one.
+     *
+     * @param offset The offset to publish.
+     */
+    void publishOffset(int offset);
+
     /// The id of the active skill in session.
     std::string m_activeSkillId;
 
+    /// The granularity of the offset published while audio is playing.
+    std::chrono::milliseconds m_progressGranularity;
+
+    /// Whether the audioItem is playing, and so its offset advances.
+    bool m_playing;
+
+    /// The last offset reported for the audioItem, which the current offset is extrapolated from.
+    int m_reportedOffset;
+
+    /// The time the last offset was reported.
+    std::chrono::steady_clock::time_point m_reportedTime;
+
+    /// The offset published to the playbackState apl::LiveMap.
+    int m_publishedOffset;
+
     /// The map of @c LyricsViewedData objects per skill Id.
     std::unordered_map<std::string, std::shared_ptr<LyricsViewedData>> m_lyricsViewedData;
 };
@@ -16,6 +16,8 @@
 #ifndef ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_APL_EXTENSIONS_BACKSTACK_APLBACKSTACKEXTENSION_H
 #define ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_APL_EXTENSIONS_BACKSTACK_APLBACKSTACKEXTENSION_H
 
+#include <algorithm>
+
 #include "APLClient/Extensions/AplCoreExtensionInterface.h"
 #include "AplBackstackExtensionObserver.h"
 
@@ -96,6 +98,36 @@ public:
      */
     void addDocumentStateToBackstack(const AplDocumentStatePtr& documentState);
 
+    /**
+     * Bounds the document states kept live in the @c AplBackstack. Once over either limit, the least recently
+     * added live document states are hibernated, releasing their @c RootContext until they are restored.
+     *
+     * @param maxLiveDocuments The maximum number of live document states, 0 for no limit.
+     * @param maxLiveBytes The maximum estimated size in bytes of the live document states, 0 for no limit.
+     */
+    void setCacheLimits(size_t maxLiveDocuments, size_t maxLiveBytes);
+
+    /**
+     * @return Whether the size of the document states added to the @c AplBackstack must be estimated, which is only
+     * the case when the live document states are bounded in bytes.
+     */
+    bool needsDocumentStateSize() const;
+
+    /**
+     * @return The number of document states in the @c AplBackstack.
+     */
+    unsigned int getDocumentCount() const;
+
+    /**
+     * @return The number of hibernated document states in the @c AplBackstack.
+     */
+    unsigned int getHibernatedDocumentCount() const;
+
+    /**
+     * @return The estimated size in bytes of the live document states in the @c AplBackstack.
+     */
+    size_t getLiveDocumentBytes() const;
+
     /**
      * Clear the @c AplBackstack, and clear the active document id.
      */
@@ -148,6 +180,12 @@ private:
         /// The @c apl::LiveArray data for the backstack id's.
         apl::LiveArrayPtr m_backstackIds = apl::LiveArray::create();
 
+        /// The maximum number of live document states, 0 for no limit.
+        size_t m_maxLiveDocuments = 0;
+
+        /// The maximum estimated size in bytes of the live document states, 0 for no limit.
+        size_t m_maxLiveBytes = 0;
+
         /**
          * Adds a document to the Backstack.
          * @param documentState the @c AplDocumentState to add.
@@ -155,6 +193,52 @@ private:
         void addDocumentState(const AplDocumentStatePtr& documentState) {
             m_documentStateCache.emplace_back(documentState);
             m_backstackIds->push_back(documentState->id);
+            enforceLimits();
+        }
+
+        /**
+         * Hibernates the least recently added live document states until the live ones are within the limits.
+         */
+        void enforceLimits() {
+            size_t liveDocuments = 0;
+            size_t liveBytes = 0;
+            // Walk from the top of the stack, so that the most recent document states stay live
+            for (auto it = m_documentStateCache.rbegin(); it != m_documentStateCache.rend(); it++) {
+                auto& documentState = *it;
+                if (!documentState->rootContext) {
+                    continue;
+                }
+                if ((m_maxLiveDocuments && liveDocuments + 1 > m_maxLiveDocuments) ||
+                    (m_maxLiveBytes && liveBytes + documentState->estimatedSize > m_maxLiveBytes)) {
+                    documentState->hibernate();
+                    continue;
+                }
+                liveDocuments++;
+                liveBytes += documentState->estimatedSize;
+            }
+        }
+
+        /**
+         * @return the number of hibernated document states in the Backstack.
+         */
+        unsigned int hibernatedLength() const {
+            return std::count_if(
+                m_documentStateCache.begin(), m_documentStateCache.end(), [](const AplDocumentStatePtr& state) {
+                    return state->isHibernated();
+                });
+        }
+
+        /**
+         * @return the estimated size in bytes of the live document states in the Backstack.
+         */
+        size_t liveBytes() const {
+            size_t bytes = 0;
+            for (const auto& documentState : m_documentStateCache) {
+                if (documentState->rootContext) {
+                    bytes += documentState->estimatedSize;
+                }
+            }
+            return bytes;
         }
 
         /**
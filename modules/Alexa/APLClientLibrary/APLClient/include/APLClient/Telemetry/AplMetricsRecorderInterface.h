@@ -106,6 +106,15 @@ public:
      * @return @c true if successful, @c false otherwise (e.g. handle refers to an invalidated document)
      */
     virtual bool incrementBy(uint64_t value) = 0;
+
+    /**
+     * Sets the counter to the specified value, replacing any previous value. This lets the counter report a sample
+     * of a quantity, such as the current size of a cache, rather than a running total.
+     *
+     * @param value the value to report
+     * @return @c true if successful, @c false otherwise (e.g. handle refers to an invalidated document)
+     */
+    virtual bool set(uint64_t value) = 0;
 };
 
 enum class AplRenderingSegment {
@@ -113,10 +122,16 @@ enum class AplRenderingSegment {
     kRenderDocument,
     /** Corresponds to the creation of the APL @c Content object, including downloading imports */
     kContentCreation,
+    /** Corresponds to resolving a single import, from the time it is requested until its package arrives */
+    kImportResolution,
     /** Corresponds to inflating the APL @c RootContext object */
     kRootContextInflation,
     /** Corresponds to performing a text measuring requested by APL during layout */
-    kTextMeasure
+    kTextMeasure,
+    /** Corresponds to a text measuring served from the measurement cache */
+    kTextMeasureCacheHit,
+    /** Corresponds to a text measuring which could not be served from the measurement cache */
+    kTextMeasureCacheMiss
 };
 
 /**
@@ -53,6 +53,24 @@ public:
      */
     void onCacheHit();
 
+    /**
+     * Called when a resource was obtained from a download already in progress for another request, and downloading is
+     * not attempted.
+     */
+    void onDownloadCoalesced();
+
+    /**
+     * Called when a resource was not found in the cache, or its cached copy has expired, and the source is contacted.
+     */
+    void onCacheMiss();
+
+    /**
+     * Called when a cached resource is evicted to keep the cache within its budget.
+     *
+     * @param numberOfBytes The size of the evicted resource.
+     */
+    void onCacheEviction(std::uint64_t numberOfBytes);
+
     /**
      * Called during the download of a resource. Observers should expect multiple calls
      * to this method for a single download.
@@ -65,6 +83,10 @@ private:
     AplMetricsRecorderInterfacePtr m_metricsRecorder;
     std::unique_ptr<AplTimerHandle> m_downloadTimer;
     std::unique_ptr<AplCounterHandle> m_cacheCounter;
+    std::unique_ptr<AplCounterHandle> m_cacheMissCounter;
+    std::unique_ptr<AplCounterHandle> m_coalescedCounter;
+    std::unique_ptr<AplCounterHandle> m_evictionCounter;
+    std::unique_ptr<AplCounterHandle> m_evictedSizeCounter;
     std::unique_ptr<AplCounterHandle> m_sizeCounter;
 };
 
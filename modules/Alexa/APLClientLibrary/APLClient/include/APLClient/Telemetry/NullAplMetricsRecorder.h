@@ -26,6 +26,10 @@ public:
     bool incrementBy(uint64_t value) override {
         return false;
     }
+
+    bool set(uint64_t value) override {
+        return false;
+    }
 };
 
 class NullTimerHandle : public AplTimerHandle {
@@ -44,4 +44,8 @@ void AplClientBinding::onTelemetrySinkUpdated(APLClient::Telemetry::AplMetricsSi
     m_aplConfiguration->setMetricsRecorder(recorder);
 }
 
+void AplClientBinding::setTextMeasurementBackend(AplTextMeasurementBackendInterfacePtr backend) {
+    m_aplConfiguration->setTextMeasurementBackend(backend);
+}
+
 }  // namespace APLClient
\ No newline at end of file
@@ -91,10 +91,18 @@ bool AplClientRenderer::shouldHandleMessage(const std::string& message) {
     return m_aplConnectionManager->shouldHandleMessage(message);
 }
 
+bool AplClientRenderer::shouldHandleMessage(const rapidjson::Value& message) {
+    return m_aplConnectionManager->shouldHandleMessage(message);
+}
+
 void AplClientRenderer::handleMessage(const std::string& message) {
     m_aplConnectionManager->handleMessage(message);
 }
 
+void AplClientRenderer::handleMessage(const rapidjson::Value& message) {
+    m_aplConnectionManager->handleMessage(message);
+}
+
 void AplClientRenderer::renderDocument(
     const std::string& document,
     const std::string& data,
@@ -144,6 +152,10 @@ void AplClientRenderer::onUpdateTick() {
     m_aplConnectionManager->onUpdateTick();
 }
 
+std::chrono::milliseconds AplClientRenderer::getNextUpdateDelay() {
+    return m_aplConnectionManager->getNextUpdateDelay();
+}
+
 const std::string AplClientRenderer::getWindowId() {
     return m_windowId;
 }
@@ -166,8 +178,15 @@ void AplClientRenderer::onExtensionEvent(
     m_aplConnectionManager->onExtensionEvent(uri, name, source, params, event, resultCallback);
 }
 
-AplDocumentStatePtr AplClientRenderer::getActiveDocumentState() {
-    return m_aplConnectionManager->getActiveDocumentState();
+AplDocumentStatePtr AplClientRenderer::getActiveDocumentState(bool estimateSize) {
+    return m_aplConnectionManager->getActiveDocumentState(estimateSize);
+}
+
+void AplClientRenderer::reportBackstackSize(
+    const AplDocumentStatePtr& documentState,
+    size_t documentStates,
+    size_t liveBytes) {
+    m_aplConnectionManager->reportBackstackSize(documentState, documentStates, liveBytes);
 }
 
 void AplClientRenderer::restoreDocumentState(AplDocumentStatePtr documentState) {
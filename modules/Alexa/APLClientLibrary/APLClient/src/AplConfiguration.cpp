@@ -21,7 +21,8 @@ namespace APLClient {
 AplConfiguration::AplConfiguration(AplOptionsInterfacePtr options,
                                  Telemetry::AplMetricsRecorderInterfacePtr metricsRecorder)
         : m_aplOptions{options},
-          m_metricsRecorder{metricsRecorder} {
+          m_metricsRecorder{metricsRecorder},
+          m_contentCache{std::make_shared<AplCoreContentCache>()} {
     if (!m_metricsRecorder) {
         m_metricsRecorder = std::make_shared<Telemetry::NullAplMetricsRecorder>();
     }
@@ -41,4 +42,25 @@ void AplConfiguration::setMetricsRecorder(Telemetry::AplMetricsRecorderInterface
     }
 }
 
+AplTextMeasurementBackendInterfacePtr AplConfiguration::getTextMeasurementBackend() const {
+    // Read by speculative inflation workers while the backend may be replaced
+    return std::atomic_load(&m_textMeasurementBackend);
+}
+
+void AplConfiguration::setTextMeasurementBackend(AplTextMeasurementBackendInterfacePtr textMeasurementBackend) {
+    std::atomic_store(&m_textMeasurementBackend, textMeasurementBackend);
+}
+
+AplCoreContentCachePtr AplConfiguration::getContentCache() const {
+    return m_contentCache;
+}
+
+const AplConfiguration::AllocationCounter& AplConfiguration::getAllocationCounter() const {
+    return m_allocationCounter;
+}
+
+void AplConfiguration::setAllocationCounter(AllocationCounter allocationCounter) {
+    m_allocationCounter = std::move(allocationCounter);
+}
+
 }
@@ -0,0 +1,546 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "APLClient/AplCoreCaseMapping.h"
+
+namespace APLClient {
+
+/// The languages with special casing rules which are not implemented, such as Lithuanian keeping the dot of i.
+static const std::set<std::string> UNCOVERED_LANGUAGES = {"lt"};
+
+/// The languages mapping dotted and dotless i the Turkish way.
+static const std::set<std::string> TURKIC_LANGUAGES = {"tr", "az"};
+
+/// The language whose upper case has no accents.
+static const std::string GREEK_LANGUAGE = "el";
+
+/// Inclusive ranges of code points which are not cased and not changed by case mapping.
+static const uint32_t CASELESS_RANGES[][2] = {
+    {0x02B0, 0x02FF},    // Spacing modifier letters
+    {0x0590, 0x0FFF},    // Hebrew, Arabic and the scripts of South and Southeast Asia
+    {0x2000, 0x206F},    // General punctuation
+    {0x20A0, 0x20CF},    // Currency symbols
+    {0x2190, 0x23FF},    // Arrows, mathematical operators and technical symbols
+    {0x2500, 0x27BF},    // Box drawing, shapes and dingbats
+    {0x3000, 0x9FFF},    // CJK symbols, kana and ideographs
+    {0xAC00, 0xD7AF},    // Hangul syllables
+    {0xFE00, 0xFE0F},    // Variation selectors
+    {0x1F000, 0x1FAFF},  // Emoji and other symbols
+    {0x20000, 0x2FA1F},  // CJK ideographs extensions
+};
+
+/// The upper case mappings to more than one code point.
+static const std::map<uint32_t, std::vector<uint32_t>> FULL_UPPER_CASE = {
+    {0x00DF, {0x0053, 0x0053}},
+    {0x0149, {0x02BC, 0x004E}},
+    {0x0390, {0x0399, 0x0308, 0x0301}},
+    {0x03B0, {0x03A5, 0x0308, 0x0301}},
+    {0x1E96, {0x0048, 0x0331}},
+    {0x1E97, {0x0054, 0x0308}},
+    {0x1E98, {0x0057, 0x030A}},
+    {0x1E99, {0x0059, 0x030A}},
+    {0x1E9A, {0x0041, 0x02BE}},
+    {0xFB00, {0x0046, 0x0046}},
+    {0xFB01, {0x0046, 0x0049}},
+    {0xFB02, {0x0046, 0x004C}},
+    {0xFB03, {0x0046, 0x0046, 0x0049}},
+    {0xFB04, {0x0046, 0x0046, 0x004C}},
+    {0xFB05, {0x0053, 0x0054}},
+    {0xFB06, {0x0053, 0x0054}},
+};
+
+/// The Greek capitals with tonos and their unaccented form.
+static const std::map<uint32_t, uint32_t> GREEK_UNACCENTED_CAPITALS = {
+    {0x0386, 0x0391},
+    {0x0388, 0x0395},
+    {0x0389, 0x0397},
+    {0x038A, 0x0399},
+    {0x038C, 0x039F},
+    {0x038E, 0x03A5},
+    {0x038F, 0x03A9},
+};
+
+/// The combining accents removed from Greek upper case.
+static const std::set<uint32_t> GREEK_ACCENTS = {0x0300, 0x0301, 0x0313, 0x0314, 0x0342};
+
+static const uint32_t LATIN_CAPITAL_I = 0x0049;
+static const uint32_t LATIN_SMALL_I = 0x0069;
+static const uint32_t LATIN_CAPITAL_I_WITH_DOT = 0x0130;
+static const uint32_t LATIN_SMALL_DOTLESS_I = 0x0131;
+static const uint32_t COMBINING_DOT_ABOVE = 0x0307;
+static const uint32_t COMBINING_DIAERESIS = 0x0308;
+static const uint32_t COMBINING_DIAERESIS_WITH_TONOS = 0x0344;
+static const uint32_t GREEK_CAPITAL_SIGMA = 0x03A3;
+static const uint32_t GREEK_SMALL_FINAL_SIGMA = 0x03C2;
+static const uint32_t GREEK_SMALL_SIGMA = 0x03C3;
+static const uint32_t GREEK_SMALL_IOTA_WITH_DIALYTIKA_AND_TONOS = 0x0390;
+static const uint32_t GREEK_SMALL_UPSILON_WITH_DIALYTIKA_AND_TONOS = 0x03B0;
+static const uint32_t GREEK_CAPITAL_IOTA_WITH_DIALYTIKA = 0x03AA;
+static const uint32_t GREEK_CAPITAL_UPSILON_WITH_DIALYTIKA = 0x03AB;
+
+bool AplCoreCaseMapping::toCase(const std::string& value, const std::string& locale, bool upper, std::string& result) {
+    auto language = locale.substr(0, locale.find_first_of("-_"));
+    std::transform(language.begin(), language.end(), language.begin(), [](char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    });
+    if (UNCOVERED_LANGUAGES.count(language)) {
+        return false;
+    }
+    bool turkic = TURKIC_LANGUAGES.count(language) > 0;
+    bool greek = language == GREEK_LANGUAGE;
+
+    // Most bound strings are ASCII, which needs neither decoding nor the special rules of other scripts
+    if (!turkic && std::all_of(value.begin(), value.end(), [](char c) { return (c & 0x80) == 0; })) {
+        result = value;
+        for (auto& c : result) {
+            c = static_cast<char>(upper ? upperCase(c) : lowerCase(c));
+        }
+        return true;
+    }
+
+    std::vector<uint32_t> codePoints;
+    if (!decodeUtf8(value, codePoints) || !std::all_of(codePoints.begin(), codePoints.end(), isCovered)) {
+        return false;
+    }
+
+    result.clear();
+    result.reserve(value.size());
+    if (upper) {
+        bool afterGreek = false;
+        for (auto codePoint : codePoints) {
+            bool combining = codePoint >= 0x0300 && codePoint <= 0x036F;
+            if (greek) {
+                if (combining && afterGreek) {
+                    if (GREEK_ACCENTS.count(codePoint)) {
+                        continue;
+                    }
+                    if (codePoint == COMBINING_DIAERESIS_WITH_TONOS) {
+                        encodeUtf8(COMBINING_DIAERESIS, result);
+                        continue;
+                    }
+                }
+                if (!combining) {
+                    afterGreek = codePoint >= 0x0370 && codePoint <= 0x03FF;
+                }
+                if (afterGreek) {
+                    // The dialytika is kept, as it changes the pronunciation
+                    uint32_t capital = upperCase(codePoint);
+                    if (codePoint == GREEK_SMALL_IOTA_WITH_DIALYTIKA_AND_TONOS) {
+                        capital = GREEK_CAPITAL_IOTA_WITH_DIALYTIKA;
+                    } else if (codePoint == GREEK_SMALL_UPSILON_WITH_DIALYTIKA_AND_TONOS) {
+                        capital = GREEK_CAPITAL_UPSILON_WITH_DIALYTIKA;
+                    }
+                    auto unaccented = GREEK_UNACCENTED_CAPITALS.find(capital);
+                    encodeUtf8(unaccented != GREEK_UNACCENTED_CAPITALS.end() ? unaccented->second : capital, result);
+                    continue;
+                }
+            }
+            if (turkic && codePoint == LATIN_SMALL_I) {
+                encodeUtf8(LATIN_CAPITAL_I_WITH_DOT, result);
+                continue;
+            }
+            auto full = FULL_UPPER_CASE.find(codePoint);
+            if (full != FULL_UPPER_CASE.end()) {
+                for (auto mapped : full->second) {
+                    encodeUtf8(mapped, result);
+                }
+                continue;
+            }
+            encodeUtf8(upperCase(codePoint), result);
+        }
+        return true;
+    }
+
+    for (size_t i = 0; i < codePoints.size(); i++) {
+        auto codePoint = codePoints[i];
+        if (codePoint == LATIN_CAPITAL_I_WITH_DOT) {
+            encodeUtf8(LATIN_SMALL_I, result);
+            if (!turkic) {
+                encodeUtf8(COMBINING_DOT_ABOVE, result);
+            }
+            continue;
+        }
+        if (turkic && codePoint == LATIN_CAPITAL_I) {
+            // A dot above makes it the dotted i
+            if (i + 1 < codePoints.size() && codePoints[i + 1] == COMBINING_DOT_ABOVE) {
+                encodeUtf8(LATIN_SMALL_I, result);
+                i++;
+            } else {
+                encodeUtf8(LATIN_SMALL_DOTLESS_I, result);
+            }
+            continue;
+        }
+        if (codePoint == GREEK_CAPITAL_SIGMA) {
+            encodeUtf8(isFinalSigma(codePoints, i) ? GREEK_SMALL_FINAL_SIGMA : GREEK_SMALL_SIGMA, result);
+            continue;
+        }
+        encodeUtf8(lowerCase(codePoint), result);
+    }
+    return true;
+}
+
+bool AplCoreCaseMapping::decodeUtf8(const std::string& value, std::vector<uint32_t>& codePoints) {
+    codePoints.clear();
+    codePoints.reserve(value.size());
+    for (size_t i = 0; i < value.size();) {
+        auto lead = static_cast<unsigned char>(value[i]);
+        uint32_t codePoint;
+        uint32_t minimum;
+        size_t length;
+        if (lead < 0x80) {
+            codePoint = lead;
+            minimum = 0;
+            length = 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            codePoint = lead & 0x1F;
+            minimum = 0x80;
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            codePoint = lead & 0x0F;
+            minimum = 0x800;
+            length = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+            codePoint = lead & 0x07;
+            minimum = 0x10000;
+            length = 4;
+        } else {
+            return false;
+        }
+
+        if (i + length > value.size()) {
+            return false;
+        }
+        for (size_t j = 1; j < length; j++) {
+            auto next = static_cast<unsigned char>(value[i + j]);
+            if ((next & 0xC0) != 0x80) {
+                return false;
+            }
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+        // Overlong encodings, surrogates and code points beyond Unicode are not valid
+        if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return false;
+        }
+        codePoints.push_back(codePoint);
+        i += length;
+    }
+    return true;
+}
+
+void AplCoreCaseMapping::encodeUtf8(uint32_t codePoint, std::string& out) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool AplCoreCaseMapping::isCovered(uint32_t codePoint) {
+    // Latin, Greek, Cyrillic, the Latin ligatures and the fullwidth forms
+    if (codePoint < 0x0180 || (codePoint >= 0x0300 && codePoint <= 0x052F) ||
+        (codePoint >= 0x1E00 && codePoint <= 0x1EFF) || (codePoint >= 0xFB00 && codePoint <= 0xFB06) ||
+        (codePoint >= 0xFF00 && codePoint <= 0xFFEF)) {
+        return true;
+    }
+    for (auto& range : CASELESS_RANGES) {
+        if (codePoint >= range[0] && codePoint <= range[1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t AplCoreCaseMapping::lowerCase(uint32_t c) {
+    if (c < 0x0080) {
+        return (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+    }
+    if (c < 0x0100) {
+        return (c >= 0x00C0 && c <= 0x00DE && c != 0x00D7) ? c + 0x20 : c;
+    }
+    if (c < 0x0180) {
+        if (c == LATIN_CAPITAL_I_WITH_DOT) {
+            return LATIN_SMALL_I;
+        }
+        if (c == 0x0178) {
+            return 0x00FF;
+        }
+        if (c <= 0x0137 || (c >= 0x014A && c <= 0x0177)) {
+            return c % 2 == 0 ? c + 1 : c;
+        }
+        if ((c >= 0x0139 && c <= 0x0148) || (c >= 0x0179 && c <= 0x017E)) {
+            return c % 2 == 1 ? c + 1 : c;
+        }
+        return c;
+    }
+    if (c >= 0x0370 && c <= 0x03FF) {
+        if (c <= 0x0373 || c == 0x0376) {
+            return c % 2 == 0 ? c + 1 : c;
+        }
+        if (c == 0x037F) {
+            return 0x03F3;
+        }
+        if (c == 0x0386) {
+            return 0x03AC;
+        }
+        if (c >= 0x0388 && c <= 0x038A) {
+            return c + 0x25;
+        }
+        if (c == 0x038C) {
+            return 0x03CC;
+        }
+        if (c == 0x038E || c == 0x038F) {
+            return c + 0x3F;
+        }
+        if ((c >= 0x0391 && c <= 0x03A1) || (c >= 0x03A3 && c <= 0x03AB)) {
+            return c + 0x20;
+        }
+        if (c == 0x03CF) {
+            return 0x03D7;
+        }
+        if (c >= 0x03D8 && c <= 0x03EF) {
+            return c % 2 == 0 ? c + 1 : c;
+        }
+        if (c == 0x03F4) {
+            return 0x03B8;
+        }
+        if (c == 0x03F7 || c == 0x03FA) {
+            return c + 1;
+        }
+        if (c == 0x03F9) {
+            return 0x03F2;
+        }
+        if (c >= 0x03FD) {
+            return c - 0x82;
+        }
+        return c;
+    }
+    if (c >= 0x0400 && c <= 0x052F) {
+        if (c <= 0x040F) {
+            return c + 0x50;
+        }
+        if (c <= 0x042F) {
+            return c + 0x20;
+        }
+        if (c == 0x04C0) {
+            return 0x04CF;
+        }
+        if (c >= 0x04C1 && c <= 0x04CE) {
+            return c % 2 == 1 ? c + 1 : c;
+        }
+        if ((c >= 0x0460 && c <= 0x0481) || (c >= 0x048A && c <= 0x04BF) || c >= 0x04D0) {
+            return c % 2 == 0 ? c + 1 : c;
+        }
+        return c;
+    }
+    if (c >= 0x1E00 && c <= 0x1EFF) {
+        if (c == 0x1E9E) {
+            return 0x00DF;
+        }
+        if (c <= 0x1E95 || c >= 0x1EA0) {
+            return c % 2 == 0 ? c + 1 : c;
+        }
+        return c;
+    }
+    if (c >= 0xFF21 && c <= 0xFF3A) {
+        return c + 0x20;
+    }
+    return c;
+}
+
+uint32_t AplCoreCaseMapping::upperCase(uint32_t c) {
+    if (c < 0x0080) {
+        return (c >= 'a' && c <= 'z') ? c - 0x20 : c;
+    }
+    if (c < 0x0100) {
+        if (c == 0x00B5) {
+            return 0x039C;
+        }
+        if (c == 0x00FF) {
+            return 0x0178;
+        }
+        return (c >= 0x00E0 && c <= 0x00FE && c != 0x00F7) ? c - 0x20 : c;
+    }
+    if (c < 0x0180) {
+        if (c == LATIN_SMALL_DOTLESS_I) {
+            return LATIN_CAPITAL_I;
+        }
+        if (c == 0x017F) {
+            return 'S';
+        }
+        if (c <= 0x0137 || (c >= 0x014A && c <= 0x0177)) {
+            return c % 2 == 1 ? c - 1 : c;
+        }
+        if ((c >= 0x0139 && c <= 0x0148) || (c >= 0x0179 && c <= 0x017E)) {
+            return c % 2 == 0 ? c - 1 : c;
+        }
+        return c;
+    }
+    if (c == 0x0345) {
+        return 0x0399;
+    }
+    if (c >= 0x0370 && c <= 0x03FF) {
+        if (c <= 0x0373 || c == 0x0377) {
+            return c % 2 == 1 ? c - 1 : c;
+        }
+        if (c >= 0x037B && c <= 0x037D) {
+            return c + 0x82;
+        }
+        if (c == 0x03AC) {
+            return 0x0386;
+        }
+        if (c >= 0x03AD && c <= 0x03AF) {
+            return c - 0x25;
+        }
+        if ((c >= 0x03B1 && c <= 0x03C1) || (c >= 0x03C3 && c <= 0x03CB)) {
+            return c - 0x20;
+        }
+        if (c == GREEK_SMALL_FINAL_SIGMA) {
+            return GREEK_CAPITAL_SIGMA;
+        }
+        if (c == 0x03CC) {
+            return 0x038C;
+        }
+        if (c == 0x03CD || c == 0x03CE) {
+            return c - 0x3F;
+        }
+        if (c >= 0x03D8 && c <= 0x03EF) {
+            return c % 2 == 1 ? c - 1 : c;
+        }
+        if (c == 0x03F8 || c == 0x03FB) {
+            return c - 1;
+        }
+        switch (c) {
+            case 0x03D0:
+                return 0x0392;
+            case 0x03D1:
+                return 0x0398;
+            case 0x03D5:
+                return 0x03A6;
+            case 0x03D6:
+                return 0x03A0;
+            case 0x03D7:
+                return 0x03CF;
+            case 0x03F0:
+                return 0x039A;
+            case 0x03F1:
+                return 0x03A1;
+            case 0x03F2:
+                return 0x03F9;
+            case 0x03F3:
+                return 0x037F;
+            case 0x03F5:
+                return 0x0395;
+            default:
+                return c;
+        }
+    }
+    if (c >= 0x0400 && c <= 0x052F) {
+        if (c >= 0x0430 && c <= 0x044F) {
+            return c - 0x20;
+        }
+        if (c >= 0x0450 && c <= 0x045F) {
+            return c - 0x50;
+        }
+        if (c == 0x04CF) {
+            return 0x04C0;
+        }
+        if (c >= 0x04C1 && c <= 0x04CE) {
+            return c % 2 == 0 ? c - 1 : c;
+        }
+        if ((c >= 0x0460 && c <= 0x0481) || (c >= 0x048A && c <= 0x04BF) || c >= 0x04D0) {
+            return c % 2 == 1 ? c - 1 : c;
+        }
+        return c;
+    }
+    if (c >= 0x1E00 && c <= 0x1EFF) {
+        if (c == 0x1E9B) {
+            return 0x1E60;
+        }
+        if (c <= 0x1E95 || c >= 0x1EA0) {
+            return c % 2 == 1 ? c - 1 : c;
+        }
+        return c;
+    }
+    if (c >= 0xFF41 && c <= 0xFF5A) {
+        return c - 0x20;
+    }
+    return c;
+}
+
+bool AplCoreCaseMapping::isCased(uint32_t codePoint) {
+    return lowerCase(codePoint) != codePoint || upperCase(codePoint) != codePoint ||
+           FULL_UPPER_CASE.count(codePoint) || codePoint == 0x00AA || codePoint == 0x00BA || codePoint == 0x0138 ||
+           codePoint == 0x1E9C || codePoint == 0x1E9D;
+}
+
+bool AplCoreCaseMapping::isCaseIgnorable(uint32_t codePoint) {
+    switch (codePoint) {
+        case 0x0027:
+        case 0x002E:
+        case 0x003A:
+        case 0x005E:
+        case 0x0060:
+        case 0x00A8:
+        case 0x00AD:
+        case 0x00AF:
+        case 0x00B4:
+        case 0x00B7:
+        case 0x00B8:
+        case 0x2018:
+        case 0x2019:
+        case 0x2024:
+        case 0x2027:
+            return true;
+        default:
+            // Modifier letters and combining marks
+            return codePoint >= 0x02B0 && codePoint <= 0x036F;
+    }
+}
+
+bool AplCoreCaseMapping::isFinalSigma(const std::vector<uint32_t>& codePoints, size_t index) {
+    // A final sigma follows a cased letter and is not followed by one
+    bool afterCased = false;
+    for (size_t i = index; i > 0; i--) {
+        if (!isCaseIgnorable(codePoints[i - 1])) {
+            afterCased = isCased(codePoints[i - 1]);
+            break;
+        }
+    }
+    if (!afterCased) {
+        return false;
+    }
+    for (size_t i = index + 1; i < codePoints.size(); i++) {
+        if (!isCaseIgnorable(codePoints[i])) {
+            return !isCased(codePoints[i]);
+        }
+    }
+    return true;
+}
+
+}  // namespace APLClient
@@ -13,7 +13,10 @@
  * permissions and limitations under the License.
  */
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
+#include <thread>
 
 #include "APLClient/AplCoreTextMeasurement.h"
 #include "APLClient/AplCoreLocaleMethods.h"
@@ -66,6 +69,8 @@ static const char ALLOWOPENURL_KEY[] = "allowOpenUrl";
 static const char DISALLOWVIDEO_KEY[] = "disallowVideo";
 static const char ANIMATIONQUALITY_KEY[] = "animationQuality";
 static const char SUPPORTED_EXTENSIONS[] = "supportedExtensions";
+static const char MEASUREBATCH_KEY[] = "measureBatch";
+static const char DIRTY_ENCODING_KEY[] = "dirtyEncoding";
 
 /// The keys used in OS accessibility settings.
 static const char FONTSCALE_KEY[] = "fontScale";
@@ -81,6 +86,10 @@ static const char EVENT_KEY[] = "event";
 static const char ARGUMENT_KEY[] = "argument";
 static const char EVENT_TERMINATE_KEY[] = "eventTerminate";
 static const char DIRTY_KEY[] = "dirty";
+static const char DIRTY_DELTA_KEY[] = "dirtyDelta";
+
+/// The dirty encoding asking for "dirtyDelta" messages.
+static const char DIRTY_ENCODING_DELTA[] = "delta";
 
 /// SendEvent keys
 static const char PRESENTATION_TOKEN_KEY[] = "presentationToken";
@@ -132,17 +141,175 @@ static apl::Bimap<std::string, apl::ScreenShape> AVS_VIEWPORT_SHAPE_MAP = {
     {"RECTANGLE", apl::ScreenShape::RECTANGLE},
 };
 
+/// Metric counting documents whose speculative inflation was used for the build.
+static const std::string SPECULATIVE_INFLATION_HIT = "APL-Web.RootContext.speculativeInflationHit";
+/// Metric counting speculative inflations thrown away because the build differed or needed the view host.
+static const std::string SPECULATIVE_INFLATION_DISCARDED = "APL-Web.RootContext.speculativeInflationDiscarded";
+/// Metric counting the inflation attempts made to find a viewport specification a document can be inflated with.
+static const std::string INFLATION_ATTEMPTS = "APL-Web.RootContext.inflationAttempts";
+
+/// Maximum number of documents whose scaling is remembered.
+static const size_t MAX_SCALING_CACHE_SIZE = 32;
+
+/// Metric counting the reused frame buffers which had to grow because a frame did not fit.
+static const std::string FRAME_BUFFER_GROWTHS = "APL-Web.RootContext.frameBufferGrowths";
+
+/// Metric counting the heap allocations made by update ticks, reported when an allocation counter is configured.
+static const std::string FRAME_ALLOCATIONS = "APL-Web.RootContext.frameAllocations";
+
+/// Metric counting the replies to blocking sends which arrived after the request timed out.
+static const std::string LATE_REPLIES = "APL-Web.RootContext.lateViewhostReplies";
+
+/// Metric counting the replies to blocking sends which were already answered.
+static const std::string DUPLICATE_REPLIES = "APL-Web.RootContext.duplicateViewhostReplies";
+
+/// Metric counting the visual context requests served from the cached visual context.
+static const std::string VISUAL_CONTEXT_CACHE_HITS = "APL-Web.RootContext.visualContextCacheHits";
+
+/// Metric counting the visual context requests which serialized the component hierarchy.
+static const std::string VISUAL_CONTEXT_CACHE_MISSES = "APL-Web.RootContext.visualContextCacheMisses";
+
+/// The component properties which change the visual context when dirty.
+static const std::set<apl::PropertyKey> VISUAL_CONTEXT_PROPERTIES = {apl::kPropertyBounds,
+                                                                     apl::kPropertyChecked,
+                                                                     apl::kPropertyCurrentPage,
+                                                                     apl::kPropertyDisabled,
+                                                                     apl::kPropertyDisplay,
+                                                                     apl::kPropertyNotifyChildrenChanged,
+                                                                     apl::kPropertyOpacity,
+                                                                     apl::kPropertyScrollPosition,
+                                                                     apl::kPropertySource,
+                                                                     apl::kPropertyText,
+                                                                     apl::kPropertyTransform};
+
+/// How long blocking send requests are remembered once answered or timed out, to recognize late or duplicate replies.
+static const std::chrono::seconds BLOCKING_REQUEST_RETENTION(10);
+
+/// Metric counting the view host messages parsed from text by this class.
+static const std::string MESSAGE_PARSES = "APL-Web.RootContext.messageParses";
+
+/// Metric sampling the number of document states in the backstack once the document was added to it.
+static const std::string BACKSTACK_CACHED_STATES = "APL-Web.Backstack.cachedDocumentStates";
+
+/// Metric sampling the estimated size in bytes of the live document states in the backstack once the document was
+/// added to it.
+static const std::string BACKSTACK_CACHED_STATE_BYTES = "APL-Web.Backstack.cachedDocumentStateBytes";
+
+/// Metric sampling the estimated size in bytes of the document state added to the backstack.
+static const std::string BACKSTACK_DOCUMENT_STATE_BYTES = "APL-Web.Backstack.documentStateBytes";
+
+/// Metric timing the restore of a live document state from the backstack.
+static const std::string BACKSTACK_RESTORE_LIVE = "APL-Web.Backstack.restoreLiveDocumentState";
+
+/// Metric timing the restore of a hibernated document state from the backstack, which inflates it again.
+static const std::string BACKSTACK_RESTORE_HIBERNATED = "APL-Web.Backstack.restoreHibernatedDocumentState";
+
+/**
+ * A SAX handler forwarding to a document while making it copy every string, so the document does not refer to the
+ * strings of the value it is built from, such as those of a message parsed in place.
+ */
+class StringCopyingHandler {
+public:
+    explicit StringCopyingHandler(rapidjson::Document& document) : m_document(document) {
+    }
+
+    bool Null() {
+        return m_document.Null();
+    }
+    bool Bool(bool value) {
+        return m_document.Bool(value);
+    }
+    bool Int(int value) {
+        return m_document.Int(value);
+    }
+    bool Uint(unsigned value) {
+        return m_document.Uint(value);
+    }
+    bool Int64(int64_t value) {
+        return m_document.Int64(value);
+    }
+    bool Uint64(uint64_t value) {
+        return m_document.Uint64(value);
+    }
+    bool Double(double value) {
+        return m_document.Double(value);
+    }
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool) {
+        return m_document.RawNumber(str, length, true);
+    }
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        return m_document.String(str, length, true);
+    }
+    bool StartObject() {
+        return m_document.StartObject();
+    }
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        return m_document.Key(str, length, true);
+    }
+    bool EndObject(rapidjson::SizeType memberCount) {
+        return m_document.EndObject(memberCount);
+    }
+    bool StartArray() {
+        return m_document.StartArray();
+    }
+    bool EndArray(rapidjson::SizeType elementCount) {
+        return m_document.EndArray(elementCount);
+    }
+
+private:
+    rapidjson::Document& m_document;
+};
+
+/**
+ * Copies a value into a document owning all of its data.
+ *
+ * @param value The value
+ * @return The document
+ */
+static rapidjson::Document copyToDocument(const rapidjson::Value& value) {
+    rapidjson::Document document;
+    auto generator = [&value](rapidjson::Document& target) {
+        StringCopyingHandler handler(target);
+        return value.Accept(handler);
+    };
+    document.Populate(generator);
+    return document;
+}
+
+/// Initial size of the buffer backing the messages sent by the frame loop.
+static const size_t FRAME_BUFFER_SIZE = 16 * 1024;
+
+/// Size the buffer backing the messages sent by the frame loop grows up to.
+static const size_t MAX_FRAME_BUFFER_SIZE = 1024 * 1024;
+
+/// How often the frame loop refreshes the timezone offset of the device.
+static const std::chrono::milliseconds TIMEZONE_REFRESH_INTERVAL{1000};
+
 static apl::Bimap<std::string, apl::RootConfig::ScreenMode> AVS_SCREEN_MODE_MAP = {
         {"normal", apl::RootConfig::kScreenModeNormal},
         {"high-contrast", apl::RootConfig::kScreenModeHighContrast},
 };
 
+thread_local AplCoreConnectionManager::SpeculativeInflation* AplCoreConnectionManager::s_currentSpeculation = nullptr;
+
 AplCoreConnectionManager::AplCoreConnectionManager(AplConfigurationPtr config) :
         m_aplConfiguration{config},
         m_ScreenLock{false},
         m_SequenceNumber{0},
-        m_replyExpectedSequenceNumber{0},
-        m_blockingSendReplyExpected{false} {
+        m_pendingBlockingRequestCount{0},
+        m_settledBlockingRequestCount{0},
+        m_textMeasurementCache{std::make_shared<AplCoreTextMeasurementCache>()},
+        m_localeMethodsCache{std::make_shared<AplCoreLocaleMethodsCache>()},
+        m_documentHash{0},
+        m_supportedViewportsHash{0},
+        m_scalingCache{MAX_SCALING_CACHE_SIZE},
+        m_dirtyDeltaEnabled{false},
+        m_visualContextValid{false},
+        m_frameBuffer{new char[FRAME_BUFFER_SIZE]},
+        m_frameBufferSize{FRAME_BUFFER_SIZE},
+        m_frameAllocator{new rapidjson::Document::AllocatorType(m_frameBuffer.get(), FRAME_BUFFER_SIZE)},
+        m_dataSourcesUsed{false},
+        m_timezoneOffset{0} {
     m_StartTime = getCurrentTime();
     m_renderingStart = std::chrono::steady_clock::time_point(std::chrono::milliseconds(0));
 
@@ -177,13 +344,101 @@ AplCoreConnectionManager::AplCoreConnectionManager(AplConfigurationPtr config) :
     m_messageHandlers.emplace("getDisplayedChildId", [this](const rapidjson::Value& payload) { handleGetDisplayedChildId(payload); });
 }
 
-void AplCoreConnectionManager::setContent(const apl::ContentPtr content, const std::string& token) {
+AplCoreConnectionManager::~AplCoreConnectionManager() {
+    takeSpeculativeInflation();
+}
+
+void AplCoreConnectionManager::setContent(
+    const apl::ContentPtr content,
+    const std::string& token,
+    size_t documentHash,
+    AplDocumentSourcePtr source) {
+    if (takeSpeculativeInflation()) {
+        m_aplConfiguration->getMetricsRecorder()
+            ->createCounter(Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, SPECULATIVE_INFLATION_DISCARDED)
+            ->increment();
+    }
     m_Content = content;
+    m_contentSource = std::move(source);
     m_aplToken = token;
+    m_documentHash = documentHash;
+    m_visualContextValid = false;
     m_ConfigurationChange.clear();
+    // Start inflating while the view host resets and sends its build message
+    startSpeculativeInflation();
     m_aplConfiguration->getAplOptions()->resetViewhost(token);
 }
 
+void AplCoreConnectionManager::startSpeculativeInflation() {
+    // Extensions are configured from the build message, and the state of a restored document must be kept as is
+    if (m_lastBuildMessage.empty() || m_documentStateToRestore || !m_Content || !m_Content->isReady() ||
+        !m_Content->getExtensionRequests().empty()) {
+        return;
+    }
+    // Text is measured by the view host unless there is an in-process backend or the measurements are cached, and
+    // the view host cannot measure before the handshake, so the inflation would only be thrown away
+    if (!m_aplConfiguration->getTextMeasurementBackend() && m_textMeasurementCache->size() == 0) {
+        return;
+    }
+
+    rapidjson::Document message;
+    if (message.Parse(m_lastBuildMessage.c_str()).HasParseError()) {
+        return;
+    }
+
+    auto speculation = std::make_shared<SpeculativeInflation>();
+    speculation->buildMessage = m_lastBuildMessage;
+    speculation->config = createRootConfig(message);
+    speculation->viewportSizeSpecifications = m_ViewportSizeSpecifications;
+    auto metrics = createMetrics(message);
+    auto scalingKey = getScalingKey(m_lastBuildMessage);
+    auto content = m_Content;
+    m_speculation = speculation;
+
+    // The worker is joined before the speculation is taken, and at the latest on destruction
+    m_speculationThread = std::thread([this, speculation, content, metrics, scalingKey]() {
+        s_currentSpeculation = speculation.get();
+        speculation->root = inflate(
+            content,
+            metrics,
+            speculation->config,
+            scalingKey,
+            speculation->viewportSizeSpecifications,
+            speculation->aplCoreMetrics,
+            &speculation->attempts,
+            []() {});
+        s_currentSpeculation = nullptr;
+    });
+}
+
+std::shared_ptr<AplCoreConnectionManager::SpeculativeInflation> AplCoreConnectionManager::takeSpeculativeInflation() {
+    if (m_speculationThread.joinable()) {
+        m_speculationThread.join();
+    }
+    if (m_speculation) {
+        for (auto& notification : m_speculation->notifications) {
+            notification();
+        }
+        m_speculation->notifications.clear();
+    }
+    return std::move(m_speculation);
+}
+
+AplCoreMetricsPtr AplCoreConnectionManager::aplCoreMetrics() const {
+    if (s_currentSpeculation) {
+        return s_currentSpeculation->aplCoreMetrics;
+    }
+    return m_AplCoreMetrics;
+}
+
+void AplCoreConnectionManager::emitNotification(std::function<void()> notification) {
+    if (s_currentSpeculation) {
+        s_currentSpeculation->notifications.push_back(std::move(notification));
+        return;
+    }
+    notification();
+}
+
 void AplCoreConnectionManager::setSupportedViewports(const std::string& jsonPayload) {
     rapidjson::Document doc;
     auto aplOptions = m_aplConfiguration->getAplOptions();
@@ -197,6 +452,7 @@ void AplCoreConnectionManager::setSupportedViewports(const std::string& jsonPayl
         return;
     }
 
+    m_supportedViewportsHash = std::hash<std::string>()(jsonPayload);
     m_ViewportSizeSpecifications.clear();
     for (auto& spec : doc.GetArray()) {
         double minWidth = getOptionalValue(spec, "minWidth", 1);
@@ -267,43 +523,102 @@ int AplCoreConnectionManager::getOptionalInt(
 }
 
 bool AplCoreConnectionManager::shouldHandleMessage(const std::string& message) {
-    if (m_blockingSendReplyExpected) {
+    // Only messages which may answer a pending request need to be parsed here, late and duplicate replies are
+    // recognized by handleMessage
+    if (m_pendingBlockingRequestCount > 0) {
         rapidjson::Document doc;
+        m_aplConfiguration->getMetricsRecorder()
+            ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, MESSAGE_PARSES)
+            ->increment();
         if (doc.Parse(message.c_str()).HasParseError()) {
             auto aplOptions = m_aplConfiguration->getAplOptions();
             aplOptions->logMessage(LogLevel::ERROR, "shouldHandleMessageFailed", "Error whilst parsing message");
             return false;
         }
 
-        if (doc.HasMember(SEQNO_KEY) && doc[SEQNO_KEY].IsNumber()) {
-            unsigned int seqno = doc[SEQNO_KEY].GetUint();
-            if (seqno == m_replyExpectedSequenceNumber) {
-                m_blockingSendReplyExpected = false;
-                m_replyPromise.set_value(message);
-                return false;
-            }
-        }
+        return shouldHandleMessage(doc);
     }
 
     return true;
 }
 
+bool AplCoreConnectionManager::shouldHandleMessage(const rapidjson::Value& message) {
+    if ((m_pendingBlockingRequestCount == 0 && m_settledBlockingRequestCount == 0) || !message.IsObject()) {
+        return true;
+    }
+
+    auto seqnoIt = message.FindMember(SEQNO_KEY);
+    if (seqnoIt == message.MemberEnd() || !seqnoIt->value.IsUint()) {
+        return true;
+    }
+    unsigned int seqno = seqnoIt->value.GetUint();
+
+    std::string lateOrDuplicate;
+    {
+        std::lock_guard<std::mutex> lock{m_blockingRequestsMutex};
+        pruneBlockingRequests();
+        auto pending = m_pendingBlockingRequests.find(seqno);
+        if (pending != m_pendingBlockingRequests.end()) {
+            // The message may refer to the buffer it was parsed from, so the reply gets its own copy
+            pending->second.set_value(copyToDocument(message));
+            settleBlockingRequest(pending, false);
+            return false;
+        }
+
+        auto settled = m_settledBlockingRequests.find(seqno);
+        if (settled == m_settledBlockingRequests.end()) {
+            return true;
+        }
+        lateOrDuplicate = settled->second.timedOut ? LATE_REPLIES : DUPLICATE_REPLIES;
+    }
+
+    m_aplConfiguration->getMetricsRecorder()
+        ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, lateOrDuplicate)
+        ->increment();
+    m_aplConfiguration->getAplOptions()->logMessage(
+        LogLevel::WARN,
+        "shouldHandleMessage",
+        (lateOrDuplicate == LATE_REPLIES ? "Late reply dropped, seqno: " : "Duplicate reply dropped, seqno: ") +
+            std::to_string(seqno));
+    return false;
+}
+
 void AplCoreConnectionManager::handleMessage(const std::string& message) {
-    auto aplOptions = m_aplConfiguration->getAplOptions();
     rapidjson::Document doc;
+    m_aplConfiguration->getMetricsRecorder()
+        ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, MESSAGE_PARSES)
+        ->increment();
     if (doc.Parse(message.c_str()).HasParseError()) {
+        auto aplOptions = m_aplConfiguration->getAplOptions();
         aplOptions->logMessage(LogLevel::ERROR, "handleMessageFailed", "Error whilst parsing message");
         return;
     }
 
-    if (!doc.HasMember("type")) {
+    handleMessage(doc);
+}
+
+void AplCoreConnectionManager::handleMessage(const rapidjson::Value& message) {
+    auto aplOptions = m_aplConfiguration->getAplOptions();
+    if (!message.IsObject()) {
+        aplOptions->logMessage(LogLevel::ERROR, "handleMessageFailed", "Message is not an object");
+        return;
+    }
+
+    // Text messages are not parsed by shouldHandleMessage once no request is pending, so late and duplicate replies
+    // are dropped here
+    if (m_settledBlockingRequestCount > 0 && !shouldHandleMessage(message)) {
+        return;
+    }
+
+    auto typeIt = message.FindMember("type");
+    if (typeIt == message.MemberEnd() || !typeIt->value.IsString()) {
         aplOptions->logMessage(LogLevel::ERROR, "handleMessageFailed", "Unable to find type in message");
         return;
     }
-    std::string type = doc["type"].GetString();
+    std::string type(typeIt->value.GetString(), typeIt->value.GetStringLength());
 
-    auto payload = doc.FindMember("payload");
-    if (payload == doc.MemberEnd()) {
+    auto payload = message.FindMember("payload");
+    if (payload == message.MemberEnd()) {
         aplOptions->logMessage(LogLevel::ERROR, "handleMessageFailed", "Unable to find payload in message");
         return;
     }
@@ -449,15 +764,71 @@ void AplCoreConnectionManager::onExtensionEventResult(unsigned int event, bool s
     handleEventResponse(payload);
 }
 
-AplDocumentStatePtr AplCoreConnectionManager::getActiveDocumentState() {
+AplDocumentStatePtr AplCoreConnectionManager::getActiveDocumentState(bool estimateSize) {
     // If we have active content, report it as an AplDocumentState
     if (m_Content && m_Root && m_AplCoreMetrics) {
-        auto documentState = std::make_shared<AplDocumentState>(m_aplToken, m_Root, m_AplCoreMetrics);
+        auto documentState =
+            std::make_shared<AplDocumentState>(m_aplToken, m_Root, m_AplCoreMetrics, m_contentSource);
+        if (estimateSize) {
+            documentState->estimatedSize = estimateDocumentStateSize();
+        }
         return documentState;
     }
     return nullptr;
 }
 
+void AplCoreConnectionManager::reportBackstackSize(
+    const AplDocumentStatePtr& documentState,
+    size_t documentStates,
+    size_t liveBytes) {
+    auto metricsRecorder = m_aplConfiguration->getMetricsRecorder();
+    metricsRecorder
+        ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, BACKSTACK_CACHED_STATES)
+        ->set(documentStates);
+    metricsRecorder
+        ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, BACKSTACK_CACHED_STATE_BYTES)
+        ->set(liveBytes);
+    if (documentState) {
+        metricsRecorder
+            ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, BACKSTACK_DOCUMENT_STATE_BYTES)
+            ->set(documentState->estimatedSize);
+    }
+}
+
+size_t AplCoreConnectionManager::estimateDocumentStateSize() {
+    rapidjson::Document document;
+    auto hierarchy = m_Root->topComponent()->serialize(document.GetAllocator());
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    hierarchy.Accept(writer);
+    return buffer.GetSize();
+}
+
+apl::RootContextPtr AplCoreConnectionManager::inflateDocumentState(const AplDocumentStatePtr& documentState) {
+    std::shared_ptr<apl::MetricsTransform> metrics = documentState->metrics;
+    if (!metrics) {
+        metrics = m_AplCoreMetrics;
+    }
+    if (!metrics || !documentState->source) {
+        return nullptr;
+    }
+
+    auto content = documentState->source->createContent();
+    if (!content) {
+        return nullptr;
+    }
+
+    // The clock of the document carries on from now rather than from when it was first inflated
+    auto config = documentState->rootConfig;
+    config.utcTime(getCurrentTime().count())
+        .localTimeAdjustment(m_aplConfiguration->getAplOptions()->getTimezoneOffset().count());
+    auto root = apl::RootContext::create(metrics->getMetrics(), content, config);
+    if (root) {
+        documentState->restoreComponentStates(root);
+    }
+    return root;
+}
+
 void AplCoreConnectionManager::restoreDocumentState(AplDocumentStatePtr documentState) {
     m_documentStateToRestore = std::move(documentState);
     m_documentStateToRestore->configurationChange = m_ConfigurationChange;
@@ -496,6 +867,7 @@ void AplCoreConnectionManager::dataSourceUpdate(
         return;
     }
 
+    m_dataSourcesUsed = true;
     bool result = provider->processUpdate(jsonPayload);
     if (!result) {
         aplOptions->logMessage(LogLevel::ERROR, "dataSourceUpdateFailed", "Update is not processed.");
@@ -510,28 +882,46 @@ void AplCoreConnectionManager::provideState(unsigned int stateRequestToken) {
             Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT,
             "APL-Web.RootContext.notifyVisualContext");
     timer->start();
-    rapidjson::Document state(rapidjson::kObjectType);
-    rapidjson::Document::AllocatorType& allocator = state.GetAllocator();
-    // Add presentation token info
-    state.AddMember(TOKEN_KEY, m_aplToken, allocator);
-    // Add version info
-    state.AddMember(VERSION_KEY, VERSION_VALUE, allocator);
-    rapidjson::Value arr(rapidjson::kArrayType);
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    if (m_Root && m_Root->topComponent()) {
-        auto context = m_Root->topComponent()->serializeVisualContext(allocator);
-        arr.PushBack(context, allocator);
+
+    // Changes made since the last frame are not processed yet
+    if (m_visualContextValid && m_Root && m_Root->isDirty()) {
+        invalidateVisualContext(m_Root->getDirty());
+    }
+
+    if (m_visualContextValid) {
+        m_aplConfiguration->getMetricsRecorder()
+            ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, VISUAL_CONTEXT_CACHE_HITS)
+            ->increment();
     } else {
-        aplOptions->logMessage(LogLevel::ERROR, "provideStateFailed", "Unable to get visual context");
-        rapidjson::Value emptyObj(rapidjson::kObjectType);
-        // add an empty visual context
-        arr.PushBack(emptyObj, allocator);
-    }
-    // Add visual context info
-    state.AddMember(CONTEXT_KEY, arr, allocator);
-    state.Accept(writer);
-    aplOptions->onVisualContextAvailable(m_aplToken, stateRequestToken, buffer.GetString());
+        m_aplConfiguration->getMetricsRecorder()
+            ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, VISUAL_CONTEXT_CACHE_MISSES)
+            ->increment();
+
+        rapidjson::Document state(rapidjson::kObjectType);
+        rapidjson::Document::AllocatorType& allocator = state.GetAllocator();
+        // Add presentation token info
+        state.AddMember(TOKEN_KEY, m_aplToken, allocator);
+        // Add version info
+        state.AddMember(VERSION_KEY, VERSION_VALUE, allocator);
+        rapidjson::Value arr(rapidjson::kArrayType);
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        if (m_Root && m_Root->topComponent()) {
+            auto context = m_Root->topComponent()->serializeVisualContext(allocator);
+            arr.PushBack(context, allocator);
+            m_visualContextValid = true;
+        } else {
+            aplOptions->logMessage(LogLevel::ERROR, "provideStateFailed", "Unable to get visual context");
+            rapidjson::Value emptyObj(rapidjson::kObjectType);
+            // add an empty visual context
+            arr.PushBack(emptyObj, allocator);
+        }
+        // Add visual context info
+        state.AddMember(CONTEXT_KEY, arr, allocator);
+        state.Accept(writer);
+        m_visualContext.assign(buffer.GetString(), buffer.GetSize());
+    }
+    aplOptions->onVisualContextAvailable(m_aplToken, stateRequestToken, m_visualContext);
     timer->stop();
 }
 
@@ -552,15 +942,34 @@ void AplCoreConnectionManager::handleBuild(const rapidjson::Value& message) {
     /* APL Document Inflation started */
     aplOptions->onRenderingEvent(m_aplToken, AplRenderingEvent::INFLATE_BEGIN);
 
+    // The inflation worker must be done before the document state is touched
+    auto speculation = takeSpeculativeInflation();
 
     apl::RootConfig config;
 
+    std::unique_ptr<Telemetry::AplTimerHandle> restoreTimer;
     if (m_documentStateToRestore) {
-        // Restore from document state
+        // Restore from document state, inflating it again if it was hibernated
+        bool hibernated = m_documentStateToRestore->isHibernated();
+        restoreTimer = m_aplConfiguration->getMetricsRecorder()->createTimer(
+            Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT,
+            hibernated ? BACKSTACK_RESTORE_HIBERNATED : BACKSTACK_RESTORE_LIVE);
+        restoreTimer->start();
+
         m_aplToken = m_documentStateToRestore->token;
-        m_Root = m_documentStateToRestore->rootContext;
+        m_Root = hibernated ? inflateDocumentState(m_documentStateToRestore) : m_documentStateToRestore->rootContext;
+        if (!m_Root) {
+            m_documentStateToRestore.reset();
+            aplOptions->logMessage(LogLevel::ERROR, "handleBuildFailed", "Unable to restore document state");
+            sendError("Unable to restore document state");
+            restoreTimer->fail();
+            inflationTimer->fail();
+            aplOptions->onRenderDocumentComplete(m_aplToken, false, "Unable to restore document state");
+            return;
+        }
         m_Content = m_Root->content();
-        config = m_documentStateToRestore->rootContext->getRootConfig();
+        m_contentSource = m_documentStateToRestore->source;
+        config = m_Root->getRootConfig();
         m_Root->configurationChange(m_documentStateToRestore->configurationChange);
         coreFrameUpdate();
     }
@@ -575,39 +984,29 @@ void AplCoreConnectionManager::handleBuild(const rapidjson::Value& message) {
     // Get APL Version for content
     std::string aplVersion = m_Content->getAPLVersion();
 
+    // Adopt the document inflated ahead of the handshake if it was inflated for the same build message
+    std::string buildMessage;
+    serializeJSONValueToString(message, &buildMessage);
+    bool adoptSpeculation = speculation && !m_documentStateToRestore && speculation->buildMessage == buildMessage &&
+                            speculation->root && !speculation->needsViewhost;
+    if (speculation) {
+        m_aplConfiguration->getMetricsRecorder()
+            ->createCounter(
+                Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT,
+                adoptSpeculation ? SPECULATIVE_INFLATION_HIT : SPECULATIVE_INFLATION_DISCARDED)
+            ->increment();
+    }
+
+    // A new component hierarchy is sent, so no dirty values are known to the view host
+    m_dirtyDeltaEnabled = getOptionalValue(message, DIRTY_ENCODING_KEY, "") == DIRTY_ENCODING_DELTA;
+    m_dirtyEncoder.reset();
+    m_visualContextValid = false;
+    m_dataSourcesUsed = false;
+
     // If we're not restoring a document state, create a new RootConfig.
     if (!m_documentStateToRestore) {
-        std::string agentName = getOptionalValue(message, AGENTNAME_KEY, "wssHost");
-        std::string agentVersion = getOptionalValue(message, AGENTVERSION_KEY, "1.0");
-        bool allowOpenUrl = getOptionalBool(message, ALLOWOPENURL_KEY, false);
-        bool disallowVideo = getOptionalBool(message, DISALLOWVIDEO_KEY, false);
-        int animationQuality =
-            getOptionalInt(message, ANIMATIONQUALITY_KEY, apl::RootConfig::AnimationQuality::kAnimationQualityNormal);
-
-        config = apl::RootConfig()
-                     .agent(agentName, agentVersion)
-                     .allowOpenUrl(allowOpenUrl)
-                     .disallowVideo(disallowVideo)
-                     .animationQuality(static_cast<apl::RootConfig::AnimationQuality>(animationQuality))
-                     .measure(std::make_shared<AplCoreTextMeasurement>(shared_from_this(), m_aplConfiguration))
-                     .localeMethods(std::make_shared<AplCoreLocaleMethods>(shared_from_this(), m_aplConfiguration))
-                     .utcTime(getCurrentTime().count())
-                     .localTimeAdjustment(aplOptions->getTimezoneOffset().count())
-                     .enforceAPLVersion(apl::APLVersion::kAPLVersionIgnore)
-                     .sequenceChildCache(5)
-                     .enableExperimentalFeature(apl::RootConfig::ExperimentalFeature::kExperimentalFeatureHandleScrollingAndPagingInCore)
-                     .enableExperimentalFeature(apl::RootConfig::ExperimentalFeature::kExperimentalFeatureNotifyChildrenChangedOnDisplayChange)
-                     .enableExperimentalFeature(apl::RootConfig::ExperimentalFeature::kExperimentalFeatureHandleFocusInCore)
-                     .set(apl::RootProperty::kDefaultIdleTimeout, -1);
-
-        // Data Sources
-        config.dataSourceProvider(
-            apl::DynamicIndexListConstants::DEFAULT_TYPE_NAME,
-            std::make_shared<apl::DynamicIndexListDataSourceProvider>());
-
-        config.dataSourceProvider(
-                apl::DynamicTokenListConstants::DEFAULT_TYPE_NAME,
-                std::make_shared<apl::DynamicTokenListDataSourceProvider>());
+        m_lastBuildMessage = buildMessage;
+        config = adoptSpeculation ? speculation->config : createRootConfig(message);
     }
 
     // Add Extensions which are supported, requested, and available to the config
@@ -649,44 +1048,37 @@ void AplCoreConnectionManager::handleBuild(const rapidjson::Value& message) {
     // If we're not restoring a document state, then create metrics and RootContext
     if (!m_documentStateToRestore) {
         // Handle metrics data
-        m_Metrics.size(message[WIDTH_KEY].GetInt(), message[HEIGHT_KEY].GetInt())
-            .dpi(message[DPI_KEY].GetInt())
-            .shape(AVS_VIEWPORT_SHAPE_MAP.at(message[SHAPE_KEY].GetString()))
-            .mode(AVS_VIEWPORT_MODE_MAP.at(message[MODE_KEY].GetString()));
-
-        do {
-            apl::ScalingOptions scalingOptions = {
-                m_ViewportSizeSpecifications, SCALING_BIAS_CONSTANT, SCALING_SHAPE_OVERRIDES_COST};
-            if (!scalingOptions.getSpecifications().empty()) {
-                m_AplCoreMetrics = std::make_shared<AplCoreMetrics>(m_Metrics, scalingOptions);
-            } else {
-                m_AplCoreMetrics = std::make_shared<AplCoreMetrics>(m_Metrics);
-            }
+        m_Metrics = createMetrics(message);
 
+        unsigned int attempts = 0;
+        if (adoptSpeculation) {
+            m_ViewportSizeSpecifications = std::move(speculation->viewportSizeSpecifications);
+            m_AplCoreMetrics = speculation->aplCoreMetrics;
             sendViewhostScalingMessage();
 
+            // The document clock starts now, as no time has been reported to the root context since it was created
             m_renderingStart = std::chrono::steady_clock::now();
-            m_StartTime = getCurrentTime();
-            m_Root = apl::RootContext::create(m_AplCoreMetrics->getMetrics(), m_Content, config);
-            if (m_Root) {
-                break;
-            } else if (!m_ViewportSizeSpecifications.empty()) {
-                aplOptions->logMessage(
-                    LogLevel::WARN, __func__, "Unable to inflate document with current chosen scaling.");
-            }
-
-            auto it = m_ViewportSizeSpecifications.begin();
-            for (; it != m_ViewportSizeSpecifications.end(); it++) {
-                if (*it == m_AplCoreMetrics->getChosenSpec()) {
-                    m_ViewportSizeSpecifications.erase(it);
-                    break;
-                }
-            }
-            if (it == m_ViewportSizeSpecifications.end()) {
-                // Core returned specification that is not in list. Something went wrong. Prevent infinite loop.
-                break;
-            }
-        } while (!m_ViewportSizeSpecifications.empty());
+            m_Root = speculation->root;
+            attempts = speculation->attempts;
+        } else {
+            m_Root = inflate(
+                m_Content,
+                m_Metrics,
+                config,
+                getScalingKey(buildMessage),
+                m_ViewportSizeSpecifications,
+                m_AplCoreMetrics,
+                &attempts,
+                [this]() {
+                    sendViewhostScalingMessage();
+
+                    m_renderingStart = std::chrono::steady_clock::now();
+                    m_StartTime = getCurrentTime();
+                });
+        }
+        m_aplConfiguration->getMetricsRecorder()
+            ->createCounter(Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, INFLATION_ATTEMPTS)
+            ->incrementBy(attempts);
     }
 
     // Make sure we only restore a documentState once.
@@ -712,6 +1104,9 @@ void AplCoreConnectionManager::handleBuild(const rapidjson::Value& message) {
 
     if (m_Root) {
         inflationTimer->stop();
+        if (restoreTimer) {
+            restoreTimer->stop();
+        }
         // Init viewhost globals
         sendViewhostScalingMessage();
         sendDocumentThemeMessage();
@@ -734,6 +1129,145 @@ void AplCoreConnectionManager::handleBuild(const rapidjson::Value& message) {
     }
 }
 
+apl::RootConfig AplCoreConnectionManager::createRootConfig(const rapidjson::Value& message) {
+    auto aplOptions = m_aplConfiguration->getAplOptions();
+
+    std::string agentName = getOptionalValue(message, AGENTNAME_KEY, "wssHost");
+    std::string agentVersion = getOptionalValue(message, AGENTVERSION_KEY, "1.0");
+    bool allowOpenUrl = getOptionalBool(message, ALLOWOPENURL_KEY, false);
+    bool disallowVideo = getOptionalBool(message, DISALLOWVIDEO_KEY, false);
+    // Only viewhosts which announce support for it receive batched measurement requests
+    bool measureBatch = getOptionalBool(message, MEASUREBATCH_KEY, false);
+    int animationQuality =
+        getOptionalInt(message, ANIMATIONQUALITY_KEY, apl::RootConfig::AnimationQuality::kAnimationQualityNormal);
+
+    auto config = apl::RootConfig()
+        .agent(agentName, agentVersion)
+        .allowOpenUrl(allowOpenUrl)
+        .disallowVideo(disallowVideo)
+        .animationQuality(static_cast<apl::RootConfig::AnimationQuality>(animationQuality))
+        .measure(std::make_shared<AplCoreTextMeasurement>(
+            shared_from_this(), m_aplConfiguration, m_textMeasurementCache, measureBatch))
+        .localeMethods(
+            std::make_shared<AplCoreLocaleMethods>(shared_from_this(), m_aplConfiguration, m_localeMethodsCache))
+        .utcTime(getCurrentTime().count())
+        .localTimeAdjustment(aplOptions->getTimezoneOffset().count())
+        .enforceAPLVersion(apl::APLVersion::kAPLVersionIgnore)
+        .sequenceChildCache(5)
+        .enableExperimentalFeature(apl::RootConfig::ExperimentalFeature::kExperimentalFeatureHandleScrollingAndPagingInCore)
+        .enableExperimentalFeature(apl::RootConfig::ExperimentalFeature::kExperimentalFeatureNotifyChildrenChangedOnDisplayChange)
+        .enableExperimentalFeature(apl::RootConfig::ExperimentalFeature::kExperimentalFeatureHandleFocusInCore)
+        .set(apl::RootProperty::kDefaultIdleTimeout, -1);
+
+    // Data Sources
+    config.dataSourceProvider(
+        apl::DynamicIndexListConstants::DEFAULT_TYPE_NAME,
+        std::make_shared<apl::DynamicIndexListDataSourceProvider>());
+
+    config.dataSourceProvider(
+            apl::DynamicTokenListConstants::DEFAULT_TYPE_NAME,
+            std::make_shared<apl::DynamicTokenListDataSourceProvider>());
+
+    return config;
+}
+
+apl::Metrics AplCoreConnectionManager::createMetrics(const rapidjson::Value& message) {
+    return apl::Metrics()
+        .size(message[WIDTH_KEY].GetInt(), message[HEIGHT_KEY].GetInt())
+        .dpi(message[DPI_KEY].GetInt())
+        .shape(AVS_VIEWPORT_SHAPE_MAP.at(message[SHAPE_KEY].GetString()))
+        .mode(AVS_VIEWPORT_MODE_MAP.at(message[MODE_KEY].GetString()));
+}
+
+std::string AplCoreConnectionManager::getScalingKey(const std::string& buildMessage) {
+    if (!m_documentHash) {
+        return "";
+    }
+    return std::to_string(m_documentHash) + ":" + std::to_string(m_supportedViewportsHash) + ":" +
+           std::to_string(std::hash<std::string>()(buildMessage));
+}
+
+apl::RootContextPtr AplCoreConnectionManager::inflate(
+    const apl::ContentPtr& content,
+    const apl::Metrics& metrics,
+    const apl::RootConfig& config,
+    const std::string& scalingKey,
+    std::vector<apl::ViewportSpecification>& specifications,
+    AplCoreMetricsPtr& aplCoreMetrics,
+    unsigned int* attempts,
+    const std::function<void()>& beforeCreate) {
+    *attempts = 0;
+    if (scalingKey.empty()) {
+        return inflateWithScaling(content, metrics, config, specifications, aplCoreMetrics, attempts, beforeCreate);
+    }
+
+    std::vector<apl::ViewportSpecification> remaining;
+    if (m_scalingCache.get(scalingKey, remaining)) {
+        if (auto root =
+                inflateWithScaling(content, metrics, config, remaining, aplCoreMetrics, attempts, beforeCreate)) {
+            specifications = std::move(remaining);
+            return root;
+        }
+        // The data bound to the document changed what it can be inflated with, so start again from all specifications
+        m_scalingCache.remove(scalingKey);
+    }
+
+    auto root = inflateWithScaling(content, metrics, config, specifications, aplCoreMetrics, attempts, beforeCreate);
+    // Only remember the scaling when specifications had to be dropped, as otherwise the first attempt succeeds anyway
+    if (root && *attempts > 1) {
+        m_scalingCache.put(scalingKey, specifications);
+    }
+    return root;
+}
+
+apl::RootContextPtr AplCoreConnectionManager::inflateWithScaling(
+    const apl::ContentPtr& content,
+    const apl::Metrics& metrics,
+    const apl::RootConfig& config,
+    std::vector<apl::ViewportSpecification>& specifications,
+    AplCoreMetricsPtr& aplCoreMetrics,
+    unsigned int* attempts,
+    const std::function<void()>& beforeCreate) {
+    auto aplOptions = m_aplConfiguration->getAplOptions();
+    apl::RootContextPtr root;
+
+    do {
+        apl::ScalingOptions scalingOptions = {specifications, SCALING_BIAS_CONSTANT, SCALING_SHAPE_OVERRIDES_COST};
+        if (!scalingOptions.getSpecifications().empty()) {
+            aplCoreMetrics = std::make_shared<AplCoreMetrics>(metrics, scalingOptions);
+        } else {
+            aplCoreMetrics = std::make_shared<AplCoreMetrics>(metrics);
+        }
+
+        beforeCreate();
+
+        (*attempts)++;
+        root = apl::RootContext::create(aplCoreMetrics->getMetrics(), content, config);
+        if (root) {
+            break;
+        } else if (!specifications.empty()) {
+            emitNotification([aplOptions]() {
+                aplOptions->logMessage(
+                    LogLevel::WARN, "inflateWithScaling", "Unable to inflate document with current chosen scaling.");
+            });
+        }
+
+        auto it = specifications.begin();
+        for (; it != specifications.end(); it++) {
+            if (*it == aplCoreMetrics->getChosenSpec()) {
+                specifications.erase(it);
+                break;
+            }
+        }
+        if (it == specifications.end()) {
+            // Core returned specification that is not in list. Something went wrong. Prevent infinite loop.
+            break;
+        }
+    } while (!specifications.empty());
+
+    return root;
+}
+
 void AplCoreConnectionManager::onDocumentRendered(
         const std::chrono::steady_clock::time_point &renderTime,
         uint64_t complexityScore) {
@@ -895,6 +1429,8 @@ void AplCoreConnectionManager::handleMediaUpdate(const rapidjson::Value& update)
     const apl::MediaState mediaState(
         trackIndex, trackCount, currentTime, duration, state[PAUSED_KEY].GetBool(), state[ENDED_KEY].GetBool());
     component->updateMediaState(mediaState, fromEvent);
+    // The media state is part of the visual context of the video
+    m_visualContextValid = false;
 }
 
 void AplCoreConnectionManager::handleGraphicUpdate(const rapidjson::Value& update) {
@@ -1142,31 +1678,68 @@ unsigned int AplCoreConnectionManager::send(AplCoreViewhostMessage& message) {
     return seqno;
 }
 
+unsigned int AplCoreConnectionManager::sendFrame(AplCoreViewhostMessage& message) {
+    unsigned int seqno = ++m_SequenceNumber;
+    message.setSequenceNumber(seqno).get(m_frameOutput);
+    m_aplConfiguration->getAplOptions()->sendMessage(m_aplToken, m_frameOutput);
+    return seqno;
+}
+
 rapidjson::Document AplCoreConnectionManager::blockingSend(
     AplCoreViewhostMessage& message,
     const std::chrono::milliseconds& timeout) {
-    std::lock_guard<std::mutex> lock{m_blockingSendMutex};
-    m_replyPromise = std::promise<std::string>();
-    m_blockingSendReplyExpected = true;
-    m_replyExpectedSequenceNumber = send(message);
+    if (s_currentSpeculation) {
+        // The view host cannot answer before it has sent its build message, so the speculation has to be redone
+        s_currentSpeculation->needsViewhost = true;
+        return rapidjson::Document(rapidjson::kNullType);
+    }
+
+    // The request is registered before it is sent, so the reply cannot arrive before it is expected
+    unsigned int seqno = ++m_SequenceNumber;
+    std::future<rapidjson::Document> future;
+    {
+        std::lock_guard<std::mutex> lock{m_blockingRequestsMutex};
+        pruneBlockingRequests();
+        future = m_pendingBlockingRequests[seqno].get_future();
+        m_pendingBlockingRequestCount = m_pendingBlockingRequests.size();
+    }
+    m_aplConfiguration->getAplOptions()->sendMessage(m_aplToken, message.setSequenceNumber(seqno).get());
 
-    auto aplOptions = m_aplConfiguration->getAplOptions();
-    auto future = m_replyPromise.get_future();
     auto status = future.wait_for(timeout);
     if (status != std::future_status::ready) {
-        m_blockingSendReplyExpected = false;
-        // Under the situation that finish command destroys the renderer, there is no response.
-        aplOptions->logMessage(LogLevel::WARN, "blockingSendFailed", "Did not receive response");
-        return rapidjson::Document(rapidjson::kNullType);
+        std::unique_lock<std::mutex> lock{m_blockingRequestsMutex};
+        auto it = m_pendingBlockingRequests.find(seqno);
+        if (it != m_pendingBlockingRequests.end()) {
+            settleBlockingRequest(it, true);
+            lock.unlock();
+            // Under the situation that finish command destroys the renderer, there is no response.
+            m_aplConfiguration->getAplOptions()->logMessage(
+                LogLevel::WARN, "blockingSendFailed", "Did not receive response, seqno: " + std::to_string(seqno));
+            return rapidjson::Document(rapidjson::kNullType);
+        }
+        // The reply arrived while the request was timing out
     }
 
-    rapidjson::Document doc;
-    if (doc.Parse(future.get()).HasParseError()) {
-        aplOptions->logMessage(LogLevel::ERROR, "blockingSendFailed", "parsingFailed");
-        return rapidjson::Document(rapidjson::kNullType);
+    return future.get();
+}
+
+void AplCoreConnectionManager::pruneBlockingRequests() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = m_settledBlockingRequests.begin(); it != m_settledBlockingRequests.end();) {
+        if (now - it->second.settledTime > BLOCKING_REQUEST_RETENTION) {
+            it = m_settledBlockingRequests.erase(it);
+        } else {
+            it++;
+        }
     }
+    m_settledBlockingRequestCount = m_settledBlockingRequests.size();
+}
 
-    return doc;
+void AplCoreConnectionManager::settleBlockingRequest(PendingBlockingRequests::iterator request, bool timedOut) {
+    m_settledBlockingRequests[request->first] = SettledBlockingRequest{timedOut, std::chrono::steady_clock::now()};
+    m_pendingBlockingRequests.erase(request);
+    m_pendingBlockingRequestCount = m_pendingBlockingRequests.size();
+    m_settledBlockingRequestCount = m_settledBlockingRequests.size();
 }
 
 void AplCoreConnectionManager::sendError(const std::string& message) {
@@ -1222,6 +1795,7 @@ void AplCoreConnectionManager::processEvent(const apl::Event& event) {
         rapidjson::Document fetchRequestPayloadJson(rapidjson::kObjectType);
         auto& allocator = fetchRequestPayloadJson.GetAllocator();
         auto type = event.getValue(apl::EventProperty::kEventPropertyName);
+        m_dataSourcesUsed = true;
         auto payload = event.getValue(apl::EventProperty::kEventPropertyValue);
 
         apl::ObjectMap fetchRequest(payload.getMap());
@@ -1297,8 +1871,13 @@ bool AplCoreConnectionManager::addPendingEvent(unsigned int token, const apl::Ev
 }
 
 void AplCoreConnectionManager::processDirty(const std::set<apl::ComponentPtr>& dirty) {
-    std::map<std::string, rapidjson::Value> tempDirty;
-    auto msg = AplCoreViewhostMessage(DIRTY_KEY);
+    if (m_dirtyDeltaEnabled) {
+        processDirtyDelta(dirty);
+        return;
+    }
+
+    auto msg = AplCoreViewhostMessage(DIRTY_KEY, m_frameAllocator.get());
+    m_dirtyUpdates.clear();
 
     for (auto& component : dirty) {
         if (component->getDirty().count(apl::kPropertyNotifyChildrenChanged)) {
@@ -1313,49 +1892,138 @@ void AplCoreConnectionManager::processDirty(const std::set<apl::ComponentPtr>& d
                 auto newChildIndex = changed.at(i).get("index").asInt();
                 auto action = changed.at(i).get("action").asString();
                 if (action == "insert") {
-                    tempDirty[newChildId] = component->getChildAt(newChildIndex)->serialize(msg.alloc());
+                    m_dirtyUpdates.push_back(
+                        {newChildId,
+                         m_dirtyUpdates.size(),
+                         nullptr,
+                         component->getChildAt(newChildIndex)->serialize(msg.alloc())});
                 }
             }
         }
         if (component->getDirty().count(apl::kPropertyGraphic)) {
-            // for graphic component, apl-client need walk into graphicPtr to get dirty and dirtyPropertyKeys.
-            rapidjson::Value vectorGraphicComponent = component->serializeDirty(msg.alloc());
-            rapidjson::Value dirtyGraphicElement(rapidjson::kArrayType);
-            const apl::GraphicPtr graphic = component->getCalculated(apl::kPropertyGraphic).getGraphic();
-            for (auto& graphicDirty : graphic->getDirty()) {
-                rapidjson::Value serializedGraphicElement = graphicDirty->serialize(msg.alloc());
-                rapidjson::Value dirtyPropertyKeys(rapidjson::kArrayType);
-                for (auto& dirtyPropertyKey : graphicDirty->getDirtyProperties()) {
-                    dirtyPropertyKeys.PushBack(dirtyPropertyKey, msg.alloc());
-                }
-                serializedGraphicElement.AddMember("dirtyProperties", dirtyPropertyKeys, msg.alloc());
-                dirtyGraphicElement.PushBack(serializedGraphicElement, msg.alloc());
+            m_dirtyUpdates.push_back({component->getUniqueId(),
+                                      m_dirtyUpdates.size(),
+                                      nullptr,
+                                      serializeDirtyGraphic(component, msg.alloc())});
+        }
+        m_dirtyUpdates.push_back({component->getUniqueId(), m_dirtyUpdates.size(), component, rapidjson::Value()});
+    }
+
+    // Components in reverse unique id order, keeping the order updates were added in
+    std::sort(m_dirtyUpdates.begin(), m_dirtyUpdates.end(), [](const DirtyUpdate& a, const DirtyUpdate& b) {
+        return a.uid != b.uid ? a.uid > b.uid : a.order < b.order;
+    });
+
+    rapidjson::Value array(rapidjson::kArrayType);
+    for (size_t first = 0; first < m_dirtyUpdates.size();) {
+        // The last full update of a component replaces any other, otherwise its dirty properties are sent
+        DirtyUpdate* update = nullptr;
+        size_t next = first;
+        for (; next < m_dirtyUpdates.size() && m_dirtyUpdates[next].uid == m_dirtyUpdates[first].uid; next++) {
+            if (!update || !m_dirtyUpdates[next].component) {
+                update = &m_dirtyUpdates[next];
             }
-            if(vectorGraphicComponent.HasMember("graphic") && vectorGraphicComponent["graphic"].IsObject()) {
-                vectorGraphicComponent["graphic"].AddMember("dirty", dirtyGraphicElement, msg.alloc());
+        }
+        if (update->component) {
+            array.PushBack(update->component->serializeDirty(msg.alloc()), msg.alloc());
+        } else {
+            array.PushBack(update->serialized.Move(), msg.alloc());
+        }
+        first = next;
+    }
+    m_dirtyUpdates.clear();
+    sendFrame(msg.setPayload(std::move(array)));
+}
+
+void AplCoreConnectionManager::processDirtyDelta(const std::set<apl::ComponentPtr>& dirty) {
+    auto msg = AplCoreViewhostMessage(DIRTY_DELTA_KEY, m_frameAllocator.get());
+
+    for (auto& component : dirty) {
+        if (component->getDirty().count(apl::kPropertyNotifyChildrenChanged)) {
+            auto notify = component->getCalculated(apl::kPropertyNotifyChildrenChanged);
+            const auto& changed = notify.getArray();
+            // Inserted children are sent in full, removed ones no longer need their values tracked
+            for (size_t i = 0; i < changed.size(); i++) {
+                auto childId = changed.at(i).get("uid").asString();
+                auto action = changed.at(i).get("action").asString();
+                if (action == "insert") {
+                    auto childIndex = changed.at(i).get("index").asInt();
+                    m_dirtyEncoder.addSerialized(
+                        childId, component->getChildAt(childIndex)->serialize(msg.alloc()));
+                } else if (action == "remove") {
+                    m_dirtyEncoder.remove(childId);
+                }
             }
-            tempDirty[component->getUniqueId()] = vectorGraphicComponent;
         }
-        if (tempDirty.find(component->getUniqueId()) == tempDirty.end()) {
-            tempDirty.emplace(component->getUniqueId(), component->serializeDirty(msg.alloc()));
+        if (component->getDirty().count(apl::kPropertyGraphic)) {
+            m_dirtyEncoder.addSerialized(component->getUniqueId(), serializeDirtyGraphic(component, msg.alloc()));
         }
     }
 
-    rapidjson::Value array(rapidjson::kArrayType);
-    for (auto rit = tempDirty.rbegin(); rit != tempDirty.rend(); rit++) {
-        auto uid = rit->first;
-        auto& update = rit->second;
+    for (auto& component : dirty) {
+        auto uid = component->getUniqueId();
+        if (m_dirtyEncoder.contains(uid)) {
+            continue;
+        }
+        for (auto key : component->getDirty()) {
+            m_dirtyEncoder.addProperty(uid, key, component->getCalculated(key));
+        }
+    }
+
+    // Nothing to send if every dirty property already had the value known to the view host
+    if (m_dirtyEncoder.empty()) {
+        return;
+    }
+    sendFrame(msg.setPayload(m_dirtyEncoder.encodeJson(msg.alloc())));
+}
+
+void AplCoreConnectionManager::invalidateVisualContext(const std::set<apl::ComponentPtr>& dirty) {
+    if (!m_visualContextValid) {
+        return;
+    }
+    for (auto& component : dirty) {
+        for (auto key : component->getDirty()) {
+            if (VISUAL_CONTEXT_PROPERTIES.count(key)) {
+                m_visualContextValid = false;
+                return;
+            }
+        }
+    }
+}
 
-        array.PushBack(update.Move(), msg.alloc());
+rapidjson::Value AplCoreConnectionManager::serializeDirtyGraphic(
+    const apl::ComponentPtr& component,
+    rapidjson::Document::AllocatorType& allocator) {
+    // for graphic component, apl-client need walk into graphicPtr to get dirty and dirtyPropertyKeys.
+    rapidjson::Value vectorGraphicComponent = component->serializeDirty(allocator);
+    rapidjson::Value dirtyGraphicElement(rapidjson::kArrayType);
+    const apl::GraphicPtr graphic = component->getCalculated(apl::kPropertyGraphic).getGraphic();
+    for (auto& graphicDirty : graphic->getDirty()) {
+        rapidjson::Value serializedGraphicElement = graphicDirty->serialize(allocator);
+        rapidjson::Value dirtyPropertyKeys(rapidjson::kArrayType);
+        for (auto& dirtyPropertyKey : graphicDirty->getDirtyProperties()) {
+            dirtyPropertyKeys.PushBack(dirtyPropertyKey, allocator);
+        }
+        serializedGraphicElement.AddMember("dirtyProperties", dirtyPropertyKeys, allocator);
+        dirtyGraphicElement.PushBack(serializedGraphicElement, allocator);
     }
-    send(msg.setPayload(std::move(array)));
+    if(vectorGraphicComponent.HasMember("graphic") && vectorGraphicComponent["graphic"].IsObject()) {
+        vectorGraphicComponent["graphic"].AddMember("dirty", dirtyGraphicElement, allocator);
+    }
+    return vectorGraphicComponent;
 }
 
 void AplCoreConnectionManager::coreFrameUpdate() {
-    auto aplOptions = m_aplConfiguration->getAplOptions();
     auto now = getCurrentTime() - m_StartTime;
     m_Root->updateTime(now.count(), getCurrentTime().count());
-    m_Root->setLocalTimeAdjustment(aplOptions->getTimezoneOffset().count());
+
+    // The timezone rarely changes, so the view host is not asked for it every frame
+    auto refreshTime = std::chrono::steady_clock::now();
+    if (refreshTime - m_timezoneOffsetRefreshed >= TIMEZONE_REFRESH_INTERVAL) {
+        m_timezoneOffset = m_aplConfiguration->getAplOptions()->getTimezoneOffset();
+        m_timezoneOffsetRefreshed = refreshTime;
+    }
+    m_Root->setLocalTimeAdjustment(m_timezoneOffset.count());
 
     m_Root->clearPending();
 
@@ -1364,19 +2032,85 @@ void AplCoreConnectionManager::coreFrameUpdate() {
     }
 
     if (m_Root->isDirty()) {
-        processDirty(m_Root->getDirty());
+        auto outputCapacity = m_frameOutput.capacity();
+        auto updatesCapacity = m_dirtyUpdates.capacity();
+
+        const auto& dirty = m_Root->getDirty();
+        invalidateVisualContext(dirty);
+        processDirty(dirty);
         m_Root->clearDirty();
+
+        unsigned int growths = resetFrameAllocator() ? 1 : 0;
+        growths += m_frameOutput.capacity() != outputCapacity ? 1 : 0;
+        growths += m_dirtyUpdates.capacity() != updatesCapacity ? 1 : 0;
+        if (growths > 0) {
+            m_aplConfiguration->getMetricsRecorder()
+                ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, FRAME_BUFFER_GROWTHS)
+                ->incrementBy(growths);
+        }
     }
 
     handleScreenLock();
 }
 
+bool AplCoreConnectionManager::resetFrameAllocator() {
+    // The allocator only takes chunks from the heap once the buffer is full
+    bool overflowed = m_frameAllocator->Capacity() > m_frameBufferSize;
+    if (overflowed && m_frameBufferSize < MAX_FRAME_BUFFER_SIZE) {
+        m_frameBufferSize =
+            std::min(MAX_FRAME_BUFFER_SIZE, std::max(m_frameBufferSize * 2, m_frameAllocator->Capacity()));
+        m_frameAllocator.reset();
+        m_frameBuffer.reset(new char[m_frameBufferSize]);
+        m_frameAllocator.reset(new rapidjson::Document::AllocatorType(m_frameBuffer.get(), m_frameBufferSize));
+    } else {
+        m_frameAllocator->Clear();
+    }
+    return overflowed;
+}
+
 void AplCoreConnectionManager::onUpdateTick() {
     if (m_Root) {
+        const auto& allocationCounter = m_aplConfiguration->getAllocationCounter();
+        uint64_t allocations = allocationCounter ? allocationCounter() : 0;
+
         coreFrameUpdate();
         // Check regularly as something like timed-out fetch requests could come up.
-        checkAndSendDataSourceErrors();
+        if (m_dataSourcesUsed) {
+            checkAndSendDataSourceErrors();
+        }
+
+        // Nothing is reported for frames without allocations, as reporting allocates itself
+        if (allocationCounter) {
+            allocations = allocationCounter() - allocations;
+            if (allocations > 0) {
+                m_aplConfiguration->getMetricsRecorder()
+                    ->createCounter(Telemetry::AplMetricsRecorderInterface::CURRENT_DOCUMENT, FRAME_ALLOCATIONS)
+                    ->incrementBy(allocations);
+            }
+        }
+    }
+}
+
+std::chrono::milliseconds AplCoreConnectionManager::getNextUpdateDelay() {
+    if (!m_Root) {
+        return std::chrono::milliseconds::max();
+    }
+
+    if (m_Root->isDirty() || m_Root->hasEvent()) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    // Timers, animations and timeouts are all driven by the root context time manager
+    auto nextTime = m_Root->nextTime();
+    if (nextTime >= static_cast<apl::apl_time_t>(std::chrono::milliseconds::max().count())) {
+        return std::chrono::milliseconds::max();
+    }
+
+    auto now = static_cast<apl::apl_time_t>((getCurrentTime() - m_StartTime).count());
+    if (nextTime <= now) {
+        return std::chrono::milliseconds::zero();
     }
+    return std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(std::ceil(nextTime - now)));
 }
 
 apl::Rect AplCoreConnectionManager::convertJsonToScaledRect(const rapidjson::Value& jsonNode) {
@@ -1405,9 +2139,8 @@ void AplCoreConnectionManager::checkAndSendDataSourceErrors() {
         }
     }
 
-    auto errors = apl::Object(std::make_shared<apl::ObjectArray>(errorArray));
-
-    if (!errors.empty()) {
+    if (!errorArray.empty()) {
+        auto errors = apl::Object(std::make_shared<apl::ObjectArray>(std::move(errorArray)));
         auto errorEvent = std::make_shared<apl::ObjectMap>();
         errorEvent->emplace(PRESENTATION_TOKEN_KEY, m_aplToken);
         errorEvent->emplace(ERRORS_KEY, errors);
@@ -1454,9 +2187,13 @@ std::shared_ptr<AplCoreExtensionInterface> AplCoreConnectionManager::getExtensio
 }
 
 void AplCoreConnectionManager::reset() {
+    takeSpeculativeInflation();
     m_aplToken = "";
     m_Root.reset();
     m_Content.reset();
+    m_contentSource.reset();
+    m_dirtyEncoder.reset();
+    m_visualContextValid = false;
 }
 
 void AplCoreConnectionManager::handleIsCharacterValid(const rapidjson::Value& payload) {
@@ -1526,6 +2263,8 @@ void AplCoreConnectionManager::handleReInflate(const rapidjson::Value& payload)
         return;
     }
     m_Root->reinflate();
+    m_dirtyEncoder.reset();
+    m_visualContextValid = false;
 
     // update component hierarchy
     auto reply = AplCoreViewhostMessage(HIERARCHY_KEY);
@@ -1534,6 +2273,7 @@ void AplCoreConnectionManager::handleReInflate(const rapidjson::Value& payload)
 
 void AplCoreConnectionManager::handleReHierarchy(const rapidjson::Value& payload) {
     // send component hierarchy
+    m_dirtyEncoder.reset();
     auto reply = AplCoreViewhostMessage(REHIERARCHY_KEY);
     blockingSend(reply.setPayload(m_Root->topComponent()->serialize(reply.alloc())));
 }
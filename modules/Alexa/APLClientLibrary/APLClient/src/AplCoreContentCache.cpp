@@ -0,0 +1,88 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "APLClient/AplCoreContentCache.h"
+
+namespace APLClient {
+
+const size_t AplCoreContentCache::DEFAULT_MAX_ENTRIES = 10;
+
+/// The offset basis of the 64-bit FNV-1a hash.
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/// The prime of the 64-bit FNV-1a hash.
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+AplCoreContentCache::AplCoreContentCache(size_t maxEntries) : m_entries{maxEntries} {
+}
+
+std::shared_ptr<const rapidjson::Document> AplCoreContentCache::get(
+    size_t documentHash,
+    const std::string& rawDocument,
+    std::chrono::nanoseconds* creationTime) {
+    Entry entry;
+    if (!m_entries.get(documentHash, entry) || entry.size != rawDocument.size() ||
+        entry.checksum != checksum(rawDocument)) {
+        return nullptr;
+    }
+    if (creationTime) {
+        *creationTime = entry.creationTime;
+    }
+    return entry.document;
+}
+
+void AplCoreContentCache::put(
+    size_t documentHash,
+    const std::string& rawDocument,
+    std::shared_ptr<const rapidjson::Document> document,
+    std::chrono::nanoseconds creationTime) {
+    if (!document) {
+        return;
+    }
+    m_entries.put(documentHash, {rawDocument.size(), checksum(rawDocument), std::move(document), creationTime});
+}
+
+void AplCoreContentCache::clear() {
+    m_entries.clear();
+}
+
+size_t AplCoreContentCache::size() {
+    return m_entries.size();
+}
+
+std::shared_ptr<const rapidjson::Document> AplCoreContentCache::parse(const std::string& json) {
+    auto document = std::make_shared<rapidjson::Document>();
+    document->Parse(json.c_str());
+    if (document->HasParseError()) {
+        return nullptr;
+    }
+    return document;
+}
+
+rapidjson::Document AplCoreContentCache::copy(const rapidjson::Value& json) {
+    rapidjson::Document document;
+    document.CopyFrom(json, document.GetAllocator());
+    return document;
+}
+
+uint64_t AplCoreContentCache::checksum(const std::string& rawDocument) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (auto c : rawDocument) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+    }
+    return hash;
+}
+
+}  // namespace APLClient
@@ -0,0 +1,108 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "APLClient/AplCoreDirtyEncoder.h"
+
+namespace APLClient {
+
+/// The keys used in the "dirtyDelta" message.
+static const char NAMES_KEY[] = "names";
+static const char DIRTY_KEY[] = "dirty";
+
+void AplCoreDirtyEncoder::reset() {
+    m_frame.clear();
+    m_newNames.clear();
+    m_sentNames.clear();
+    m_sentValues.clear();
+}
+
+void AplCoreDirtyEncoder::addSerialized(const std::string& uid, rapidjson::Value&& update) {
+    auto& entry = m_frame[uid];
+    entry.serialized = std::move(update);
+    entry.properties.clear();
+    // The view host takes every value from the full update
+    m_sentValues.erase(uid);
+}
+
+void AplCoreDirtyEncoder::addProperty(const std::string& uid, int key, const apl::Object& value) {
+    auto entryIt = m_frame.find(uid);
+    if (entryIt != m_frame.end() && !entryIt->second.serialized.IsNull()) {
+        return;
+    }
+
+    // Children changes are events rather than state, so they are always sent
+    if (key != apl::kPropertyNotifyChildrenChanged) {
+        auto& sent = m_sentValues[uid];
+        auto it = sent.find(key);
+        if (it != sent.end() && it->second == value) {
+            return;
+        }
+        sent[key] = value;
+    }
+
+    if (m_sentNames.insert(key).second) {
+        m_newNames.push_back(key);
+    }
+    m_frame[uid].properties.emplace_back(key, value);
+}
+
+bool AplCoreDirtyEncoder::contains(const std::string& uid) const {
+    return m_frame.count(uid) > 0;
+}
+
+void AplCoreDirtyEncoder::remove(const std::string& uid) {
+    m_sentValues.erase(uid);
+}
+
+bool AplCoreDirtyEncoder::empty() const {
+    return m_frame.empty();
+}
+
+rapidjson::Value AplCoreDirtyEncoder::encodeJson(rapidjson::Document::AllocatorType& allocator) {
+    rapidjson::Value names(rapidjson::kObjectType);
+    for (auto key : m_newNames) {
+        names.AddMember(
+            rapidjson::Value(std::to_string(key).c_str(), allocator).Move(),
+            rapidjson::StringRef(apl::sComponentPropertyBimap.at(key).c_str()),
+            allocator);
+    }
+
+    rapidjson::Value dirty(rapidjson::kArrayType);
+    // Same order as the "dirty" message
+    for (auto it = m_frame.rbegin(); it != m_frame.rend(); it++) {
+        auto& entry = it->second;
+        if (!entry.serialized.IsNull()) {
+            dirty.PushBack(entry.serialized.Move(), allocator);
+        } else {
+            rapidjson::Value update(rapidjson::kArrayType);
+            update.PushBack(rapidjson::Value(it->first.c_str(), allocator).Move(), allocator);
+            for (auto& property : entry.properties) {
+                update.PushBack(property.first, allocator);
+                update.PushBack(property.second.serialize(allocator), allocator);
+            }
+            dirty.PushBack(update, allocator);
+        }
+    }
+
+    rapidjson::Value payload(rapidjson::kObjectType);
+    payload.AddMember(NAMES_KEY, names, allocator);
+    payload.AddMember(DIRTY_KEY, dirty, allocator);
+
+    m_frame.clear();
+    m_newNames.clear();
+    return payload;
+}
+
+}  // namespace APLClient
@@ -12,10 +12,18 @@
  * express or implied. See the License for the specific language governing
  * permissions and limitations under the License.
  */
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <rapidjson/document.h>
 
+#include "APLClient/AplCoreContentCache.h"
 #include "APLClient/AplCoreGuiRenderer.h"
 
 namespace APLClient {
@@ -25,10 +33,146 @@ namespace APLClient {
 static const char* ALEXA_IMPORT_PATH = "https://d2na8397m465mh.cloudfront.net/packages/%s/%s/document.json";
 /// The number of bytes read from the attachment with each read in the read loop.
 static const size_t CHUNK_SIZE(1024);
-/// Name of the mainTemplate parameter to which avs datasources binds to.
-static const std::string DEFAULT_PARAM_BINDING = "payload";
-/// Default string to attach to mainTemplate parameters.
-static const std::string DEFAULT_PARAM_VALUE = "{}";
+/// Metric counting the documents whose parsed content was found in the content cache.
+static const std::string CONTENT_CACHE_HIT = "APL-Web.Content.cacheHit";
+/// Metric counting the documents which had to be parsed.
+static const std::string CONTENT_CACHE_MISS = "APL-Web.Content.cacheMiss";
+/// Metric timing the parsing and content creation saved by finding the parsed document in the content cache.
+static const std::string CONTENT_CACHE_TIME_SAVED = "APL-Web.Content.cacheTimeSaved";
+
+namespace {
+
+/**
+ * Downloads the imports of a single document on a bounded pool of worker threads, handing each package back as soon
+ * as it arrives so that a slow import does not hold back the others.
+ */
+class ImportPipeline {
+public:
+    /// A completed download.
+    struct Result {
+        /// The import the package was requested for.
+        apl::ImportRequest request;
+        /// The package content, empty if the download failed.
+        std::string content;
+        /// The time the download completed.
+        std::chrono::steady_clock::time_point arrivalTime;
+    };
+
+    /**
+     * Constructor
+     *
+     * @param aplOptions The options used to download packages
+     * @param maxWorkers The maximum number of concurrent downloads
+     */
+    ImportPipeline(AplOptionsInterfacePtr aplOptions, size_t maxWorkers)
+            : m_aplOptions{aplOptions},
+              m_maxWorkers{std::max<size_t>(maxWorkers, 1)},
+              m_outstanding{0},
+              m_isShuttingDown{false} {
+    }
+
+    /**
+     * Destructor, abandons queued downloads and waits for the ones in progress to finish.
+     */
+    ~ImportPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isShuttingDown = true;
+            m_queue.clear();
+        }
+        m_queueChanged.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queues a package download, starting a new worker if all workers are busy and the pool is not full.
+     *
+     * @param request The import to download
+     * @param source The URL of the package
+     */
+    void request(const apl::ImportRequest& request, const std::string& source) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.emplace_back(request, source);
+        }
+        m_outstanding++;
+        if (m_workers.size() < m_maxWorkers && m_workers.size() < m_outstanding) {
+            m_workers.emplace_back(&ImportPipeline::run, this);
+        }
+        m_queueChanged.notify_one();
+    }
+
+    /**
+     * Waits for the next download to complete. Must only be called while @c outstanding is not zero.
+     *
+     * @return The completed download
+     */
+    Result next() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_resultsChanged.wait(lock, [this] { return !m_results.empty(); });
+        auto result = std::move(m_results.front());
+        m_results.pop_front();
+        m_outstanding--;
+        return result;
+    }
+
+    /**
+     * @return The number of requested downloads whose result has not been returned by @c next
+     */
+    size_t outstanding() const {
+        return m_outstanding;
+    }
+
+private:
+    /**
+     * Worker loop, downloading queued packages until the pipeline shuts down.
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_queueChanged.wait(lock, [this] { return m_isShuttingDown || !m_queue.empty(); });
+            if (m_isShuttingDown) {
+                return;
+            }
+            auto item = std::move(m_queue.front());
+            m_queue.pop_front();
+
+            lock.unlock();
+            auto content = m_aplOptions->downloadResource(item.second);
+            auto arrivalTime = std::chrono::steady_clock::now();
+            lock.lock();
+
+            m_results.push_back(Result{std::move(item.first), std::move(content), arrivalTime});
+            m_resultsChanged.notify_one();
+        }
+    }
+
+    AplOptionsInterfacePtr m_aplOptions;
+
+    const size_t m_maxWorkers;
+
+    /// Only accessed from the thread owning the pipeline.
+    size_t m_outstanding;
+
+    std::vector<std::thread> m_workers;
+
+    /// Guards the members below.
+    std::mutex m_mutex;
+
+    std::condition_variable m_queueChanged;
+
+    std::condition_variable m_resultsChanged;
+
+    std::deque<std::pair<apl::ImportRequest, std::string>> m_queue;
+
+    std::deque<Result> m_results;
+
+    bool m_isShuttingDown;
+};
+
+}  // namespace
 
 AplCoreGuiRenderer::AplCoreGuiRenderer(AplConfigurationPtr config, AplCoreConnectionManagerPtr aplCoreConnectionManager)
         : m_aplConfiguration{config},
@@ -71,7 +215,37 @@ void AplCoreGuiRenderer::renderDocument(
             Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT,
             "APL-Web.Content.error");
     tContentCreate->start();
-    auto content = apl::Content::create(std::move(document));
+
+    // Documents sent again with other data sources are created from the JSON parsed the first time. Their imports
+    // are left to the download manager, which knows how long each package may be reused.
+    auto contentCache = m_aplConfiguration->getContentCache();
+    auto documentHash = std::hash<std::string>()(document);
+    auto creationStart = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds cachedCreationTime;
+    auto parsedDocument = contentCache->get(documentHash, document, &cachedCreationTime);
+    bool cacheHit = parsedDocument != nullptr;
+    metricsRecorder
+        ->createCounter(
+            Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, cacheHit ? CONTENT_CACHE_HIT : CONTENT_CACHE_MISS)
+        ->increment();
+    if (!cacheHit) {
+        parsedDocument = AplCoreContentCache::parse(document);
+    }
+
+    // Documents which are not valid JSON are left to APL core to report
+    auto content = parsedDocument ? apl::Content::create(apl::JsonData(AplCoreContentCache::copy(*parsedDocument)))
+                                  : apl::Content::create(document);
+    auto creationTime =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - creationStart);
+    if (cacheHit) {
+        metricsRecorder
+            ->createTimer(Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, CONTENT_CACHE_TIME_SAVED)
+            ->elapsed(cachedCreationTime);
+    } else if (content) {
+        // Kept with the parsed document, as the time saved when the document is found in the cache again
+        contentCache->put(documentHash, document, parsedDocument, creationTime);
+    }
+
     if (!content) {
         aplOptions->logMessage(LogLevel::ERROR, "renderByAplCoreFailed", "Unable to create content");
 
@@ -80,67 +254,14 @@ void AplCoreGuiRenderer::renderDocument(
         return;
     }
 
-    std::map<std::string, apl::JsonData> params;
-    apl::JsonData sourcesData(data);
-    if (sourcesData.get().IsObject()) {
-        for (auto objIt = sourcesData.get().MemberBegin(); objIt != sourcesData.get().MemberEnd(); objIt++) {
-            params.emplace(objIt->name.GetString(), objIt->value);
-        }
-    }
-
-    for (size_t idx = 0; idx < content->getParameterCount(); idx++) {
-        auto parameterName = content->getParameterAt(idx);
-        if (parameterName == DEFAULT_PARAM_BINDING) {
-            content->addData(parameterName, data);
-        } else if (params.find(parameterName) != params.end()) {
-            content->addData(parameterName, params.at(parameterName).toString());
-        } else {
-            content->addData(parameterName, DEFAULT_PARAM_VALUE);
-        }
-    }
+    auto source = std::make_shared<AplDocumentSource>();
+    source->document = document;
+    source->data = data;
+    AplDocumentSource::bindData(content, data);
 
-    std::unordered_map<uint32_t, std::future<std::string>> packageContentByRequestId;
-    std::unordered_map<uint32_t, apl::ImportRequest> packageRequestByRequestId;
-    while (content->isWaiting() && !content->isError()) {
-        auto packages = content->getRequestedPackages();
-        cImports->incrementBy(packages.size());
-        unsigned int count = 0;
-        for (auto& package : packages) {
-            auto name = package.reference().name();
-            auto version = package.reference().version();
-            auto source = package.source();
-
-            if (source.empty()) {
-                char sourceBuffer[CHUNK_SIZE];
-                snprintf(sourceBuffer, CHUNK_SIZE, ALEXA_IMPORT_PATH, name.c_str(), version.c_str());
-                source = sourceBuffer;
-            }
-
-            auto packageContentPromise =
-                async(std::launch::async, &AplOptionsInterface::downloadResource, aplOptions, source);
-            packageContentByRequestId.insert(std::make_pair(package.getUniqueId(), std::move(packageContentPromise)));
-            packageRequestByRequestId.insert(std::make_pair(package.getUniqueId(), package));
-            count++;
-
-            // if we reach the maximum number of concurrent downloads or already go through all packages, wait for them
-            // to finish
-            if (count % aplOptions->getMaxNumberOfConcurrentDownloads() == 0 || packages.size() == count) {
-                for (auto& kvp : packageContentByRequestId) {
-                    auto packageContent = kvp.second.get();
-                    if (packageContent.empty()) {
-                        aplOptions->logMessage(
-                            LogLevel::ERROR, "renderByAplCoreFailed", "Could not be retrieve requested import");
-
-                        aplOptions->onRenderDocumentComplete(token, false, "Unresolved import");
-                        tContentCreate->fail();
-                        return;
-                    }
-                    content->addPackage(packageRequestByRequestId.at(kvp.first), packageContent);
-                }
-                packageContentByRequestId.clear();
-                packageRequestByRequestId.clear();
-            }
-        }
+    if (content->isWaiting() && !content->isError() && !resolveImports(content, token, *cImports, *source)) {
+        tContentCreate->fail();
+        return;
     }
 
     if (content->isError()) {
@@ -163,10 +284,71 @@ void AplCoreGuiRenderer::renderDocument(
          *  Only set the content if we haven't been cleared while building.
          */
         m_aplCoreConnectionManager->setSupportedViewports(supportedViewports);
-        m_aplCoreConnectionManager->setContent(content, token);
+        m_aplCoreConnectionManager->setContent(content, token, documentHash, source);
     }
 }
 
+bool AplCoreGuiRenderer::resolveImports(
+    const apl::ContentPtr& content,
+    const std::string& token,
+    Telemetry::AplCounterHandle& cImports,
+    AplDocumentSource& documentSource) {
+    auto metricsRecorder = m_aplConfiguration->getMetricsRecorder();
+    auto aplOptions = m_aplConfiguration->getAplOptions();
+
+    ImportPipeline pipeline(aplOptions, aplOptions->getMaxNumberOfConcurrentDownloads());
+    std::unordered_map<uint32_t, std::unique_ptr<Telemetry::AplTimerHandle>> importTimers;
+
+    auto requestPackages = [&]() {
+        auto packages = content->getRequestedPackages();
+        cImports.incrementBy(packages.size());
+        for (auto& package : packages) {
+            auto name = package.reference().name();
+            auto version = package.reference().version();
+            auto source = package.source();
+
+            if (source.empty()) {
+                char sourceBuffer[CHUNK_SIZE];
+                snprintf(sourceBuffer, CHUNK_SIZE, ALEXA_IMPORT_PATH, name.c_str(), version.c_str());
+                source = sourceBuffer;
+            }
+
+            auto tImport = metricsRecorder->createTimer(
+                    Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT,
+                    Telemetry::AplRenderingSegment::kImportResolution);
+            tImport->start();
+            importTimers[package.getUniqueId()] = std::move(tImport);
+            pipeline.request(package, source);
+        }
+    };
+
+    requestPackages();
+    while (pipeline.outstanding() > 0) {
+        auto result = pipeline.next();
+        auto tImport = std::move(importTimers[result.request.getUniqueId()]);
+        importTimers.erase(result.request.getUniqueId());
+
+        if (result.content.empty()) {
+            aplOptions->logMessage(LogLevel::ERROR, "renderByAplCoreFailed", "Could not be retrieve requested import");
+
+            aplOptions->onRenderDocumentComplete(token, false, "Unresolved import");
+            tImport->fail();
+            return false;
+        }
+        tImport->stoppedAt(result.arrivalTime);
+        documentSource.packages[AplDocumentSource::packageKey(result.request)] = result.content;
+
+        // Adding a package may reveal further imports, which start downloading while the others are still in flight.
+        content->addPackage(result.request, result.content);
+        if (content->isError()) {
+            break;
+        }
+        requestPackages();
+    }
+
+    return true;
+}
+
 void AplCoreGuiRenderer::clearDocument() {
     m_isDocumentCleared = true;
     m_aplCoreConnectionManager->reset();
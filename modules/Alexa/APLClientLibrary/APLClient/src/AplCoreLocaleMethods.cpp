@@ -15,6 +15,7 @@
 
 #include <climits>
 
+#include "APLClient/AplCoreCaseMapping.h"
 #include "APLClient/AplCoreViewhostMessage.h"
 #include "APLClient/AplCoreLocaleMethods.h"
 
@@ -23,11 +24,27 @@ namespace APLClient {
     static const char UPPER_KEY[] = "toUpperCase";
     static const char LOWER_KEY[] = "toLowerCase";
 
+    /// Metric counting the locale method calls served from the cache.
+    static const std::string LOCALE_METHOD_CACHE_HIT = "APL-Web.RootContext.localeMethodCacheHit";
+    /// Metric counting the locale method calls mapped in-process.
+    static const std::string LOCALE_METHOD_NATIVE = "APL-Web.RootContext.localeMethodNative";
+    /// Metric counting the locale method calls sent to the viewhost.
+    static const std::string LOCALE_METHOD_VIEWHOST = "APL-Web.RootContext.localeMethodViewhost";
+
     AplCoreLocaleMethods::AplCoreLocaleMethods(
             AplCoreConnectionManagerPtr aplCoreConnectionManager,
-            AplConfigurationPtr config)
+            AplConfigurationPtr config,
+            AplCoreLocaleMethodsCachePtr cache)
             : m_aplCoreConnectionManager{aplCoreConnectionManager},
-              m_aplConfiguration{config} {
+              m_aplConfiguration{config},
+              m_cache{cache} {
+        auto metricsRecorder = m_aplConfiguration->getMetricsRecorder();
+        m_cacheHitCounter = metricsRecorder->createCounter(
+                Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, LOCALE_METHOD_CACHE_HIT);
+        m_nativeCounter = metricsRecorder->createCounter(
+                Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, LOCALE_METHOD_NATIVE);
+        m_viewhostCounter = metricsRecorder->createCounter(
+                Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, LOCALE_METHOD_VIEWHOST);
     }
 
     std::string AplCoreLocaleMethods::toUpperCase(const std::string &value, const std::string &locale) {
@@ -37,7 +54,43 @@ namespace APLClient {
         return toCase(value, locale, LOWER_KEY);
     }
 
-    std::string AplCoreLocaleMethods::toCase(const std::string &value, const std::string &locale, const std::string methodName) {
+    std::string AplCoreLocaleMethods::toCase(
+            const std::string &value,
+            const std::string &locale,
+            const std::string &methodName) {
+        std::string result;
+        if (m_cache && m_cache->get(methodName, locale, value, result)) {
+            incrementCounter(m_cacheHitCounter.get());
+            return result;
+        }
+
+        if (AplCoreCaseMapping::toCase(value, locale, methodName == UPPER_KEY, result)) {
+            incrementCounter(m_nativeCounter.get());
+        } else if (toCaseInViewhost(value, locale, methodName, result)) {
+            incrementCounter(m_viewhostCounter.get());
+        } else {
+            return value;
+        }
+
+        if (m_cache) {
+            m_cache->put(methodName, locale, value, result);
+        }
+        return result;
+    }
+
+    void AplCoreLocaleMethods::incrementCounter(Telemetry::AplCounterHandle* counter) {
+        if (auto aplCoreConnectionManager = m_aplCoreConnectionManager.lock()) {
+            aplCoreConnectionManager->emitNotification([counter]() { counter->increment(); });
+        } else {
+            counter->increment();
+        }
+    }
+
+    bool AplCoreLocaleMethods::toCaseInViewhost(
+            const std::string &value,
+            const std::string &locale,
+            const std::string &methodName,
+            std::string &result) {
         auto aplOptions = m_aplConfiguration->getAplOptions();
         if (auto aplCoreConnectionManager = m_aplCoreConnectionManager.lock()) {
             auto msg = AplCoreViewhostMessage(LOCALE_METHODS_KEY);
@@ -49,18 +102,18 @@ namespace APLClient {
             payload.AddMember("locale", locale, alloc);
             msg.setPayload(std::move(payload));
 
-            auto result = aplCoreConnectionManager->blockingSend(msg);
+            auto reply = aplCoreConnectionManager->blockingSend(msg);
 
-            if (result.IsObject()) {
-                auto casedValue = result["payload"]["value"].GetString();
-                return casedValue;
+            if (reply.IsObject()) {
+                result = reply["payload"]["value"].GetString();
+                return true;
             }
 
             aplOptions->logMessage(LogLevel::WARN, __func__, "Didn't get a valid reply.  Returning unlocalized value.");
-            return value;
+            return false;
         } else {
             aplOptions->logMessage(LogLevel::WARN, __func__, "ConnectionManager does not exist. Returning unlocalized value");
-            return value;
+            return false;
         }
     }
 
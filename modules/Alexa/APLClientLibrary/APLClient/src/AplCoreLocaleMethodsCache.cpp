@@ -0,0 +1,72 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "APLClient/AplCoreLocaleMethodsCache.h"
+
+namespace APLClient {
+
+/// Separator between the fields of a cache key.
+static const char CACHE_KEY_SEPARATOR = '\x1f';
+
+const size_t AplCoreLocaleMethodsCache::DEFAULT_MAX_ENTRIES = 1000;
+
+const size_t AplCoreLocaleMethodsCache::MAX_VALUE_SIZE = 1024;
+
+AplCoreLocaleMethodsCache::AplCoreLocaleMethodsCache(size_t maxEntries) : m_results{maxEntries} {
+}
+
+bool AplCoreLocaleMethodsCache::get(
+    const std::string& method,
+    const std::string& locale,
+    const std::string& value,
+    std::string& result) {
+    if (value.size() > MAX_VALUE_SIZE) {
+        return false;
+    }
+    return m_results.get(buildKey(method, locale, value), result);
+}
+
+void AplCoreLocaleMethodsCache::put(
+    const std::string& method,
+    const std::string& locale,
+    const std::string& value,
+    const std::string& result) {
+    if (value.size() > MAX_VALUE_SIZE) {
+        return;
+    }
+    m_results.put(buildKey(method, locale, value), result);
+}
+
+void AplCoreLocaleMethodsCache::clear() {
+    m_results.clear();
+}
+
+size_t AplCoreLocaleMethodsCache::size() {
+    return m_results.size();
+}
+
+std::string AplCoreLocaleMethodsCache::buildKey(
+    const std::string& method,
+    const std::string& locale,
+    const std::string& value) {
+    std::string key;
+    key.reserve(method.size() + locale.size() + value.size() + 2);
+    key.append(method).push_back(CACHE_KEY_SEPARATOR);
+    key.append(locale).push_back(CACHE_KEY_SEPARATOR);
+    key.append(value);
+    return key;
+}
+
+}  // namespace APLClient
@@ -14,6 +14,10 @@
  */
 
 #include <climits>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <unordered_set>
 
 #include "APLClient/AplCoreViewhostMessage.h"
 #include "APLClient/AplCoreTextMeasurement.h"
@@ -23,16 +27,70 @@ namespace APLClient {
 /// The keys used in APL text measurement.
 static const char MEASURE_KEY[] = "measure";
 static const char BASELINE_KEY[] = "baseline";
+static const char MEASURE_BATCH_KEY[] = "measureBatch";
+
+/// The maximum number of components measured in a single batch.
+static const size_t MAX_MEASURE_BATCH_SIZE = 32;
+
+/// The text properties which affect the measured size of a Text component.
+static const std::vector<apl::PropertyKey> TEXT_MEASUREMENT_PROPERTIES = {
+    apl::kPropertyText,
+    apl::kPropertyFontFamily,
+    apl::kPropertyFontSize,
+    apl::kPropertyFontWeight,
+    apl::kPropertyFontStyle,
+    apl::kPropertyLineHeight,
+    apl::kPropertyLetterSpacing,
+    apl::kPropertyMaxLines,
+    apl::kPropertyLang,
+};
+
+/// Separator between the fields of a measurement cache key.
+static const char CACHE_KEY_SEPARATOR = '\x1f';
 
 AplCoreTextMeasurement::AplCoreTextMeasurement(
         AplCoreConnectionManagerPtr aplCoreConnectionManager,
-        AplConfigurationPtr config)
+        AplConfigurationPtr config,
+        AplCoreTextMeasurementCachePtr cache,
+        bool batchMeasurementEnabled)
     : m_aplCoreConnectionManager{aplCoreConnectionManager},
-      m_aplConfiguration{config} {
+      m_aplConfiguration{config},
+      m_cache{cache},
+      m_batchMeasurementEnabled{batchMeasurementEnabled} {
 
-    m_textMeasureCounter = m_aplConfiguration->getMetricsRecorder()->createCounter(
+    auto metricsRecorder = m_aplConfiguration->getMetricsRecorder();
+    m_textMeasureCounter = metricsRecorder->createCounter(
             Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT,
    Telemetry::AplRenderingSegment::kTextMeasure);
+    m_cacheHitCounter = metricsRecorder->createCounter(
+        Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, Telemetry::AplRenderingSegment::kTextMeasureCacheHit);
+    m_cacheMissCounter = metricsRecorder->createCounter(
+        Telemetry::AplMetricsRecorderInterface::LATEST_DOCUMENT, Telemetry::AplRenderingSegment::kTextMeasureCacheMiss);
+}
+
+std::string AplCoreTextMeasurement::buildCacheKey(
+        apl::Component* component,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        const AplCoreMetrics* aplCoreMetrics) {
+    if (!component || component->getType() != apl::kComponentTypeText) {
+        return "";
+    }
+
+    std::ostringstream key;
+    for (auto property : TEXT_MEASUREMENT_PROPERTIES) {
+        key << component->getCalculated(property).asString() << CACHE_KEY_SEPARATOR;
+    }
+
+    // Undefined dimensions are sent to the viewhost as INT_MAX, normalize them the same way. Dimensions are written
+    // with enough digits to round-trip, so that near-equal constraints do not share a measurement.
+    key << std::setprecision(std::numeric_limits<float>::max_digits10);
+    key << (std::isnan(width) ? INT_MAX : width) << CACHE_KEY_SEPARATOR << widthMode << CACHE_KEY_SEPARATOR
+        << (std::isnan(height) ? INT_MAX : height) << CACHE_KEY_SEPARATOR << heightMode << CACHE_KEY_SEPARATOR
+        << aplCoreMetrics->toViewhost(1.0f);
+    return key.str();
 }
 
 /**
@@ -70,53 +128,206 @@ apl::LayoutSize AplCoreTextMeasurement::measure(
         float height,
         apl::MeasureMode heightMode) {
     auto aplOptions = m_aplConfiguration->getAplOptions();
-    m_textMeasureCounter->increment();
     if (auto aplCoreConnectionManager = m_aplCoreConnectionManager.lock()) {
         /* Notify about the text measurement event */
-        aplOptions->onRenderingEvent(aplCoreConnectionManager->getAPLToken(), AplRenderingEvent::TEXT_MEASURE);
+        aplCoreConnectionManager->emitNotification([this]() {
+            m_textMeasureCounter->increment();
+            if (auto aplCoreConnectionManager = m_aplCoreConnectionManager.lock()) {
+                m_aplConfiguration->getAplOptions()->onRenderingEvent(
+                    aplCoreConnectionManager->getAPLToken(), AplRenderingEvent::TEXT_MEASURE);
+            }
+        });
+
+        auto aplCoreMetrics = aplCoreConnectionManager->aplCoreMetrics();
+
+        std::string cacheKey;
+        if (m_cache && aplCoreMetrics) {
+            cacheKey = buildCacheKey(component, width, widthMode, height, heightMode, aplCoreMetrics.get());
+        }
+        if (!cacheKey.empty()) {
+            apl::LayoutSize size;
+            if (m_cache->get(cacheKey, size)) {
+                aplCoreConnectionManager->emitNotification([this]() { m_cacheHitCounter->increment(); });
+                return size;
+            }
+            aplCoreConnectionManager->emitNotification([this]() { m_cacheMissCounter->increment(); });
+        }
+
+        // Prefer the in-process backend, if any, and only fall back to the viewhost if it declines the request
+        if (auto backend = m_aplConfiguration->getTextMeasurementBackend()) {
+            apl::LayoutSize size;
+            if (backend->measure(component, width, widthMode, height, heightMode, size)) {
+                if (!cacheKey.empty()) {
+                    m_cache->put(cacheKey, size);
+                }
+                return size;
+            }
+        }
+
+        if (m_batchMeasurementEnabled && !cacheKey.empty()) {
+            apl::LayoutSize size;
+            if (measureBatch(
+                    aplCoreConnectionManager, component, cacheKey, width, widthMode, height, heightMode, size)) {
+                return size;
+            }
+        }
 
         auto msg = AplCoreViewhostMessage(MEASURE_KEY);
         auto& alloc = msg.alloc();
 
-        auto aplCoreMetrics = aplCoreConnectionManager->aplCoreMetrics();
-
-        rapidjson::Value payload(component->serialize(alloc));
-        payload.AddMember("width", aplCoreMetrics->toViewhost(std::isnan(width) ? INT_MAX : width), alloc);
-        payload.AddMember("height", aplCoreMetrics->toViewhost(std::isnan(height) ? INT_MAX : height), alloc);
-        payload.AddMember("widthMode", widthMode, alloc);
-        payload.AddMember("heightMode", heightMode, alloc);
-        msg.setPayload(std::move(payload));
+        msg.setPayload(
+            buildMeasurePayload(component, width, widthMode, height, heightMode, aplCoreMetrics.get(), alloc));
 
         auto result = aplCoreConnectionManager->blockingSend(msg);
-        return this->GetValidMeasureResult(result, aplCoreMetrics.get());
+        bool isValid = false;
+        auto size = this->GetValidMeasureResult(result, aplCoreMetrics.get(), isValid);
+        // Never cache the generic size returned for a missing or invalid reply
+        if (isValid && !cacheKey.empty()) {
+            m_cache->put(cacheKey, size);
+        }
+        return size;
     } else {
+        m_textMeasureCounter->increment();
         aplOptions->logMessage(LogLevel::WARN, __func__, "ConnectionManager does not exist. Returning generic size.");
         return {0, 0};
     }
 }
 
-apl::LayoutSize AplCoreTextMeasurement::GetValidMeasureResult(rapidjson::Document& result, AplCoreMetrics* aplCoreMetrics) {
+rapidjson::Value AplCoreTextMeasurement::buildMeasurePayload(
+        apl::Component* component,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        AplCoreMetrics* aplCoreMetrics,
+        rapidjson::Document::AllocatorType& alloc) {
+    rapidjson::Value payload(component->serialize(alloc));
+    payload.AddMember("width", aplCoreMetrics->toViewhost(std::isnan(width) ? INT_MAX : width), alloc);
+    payload.AddMember("height", aplCoreMetrics->toViewhost(std::isnan(height) ? INT_MAX : height), alloc);
+    payload.AddMember("widthMode", widthMode, alloc);
+    payload.AddMember("heightMode", heightMode, alloc);
+    return payload;
+}
+
+/**
+ * Request the measurement of a Text component together with its uncached Text siblings, assuming that they will be
+ * measured under the same constraints (e.g. the items of a Sequence):
+ *
+ *     { "type": "measureBatch",
+ *       "payload": [ MEASURE_PAYLOAD, MEASURE_PAYLOAD, ... ] }
+ *
+ * The response contains one size per request, in the same order:
+ *
+ *     { "type": "measureBatch",
+ *       "payload": [ { "width": FLOAT, "height": FLOAT }, ... ] }
+ *
+ * All valid results are stored in the cache, so that the subsequent sibling measurements are served without a
+ * round-trip to the viewhost.
+ */
+bool AplCoreTextMeasurement::measureBatch(
+        const AplCoreConnectionManagerPtr& aplCoreConnectionManager,
+        apl::Component* component,
+        const std::string& cacheKey,
+        float width,
+        apl::MeasureMode widthMode,
+        float height,
+        apl::MeasureMode heightMode,
+        apl::LayoutSize& size) {
+    auto aplCoreMetrics = aplCoreConnectionManager->aplCoreMetrics();
+
+    std::vector<std::pair<apl::Component*, std::string>> batch{{component, cacheKey}};
+    std::unordered_set<std::string> batchKeys{cacheKey};
+    auto parent = component->getParent();
+    if (parent) {
+        for (size_t i = 0; i < parent->getChildCount() && batch.size() < MAX_MEASURE_BATCH_SIZE; i++) {
+            auto child = parent->getChildAt(i);
+            auto key = buildCacheKey(child.get(), width, widthMode, height, heightMode, aplCoreMetrics.get());
+            apl::LayoutSize cached;
+            if (key.empty() || batchKeys.count(key) || m_cache->get(key, cached)) {
+                continue;
+            }
+            batchKeys.insert(key);
+            batch.emplace_back(child.get(), key);
+        }
+    }
+
+    // Nothing to batch, use the regular protocol
+    if (batch.size() == 1) {
+        return false;
+    }
 
+    auto msg = AplCoreViewhostMessage(MEASURE_BATCH_KEY);
+    auto& alloc = msg.alloc();
+
+    rapidjson::Value payload(rapidjson::kArrayType);
+    for (auto& request : batch) {
+        payload.PushBack(
+            buildMeasurePayload(request.first, width, widthMode, height, heightMode, aplCoreMetrics.get(), alloc),
+            alloc);
+    }
+    msg.setPayload(std::move(payload));
+
+    auto result = aplCoreConnectionManager->blockingSend(msg);
     if (result.IsObject()) {
         auto payloadItr = result.FindMember("payload");
-            if (payloadItr != result.MemberEnd()) {
-            auto& payload = payloadItr->value;
-            auto widthItr = payload.FindMember("width");
-            auto heightItr = payload.FindMember("height");
-
-            if (widthItr != payload.MemberEnd() && heightItr != payload.MemberEnd()) {
-
-                auto& width = widthItr->value;
-                auto& height = heightItr->value;
-                if (width.IsNumber() && height.IsNumber()) {
-                    auto measuredWidth = aplCoreMetrics->toCore(width.GetFloat());
-                    auto measuredHeight = aplCoreMetrics->toCore(height.GetFloat());
-                    return {measuredWidth, measuredHeight};
+        if (payloadItr != result.MemberEnd() && payloadItr->value.IsArray() &&
+            payloadItr->value.Size() == batch.size()) {
+            auto& sizes = payloadItr->value;
+            for (rapidjson::SizeType i = 0; i < sizes.Size(); i++) {
+                apl::LayoutSize measured;
+                if (parseMeasurePayload(sizes[i], aplCoreMetrics.get(), measured)) {
+                    m_cache->put(batch[i].second, measured);
                 }
             }
         }
     }
 
+    if (!m_cache->get(cacheKey, size)) {
+        auto aplOptions = m_aplConfiguration->getAplOptions();
+        aplOptions->logMessage(LogLevel::WARN, __func__, "Didn't get a valid reply.  Returning generic size.");
+        size = {aplCoreMetrics->toCore(100), aplCoreMetrics->toCore(100)};
+    }
+    return true;
+}
+
+bool AplCoreTextMeasurement::parseMeasurePayload(
+        const rapidjson::Value& payload,
+        AplCoreMetrics* aplCoreMetrics,
+        apl::LayoutSize& size) {
+    if (!payload.IsObject()) {
+        return false;
+    }
+
+    auto widthItr = payload.FindMember("width");
+    auto heightItr = payload.FindMember("height");
+    if (widthItr == payload.MemberEnd() || heightItr == payload.MemberEnd()) {
+        return false;
+    }
+
+    auto& width = widthItr->value;
+    auto& height = heightItr->value;
+    if (!width.IsNumber() || !height.IsNumber()) {
+        return false;
+    }
+
+    size = {aplCoreMetrics->toCore(width.GetFloat()), aplCoreMetrics->toCore(height.GetFloat())};
+    return true;
+}
+
+apl::LayoutSize AplCoreTextMeasurement::GetValidMeasureResult(
+        rapidjson::Document& result,
+        AplCoreMetrics* aplCoreMetrics,
+        bool& isValid) {
+    isValid = false;
+    if (result.IsObject()) {
+        auto payloadItr = result.FindMember("payload");
+        apl::LayoutSize size;
+        if (payloadItr != result.MemberEnd() && parseMeasurePayload(payloadItr->value, aplCoreMetrics, size)) {
+            isValid = true;
+            return size;
+        }
+    }
+
     auto aplOptions = m_aplConfiguration->getAplOptions();
     aplOptions->logMessage(LogLevel::WARN, __func__, "Didn't get a valid reply.  Returning generic size.");
     return {aplCoreMetrics->toCore(100), aplCoreMetrics->toCore(100)};
@@ -142,6 +353,13 @@ apl::LayoutSize AplCoreTextMeasurement::GetValidMeasureResult(rapidjson::Documen
  * @return
  */
 float AplCoreTextMeasurement::baseline(apl::Component* component, float width, float height) {
+    if (auto backend = m_aplConfiguration->getTextMeasurementBackend()) {
+        float result;
+        if (backend->baseline(component, width, height, result)) {
+            return result;
+        }
+    }
+
     if (auto aplCoreConnectionManager = m_aplCoreConnectionManager.lock()) {
         auto msg = AplCoreViewhostMessage(BASELINE_KEY);
         auto& alloc = msg.alloc();
@@ -166,5 +384,7 @@ float AplCoreTextMeasurement::baseline(apl::Component* component, float width, f
             return 0;
         }
     }
+
+    return 0;
 }
 }  // namespace APLClient
@@ -0,0 +1,145 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <rapidjson/document.h>
+
+#include "APLClient/AplCoreContentCache.h"
+#include "APLClient/Extensions/AplDocumentState.h"
+
+namespace APLClient {
+namespace Extensions {
+
+/// Name of the mainTemplate parameter to which avs datasources binds to.
+static const std::string DEFAULT_PARAM_BINDING = "payload";
+/// Default string to attach to mainTemplate parameters.
+static const std::string DEFAULT_PARAM_VALUE = "{}";
+
+void AplDocumentSource::bindData(const apl::ContentPtr& content, const std::string& data) {
+    // The data sources are parsed once, and parameters are bound to copies of the parsed values
+    rapidjson::Document sourcesData;
+    sourcesData.Parse(data.c_str());
+
+    for (size_t idx = 0; idx < content->getParameterCount(); idx++) {
+        auto parameterName = content->getParameterAt(idx);
+        if (parameterName == DEFAULT_PARAM_BINDING) {
+            if (sourcesData.HasParseError()) {
+                // Let APL core report the invalid data
+                content->addData(parameterName, data);
+            } else {
+                content->addData(parameterName, apl::JsonData(AplCoreContentCache::copy(sourcesData)));
+            }
+            continue;
+        }
+
+        if (sourcesData.IsObject() && sourcesData.HasMember(parameterName.c_str())) {
+            const auto& source = sourcesData[parameterName.c_str()];
+            content->addData(parameterName, apl::JsonData(AplCoreContentCache::copy(source)));
+        } else {
+            content->addData(parameterName, DEFAULT_PARAM_VALUE);
+        }
+    }
+}
+
+std::string AplDocumentSource::packageKey(const apl::ImportRequest& request) {
+    return request.reference().name() + ":" + request.reference().version();
+}
+
+apl::ContentPtr AplDocumentSource::createContent() const {
+    auto content = apl::Content::create(document);
+    if (!content) {
+        return nullptr;
+    }
+
+    bindData(content, data);
+
+    // Every package was downloaded when the document was first rendered
+    auto requests = content->getRequestedPackages();
+    while (!requests.empty() && !content->isError()) {
+        for (const auto& request : requests) {
+            auto package = packages.find(packageKey(request));
+            if (package == packages.end()) {
+                return nullptr;
+            }
+            content->addPackage(request, package->second);
+        }
+        requests = content->getRequestedPackages();
+    }
+
+    return content->isReady() ? content : nullptr;
+}
+
+void AplDocumentState::hibernate() {
+    if (!rootContext || !source) {
+        return;
+    }
+
+    componentStates.clear();
+    captureComponentStates(rootContext->topComponent());
+    rootContext.reset();
+    estimatedSize = 0;
+}
+
+void AplDocumentState::restoreComponentStates(const apl::RootContextPtr& root) const {
+    if (!root) {
+        return;
+    }
+
+    for (const auto& componentState : componentStates) {
+        if (auto component = root->findComponentById(componentState.id)) {
+            component->update(componentState.type, componentState.value);
+        }
+    }
+}
+
+void AplDocumentState::captureComponentStates(const apl::ComponentPtr& component) {
+    if (!component) {
+        return;
+    }
+
+    // Components without an id given by the document can't be found again once the document is inflated again
+    if (!component->getId().empty()) {
+        switch (component->getType()) {
+            case apl::kComponentTypeScrollView:
+            case apl::kComponentTypeSequence:
+            case apl::kComponentTypeGridSequence: {
+                auto position = component->getCalculated(apl::kPropertyScrollPosition);
+                if (position.isAbsoluteDimension() && position.getAbsoluteDimension() != 0) {
+                    componentStates.push_back(
+                        {component->getId(),
+                         apl::kUpdateScrollPosition,
+                         static_cast<float>(position.getAbsoluteDimension())});
+                }
+                break;
+            }
+            case apl::kComponentTypePager: {
+                auto page = component->getCalculated(apl::kPropertyCurrentPage).asInt();
+                if (page != 0) {
+                    componentStates.push_back(
+                        {component->getId(), apl::kUpdatePagerPosition, static_cast<float>(page)});
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    for (size_t i = 0; i < component->getChildCount(); i++) {
+        captureComponentStates(component->getChildAt(i));
+    }
+}
+
+}  // namespace Extensions
+}  // namespace APLClient
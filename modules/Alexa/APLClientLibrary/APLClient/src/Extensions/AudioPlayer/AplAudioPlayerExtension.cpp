@@ -13,6 +13,7 @@
  * permissions and limitations under the License.
  */
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include "APLClient/Extensions/AudioPlayer/AplAudioPlayerExtension.h"
@@ -53,6 +54,9 @@ static const std::vector<std::string> TOGGLE_COMMAND_NAMES = {
     "repeat"
 };
 
+/// The player activity during which the audioItem offset advances.
+static const std::string PLAYER_ACTIVITY_PLAYING = "PLAYING";
+
 /// List of accepted player activity.
 static const std::vector<std::string> PLAYER_ACTIVITY = {
     "PLAYING",
@@ -62,12 +66,17 @@ static const std::vector<std::string> PLAYER_ACTIVITY = {
 };
 
 AplAudioPlayerExtension::AplAudioPlayerExtension(std::shared_ptr<AplAudioPlayerExtensionObserverInterface> observer) :
-        m_observer{std::move(observer)} {
+        m_observer{std::move(observer)},
+        m_progressGranularity{std::chrono::milliseconds::zero()},
+        m_playing{false},
+        m_reportedOffset{0},
+        m_reportedTime{std::chrono::steady_clock::now()},
+        m_publishedOffset{0} {
     m_playbackStateName = "";
     m_activeSkillId = "";
     m_playbackState = apl::LiveMap::create();
     m_playbackState->set(PROPERTY_PLAYER_ACTIVITY, "STOPPED");
-    m_playbackState->set(PROPERTY_OFFSET, 0);
+    m_playbackState->set(PROPERTY_OFFSET, m_publishedOffset);
 }
 
 std::string AplAudioPlayerExtension::getUri() {
@@ -248,8 +257,13 @@ void AplAudioPlayerExtension::updatePlayerActivity(const std::string& state, int
         return;
     }
 
+    m_playing = PLAYER_ACTIVITY_PLAYING == state;
+    m_reportedOffset = offset;
+    m_reportedTime = std::chrono::steady_clock::now();
+
+    // Activity changes publish the exact offset, so that a paused or stopped document shows where playback ended
     m_playbackState->set(PROPERTY_PLAYER_ACTIVITY, state);
-    m_playbackState->set(PROPERTY_OFFSET, offset);
+    publishOffset(offset);
 
     if (!m_eventHandler) {
         logMessage(apl::LogLevel::kWarn, TAG, __func__, "No Event Handler");
@@ -263,6 +277,42 @@ void AplAudioPlayerExtension::updatePlayerActivity(const std::string& state, int
 }
 
 void AplAudioPlayerExtension::updatePlaybackProgress(int offset) {
+    m_reportedOffset = offset;
+    m_reportedTime = std::chrono::steady_clock::now();
+
+    // Progress only moves forward, so that a late or jittery report does not make the document step back. Player
+    // activity changes publish the exact offset, which may be lower.
+    auto granularity = static_cast<int>(m_progressGranularity.count());
+    publishOffset(std::max(m_publishedOffset, granularity > 0 ? offset - offset % granularity : offset));
+}
+
+void AplAudioPlayerExtension::setPlaybackProgressGranularity(std::chrono::milliseconds granularity) {
+    m_progressGranularity = std::max(granularity, std::chrono::milliseconds::zero());
+}
+
+std::chrono::milliseconds AplAudioPlayerExtension::getNextPlaybackProgressDelay() const {
+    if (!m_playing) {
+        return std::chrono::milliseconds::max();
+    }
+
+    auto granularity = static_cast<int>(m_progressGranularity.count());
+    if (granularity <= 0) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    // The offset advances in real time while playing
+    auto elapsed = std::chrono::steady_clock::now() - m_reportedTime;
+    auto nextStep = std::chrono::milliseconds(m_reportedOffset - m_reportedOffset % granularity + granularity);
+    auto remaining = nextStep - std::chrono::milliseconds(m_reportedOffset) -
+                     std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    return std::max(remaining, std::chrono::milliseconds::zero());
+}
+
+void AplAudioPlayerExtension::publishOffset(int offset) {
+    if (offset == m_publishedOffset) {
+        return;
+    }
+    m_publishedOffset = offset;
     m_playbackState->set(PROPERTY_OFFSET, offset);
 }
 
@@ -57,6 +57,28 @@ void AplBackstackExtension::clearActiveDocumentId() {
     m_activeDocumentId = "";
 }
 
+void AplBackstackExtension::setCacheLimits(size_t maxLiveDocuments, size_t maxLiveBytes) {
+    m_backstack.m_maxLiveDocuments = maxLiveDocuments;
+    m_backstack.m_maxLiveBytes = maxLiveBytes;
+    m_backstack.enforceLimits();
+}
+
+bool AplBackstackExtension::needsDocumentStateSize() const {
+    return m_backstack.m_maxLiveBytes != 0;
+}
+
+unsigned int AplBackstackExtension::getDocumentCount() const {
+    return m_backstack.length();
+}
+
+unsigned int AplBackstackExtension::getHibernatedDocumentCount() const {
+    return m_backstack.hibernatedLength();
+}
+
+size_t AplBackstackExtension::getLiveDocumentBytes() const {
+    return m_backstack.liveBytes();
+}
+
 void AplBackstackExtension::reset() {
     clearActiveDocumentId();
     m_backstack.clear();
@@ -26,8 +26,11 @@ namespace Telemetry {
 static const std::map<AplRenderingSegment, std::string> sSegmentNames = {
     {AplRenderingSegment::kRenderDocument, "SmartScreenSDK.renderDocument"},
     {AplRenderingSegment::kContentCreation, "APL-Web.Content.create"},
+    {AplRenderingSegment::kImportResolution, "APL-Web.Content.importTime"},
     {AplRenderingSegment::kRootContextInflation, "APL.rootContext.inflate"},
-    {AplRenderingSegment::kTextMeasure, "APL-Web.RootContext.measureCount"}
+    {AplRenderingSegment::kTextMeasure, "APL-Web.RootContext.measureCount"},
+    {AplRenderingSegment::kTextMeasureCacheHit, "APL-Web.RootContext.measureCacheHit"},
+    {AplRenderingSegment::kTextMeasureCacheMiss, "APL-Web.RootContext.measureCacheMiss"}
 };
 
 enum class MetricType { TIMER, COUNTER };
@@ -65,6 +68,17 @@ public:
         return false;
     }
 
+    bool set(uint64_t value) override {
+        if (auto recorder = mRecorder.lock()) {
+            return recorder->updateCounter(mDocument, mId, [&](MetricRecord& record) {
+                record.counterOrFailures = value;
+                record.hasValue = true;
+                return true;
+            });
+        }
+        return false;
+    }
+
 private:
     std::weak_ptr<AplMetricsRecorder> mRecorder;
     DocumentId mDocument;
@@ -25,6 +25,18 @@ DownloadMetricsEmitter::DownloadMetricsEmitter(AplMetricsRecorderInterfacePtr me
     m_cacheCounter = m_metricsRecorder->createCounter(
             AplMetricsRecorderInterface::LATEST_DOCUMENT,
             "SmartScreenSDK.ImportDocumentCacheHit");
+    m_cacheMissCounter = m_metricsRecorder->createCounter(
+            AplMetricsRecorderInterface::LATEST_DOCUMENT,
+            "SmartScreenSDK.ImportDocumentCacheMiss");
+    m_coalescedCounter = m_metricsRecorder->createCounter(
+            AplMetricsRecorderInterface::LATEST_DOCUMENT,
+            "SmartScreenSDK.ImportDocumentCoalesced");
+    m_evictionCounter = m_metricsRecorder->createCounter(
+            AplMetricsRecorderInterface::LATEST_DOCUMENT,
+            "SmartScreenSDK.ImportDocumentCacheEviction", false);
+    m_evictedSizeCounter = m_metricsRecorder->createCounter(
+            AplMetricsRecorderInterface::LATEST_DOCUMENT,
+            "SmartScreenSDK.ImportDocumentCacheEvictedSize", false);
     m_sizeCounter = m_metricsRecorder->createCounter(
             AplMetricsRecorderInterface::LATEST_DOCUMENT,
             "SmartScreenSDK.ImportDocumentSize", false);
@@ -53,6 +65,19 @@ void DownloadMetricsEmitter::onCacheHit() {
     m_cacheCounter->increment();
 }
 
+void DownloadMetricsEmitter::onDownloadCoalesced() {
+    m_coalescedCounter->increment();
+}
+
+void DownloadMetricsEmitter::onCacheMiss() {
+    m_cacheMissCounter->increment();
+}
+
+void DownloadMetricsEmitter::onCacheEviction(std::uint64_t numberOfBytes) {
+    m_evictionCounter->increment();
+    m_evictedSizeCounter->incrementBy(numberOfBytes);
+}
+
 void DownloadMetricsEmitter::onBytesRead(std::uint64_t numberOfBytes)  {
     m_sizeCounter->incrementBy(numberOfBytes);
 }
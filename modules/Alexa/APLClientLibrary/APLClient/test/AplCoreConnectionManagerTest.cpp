@@ -15,11 +15,18 @@
 
 #include "APLClient/AplCoreConnectionManager.h"
 #include "MockAplOptionsInterface.h"
+#include "MockAplTextMeasurementBackend.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
 #include <thread>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <APLClient/AplCoreTextMeasurement.h>
+#include <APLClient/Telemetry/AplMetricsRecorder.h>
 #include <APLClient/Telemetry/NullAplMetricsRecorder.h>
 
 namespace APLClient {
@@ -247,6 +254,51 @@ static const std::string BUILD_PAYLOAD =
     "  }"
     "}";
 
+static const std::string RESIZED_BUILD_PAYLOAD =
+    "{"
+    "  \"type\":\"build\","
+    "  \"payload\":"
+    "  {"
+    "    \"agentName\":\"SmartScreenSDK\","
+    "    \"agentVersion\":\"1.0\","
+    "    \"allowOpenUrl\":false,"
+    "    \"disallowVideo\":false,"
+    "    \"animationQuality\":\"normal\","
+    "    \"width\":1280,\"height\":800,"
+    "    \"shape\":\"RECTANGLE\","
+    "    \"dpi\":160,"
+    "    \"mode\":\"HUB\""
+    "  }"
+    "}";
+
+static const std::string SPECULATIVE_DOCUMENT =
+    "{"
+    "  \"type\": \"APL\","
+    "  \"version\": \"1.5\","
+    "  \"mainTemplate\": {"
+    "    \"item\": {"
+    "      \"type\": \"Text\","
+    "      \"text\": \"Inflated before the build message\""
+    "    }"
+    "  }"
+    "}";
+
+static const std::string NARROW_VIEWPORT_DOCUMENT =
+    "{"
+    "  \"type\": \"APL\","
+    "  \"version\": \"1.5\","
+    "  \"mainTemplate\": {"
+    "    \"items\": ["
+    "      {"
+    "        \"when\": \"${viewport.width < 1000}\","
+    "        \"type\": \"Frame\","
+    "        \"width\": \"100%\","
+    "        \"height\": \"100%\""
+    "      }"
+    "    ]"
+    "  }"
+    "}";
+
 static const std::string EVENT_PAYLOAD =
     "{"
     "  \"type\": \"APL\","
@@ -347,6 +399,31 @@ static const std::string APL_COMMAND_EXECUTION{"APLCommandExecution"};
 
 static const std::string SEQNO_KEY = "seqno";
 
+/// Number of messages replayed by the parse benchmark.
+static const int PARSE_BENCHMARK_MESSAGES = 500;
+
+/// Metric counting the view host messages parsed from text by the connection manager.
+static const std::string MESSAGE_PARSES = "APL-Web.RootContext.messageParses";
+
+/**
+ * A metrics sink summing the counters reported to it.
+ */
+class CounterSink : public Telemetry::AplMetricsSinkInterface {
+public:
+    void reportTimer(
+        const std::map<std::string, std::string>& metadata,
+        const std::string& name,
+        const std::chrono::nanoseconds& value) override {
+    }
+
+    void reportCounter(const std::map<std::string, std::string>& metadata, const std::string& name, uint64_t value)
+        override {
+        counters[name] += value;
+    }
+
+    std::map<std::string, uint64_t> counters;
+};
+
 /// Test harness for @c AplCoreConnectionManagerTest class.
 class AplCoreConnectionManagerTest : public ::testing::Test {
 public:
@@ -386,8 +463,11 @@ void AplCoreConnectionManagerTest::BuildDocument(
     const std::string data,
     const std::string viewport) {
     auto content = apl::Content::create(document);
+    auto source = std::make_shared<AplDocumentSource>();
+    source->document = document;
+    source->data = data;
     m_aplCoreConnectionManager->setSupportedViewports(viewport);
-    m_aplCoreConnectionManager->setContent(content, "");
+    m_aplCoreConnectionManager->setContent(content, "", 0, source);
     // this is required in order to set content state to ready
     content->addData(DEFAULT_PARAM_BINDING, data);
     m_aplCoreConnectionManager->handleMessage(BUILD_PAYLOAD);
@@ -411,10 +491,27 @@ TEST_F(AplCoreConnectionManagerTest, SetSupportedViewPortsSuccess) {
     m_aplCoreConnectionManager->setSupportedViewports(VIEWPORT);
 }
 
+/**
+ * Tests that no update tick is requested while no document is rendered.
+ */
+TEST_F(AplCoreConnectionManagerTest, NoUpdateDelayWithoutDocument) {
+    ASSERT_EQ(std::chrono::milliseconds::max(), m_aplCoreConnectionManager->getNextUpdateDelay());
+}
+
+/**
+ * Tests that an update tick is not requested after a document has settled.
+ */
+TEST_F(AplCoreConnectionManagerTest, UpdateDelayAfterBuild) {
+    BuildDocument(DOCUMENT_WITH_IDLETIMEOUT, DATA, VIEWPORT);
+    m_aplCoreConnectionManager->onUpdateTick();
+
+    ASSERT_GT(m_aplCoreConnectionManager->getNextUpdateDelay(), std::chrono::milliseconds::zero());
+}
+
 /**
  * Tests BlockingSend function by setting a promise when sendMessage function
  * is called. If future is set correctly, shouldHandleMessage function should called.
- * shouldHandleMessage function sets m_replyPromise in the blockingSend function
+ * shouldHandleMessage function answers the request of the blockingSend function
  */
 TEST_F(AplCoreConnectionManagerTest, BlockingSendSuccess) {
     std::promise<bool> promise = std::promise<bool>();
@@ -449,6 +546,487 @@ TEST_F(AplCoreConnectionManagerTest, BlockingSendSuccess) {
     ASSERT_TRUE(result.IsObject());
 }
 
+/**
+ * Tests that a reply to a blocking send handed over parsed in place stays valid once its buffer is reused.
+ */
+TEST_F(AplCoreConnectionManagerTest, BlockingSendWithParsedReply) {
+    std::promise<void> sent;
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, _)).Times(Exactly(1)).WillOnce(InvokeWithoutArgs([&sent] {
+        sent.set_value();
+    }));
+
+    auto measureMsg = AplCoreViewhostMessage("measure");
+    rapidjson::Document result;
+    std::thread thread([this, &measureMsg, &result] {
+        result = m_aplCoreConnectionManager->blockingSend(measureMsg, std::chrono::milliseconds(3000));
+    });
+    ASSERT_EQ(std::future_status::ready, sent.get_future().wait_for(std::chrono::milliseconds(500)));
+
+    std::string buffer = "{\"" + SEQNO_KEY + "\":1,\"payload\":\"reply\"}";
+    rapidjson::Document reply;
+    reply.ParseInsitu(&buffer[0]);
+    ASSERT_FALSE(m_aplCoreConnectionManager->shouldHandleMessage(reply));
+    buffer.assign(buffer.size(), ' ');
+
+    thread.join();
+
+    ASSERT_TRUE(result.IsObject());
+    ASSERT_STREQ("reply", result["payload"].GetString());
+}
+
+/**
+ * Tests that several blocking sends can wait at the same time and each gets the reply to its own request, whatever
+ * order the replies arrive in.
+ */
+TEST_F(AplCoreConnectionManagerTest, ConcurrentBlockingSends) {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<unsigned int> seqnos;
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, _))
+        .Times(Exactly(2))
+        .WillRepeatedly(Invoke([&](const std::string&, const std::string& message) {
+            rapidjson::Document document;
+            document.Parse(message.c_str());
+            std::lock_guard<std::mutex> lock(mutex);
+            seqnos.push_back(document[SEQNO_KEY.c_str()].GetUint());
+            condition.notify_all();
+        }));
+
+    std::vector<rapidjson::Document> results(2);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2; i++) {
+        threads.emplace_back([this, i, &results] {
+            auto msg = AplCoreViewhostMessage("measure");
+            results[i] = m_aplCoreConnectionManager->blockingSend(msg, std::chrono::milliseconds(3000));
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(condition.wait_for(lock, std::chrono::milliseconds(500), [&seqnos] { return seqnos.size() == 2; }));
+    }
+    for (auto it = seqnos.rbegin(); it != seqnos.rend(); it++) {
+        auto seqno = std::to_string(*it);
+        ASSERT_FALSE(m_aplCoreConnectionManager->shouldHandleMessage(
+            "{\"" + SEQNO_KEY + "\":" + seqno + ",\"payload\":" + seqno + "}"));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& result : results) {
+        ASSERT_TRUE(result.IsObject());
+        ASSERT_EQ(result[SEQNO_KEY.c_str()].GetUint(), result["payload"].GetUint());
+    }
+}
+
+/**
+ * Tests that replies to requests which timed out or were already answered are counted and not handled.
+ */
+TEST_F(AplCoreConnectionManagerTest, LateAndDuplicateRepliesAreCounted) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    recorder->onRenderingStarted(recorder->registerDocument());
+
+    auto timedOut = AplCoreViewhostMessage("measure");
+    ASSERT_TRUE(m_aplCoreConnectionManager->blockingSend(timedOut, std::chrono::milliseconds(1)).IsNull());
+    rapidjson::Document lateReply;
+    lateReply.Parse(("{\"" + SEQNO_KEY + "\":1}").c_str());
+    ASSERT_FALSE(m_aplCoreConnectionManager->shouldHandleMessage(lateReply));
+
+    std::promise<void> sent;
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, MatchOutMessage("\"seqno\":2", "")))
+        .WillOnce(InvokeWithoutArgs([&sent] { sent.set_value(); }));
+    std::thread thread([this] {
+        auto answered = AplCoreViewhostMessage("measure");
+        m_aplCoreConnectionManager->blockingSend(answered, std::chrono::milliseconds(3000));
+    });
+    ASSERT_EQ(std::future_status::ready, sent.get_future().wait_for(std::chrono::milliseconds(500)));
+    rapidjson::Document reply;
+    reply.Parse(("{\"" + SEQNO_KEY + "\":2}").c_str());
+    ASSERT_FALSE(m_aplCoreConnectionManager->shouldHandleMessage(reply));
+    thread.join();
+    ASSERT_FALSE(m_aplCoreConnectionManager->shouldHandleMessage(reply));
+
+    // Other messages are still handled
+    rapidjson::Document other;
+    other.Parse(("{\"" + SEQNO_KEY + "\":3}").c_str());
+    ASSERT_TRUE(m_aplCoreConnectionManager->shouldHandleMessage(other));
+
+    recorder->flush();
+    ASSERT_EQ(1u, sink->counters["APL-Web.RootContext.lateViewhostReplies"]);
+    ASSERT_EQ(1u, sink->counters["APL-Web.RootContext.duplicateViewhostReplies"]);
+}
+
+/**
+ * Tests that text messages are not parsed for replies once no request is pending, and that a late reply passed on to
+ * handleMessage is still recognized and dropped.
+ */
+TEST_F(AplCoreConnectionManagerTest, SettledRequestsDoNotParseMessages) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    recorder->onRenderingStarted(recorder->registerDocument());
+
+    auto timedOut = AplCoreViewhostMessage("measure");
+    ASSERT_TRUE(m_aplCoreConnectionManager->blockingSend(timedOut, std::chrono::milliseconds(1)).IsNull());
+
+    const std::string lateReply = "{\"" + SEQNO_KEY + "\":1,\"type\":\"measure\",\"payload\":{}}";
+    ASSERT_TRUE(m_aplCoreConnectionManager->shouldHandleMessage(lateReply));
+    recorder->flush();
+    ASSERT_EQ(0u, sink->counters[MESSAGE_PARSES]);
+
+    EXPECT_CALL(*m_mockAplOptions, logMessage(LogLevel::ERROR, _, _)).Times(0);
+    m_aplCoreConnectionManager->handleMessage(lateReply);
+    recorder->flush();
+    ASSERT_EQ(1u, sink->counters["APL-Web.RootContext.lateViewhostReplies"]);
+}
+
+/**
+ * Tests that the visual context is serialized again only once the document changed a property it reports.
+ */
+TEST_F(AplCoreConnectionManagerTest, VisualContextIsCachedUntilRelevantChange) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    recorder->onRenderingStarted(recorder->registerDocument());
+
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+    m_aplCoreConnectionManager->onUpdateTick();
+
+    std::vector<std::string> contexts;
+    EXPECT_CALL(*m_mockAplOptions, onVisualContextAvailable(_, _, _))
+        .WillRepeatedly(Invoke([&contexts](const std::string&, unsigned int, const std::string& context) {
+            contexts.push_back(context);
+        }));
+
+    m_aplCoreConnectionManager->provideState(1);
+    m_aplCoreConnectionManager->onUpdateTick();
+    m_aplCoreConnectionManager->provideState(2);
+
+    const std::string payload =
+        "{"
+        "  \"commands\": ["
+        "    {"
+        "      \"type\": \"SetValue\","
+        "      \"componentId\": \"textBox\","
+        "      \"property\": \"text\","
+        "      \"value\": \"Hi\""
+        "    }"
+        "  ]"
+        "}";
+    m_aplCoreConnectionManager->executeCommands(payload, "");
+    m_aplCoreConnectionManager->onUpdateTick();
+    m_aplCoreConnectionManager->provideState(3);
+
+    ASSERT_EQ(3u, contexts.size());
+    ASSERT_EQ(contexts[0], contexts[1]);
+
+    recorder->flush();
+    ASSERT_EQ(1u, sink->counters["APL-Web.RootContext.visualContextCacheHits"]);
+    ASSERT_EQ(2u, sink->counters["APL-Web.RootContext.visualContextCacheMisses"]);
+}
+
+/**
+ * Replays view host messages while a blocking send is outstanding and compares the parses made per message when
+ * messages are handed over as text and when they are parsed once by the caller.
+ */
+TEST_F(AplCoreConnectionManagerTest, ParseCountBenchmark) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    recorder->onRenderingStarted(recorder->registerDocument());
+
+    std::promise<void> sent;
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, _)).Times(Exactly(1)).WillOnce(InvokeWithoutArgs([&sent] {
+        sent.set_value();
+    }));
+    auto measureMsg = AplCoreViewhostMessage("measure");
+    std::thread thread([this, &measureMsg] {
+        m_aplCoreConnectionManager->blockingSend(measureMsg, std::chrono::milliseconds(5000));
+    });
+    ASSERT_EQ(std::future_status::ready, sent.get_future().wait_for(std::chrono::milliseconds(500)));
+
+    const std::string message = "{\"type\":\"update\",\"payload\":{\"id\":\"COMP1\",\"type\":1,\"value\":1}}";
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PARSE_BENCHMARK_MESSAGES; i++) {
+        if (m_aplCoreConnectionManager->shouldHandleMessage(message)) {
+            m_aplCoreConnectionManager->handleMessage(message);
+        }
+    }
+    auto textTime = std::chrono::steady_clock::now() - start;
+    recorder->flush();
+    uint64_t textParses = sink->counters[MESSAGE_PARSES];
+    sink->counters.clear();
+
+    uint64_t parsedParses = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PARSE_BENCHMARK_MESSAGES; i++) {
+        std::string buffer = message;
+        rapidjson::Document document;
+        document.ParseInsitu(&buffer[0]);
+        parsedParses++;
+        if (m_aplCoreConnectionManager->shouldHandleMessage(document)) {
+            m_aplCoreConnectionManager->handleMessage(document);
+        }
+    }
+    auto parsedTime = std::chrono::steady_clock::now() - start;
+    recorder->flush();
+    parsedParses += sink->counters[MESSAGE_PARSES];
+
+    m_aplCoreConnectionManager->shouldHandleMessage("{\"" + SEQNO_KEY + "\":1}");
+    thread.join();
+
+    ASSERT_EQ(2u * PARSE_BENCHMARK_MESSAGES, textParses);
+    ASSERT_EQ(1u * PARSE_BENCHMARK_MESSAGES, parsedParses);
+
+    auto report = [](const std::string& name, uint64_t parses, std::chrono::steady_clock::duration time) {
+        std::cout << name << ": " << static_cast<double>(parses) / PARSE_BENCHMARK_MESSAGES << " parses/message, "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() / PARSE_BENCHMARK_MESSAGES
+                  << " ns/message" << std::endl;
+    };
+    report("text", textParses, textTime);
+    report("parsed", parsedParses, parsedTime);
+}
+
+/**
+ * Tests that a configured in-process text measurement backend is used instead of the viewhost.
+ */
+TEST_F(AplCoreConnectionManagerTest, HandleBuildWithTextMeasurementBackend) {
+    auto backend = std::make_shared<NiceMock<MockAplTextMeasurementBackend>>();
+    m_aplConfiguration->setTextMeasurementBackend(backend);
+
+    EXPECT_CALL(*backend, measure(_, _, _, _, _, _))
+        .Times(AtLeast(1))
+        .WillRepeatedly(DoAll(SetArgReferee<5>(apl::LayoutSize{100, 50}), Return(true)));
+    const std::string measureMessageType = "\"type\":\"measure\"";
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, MatchOutMessage(measureMessageType, ""))).Times(0);
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, true, _)).Times(1);
+
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+}
+
+/**
+ * Tests that a document set after a previous build is inflated before the view host sends its build message, and
+ * that this inflation is used when the build message matches the previous one.
+ */
+TEST_F(AplCoreConnectionManagerTest, HandleBuildAdoptsSpeculativeInflation) {
+    auto backend = std::make_shared<NiceMock<MockAplTextMeasurementBackend>>();
+    m_aplConfiguration->setTextMeasurementBackend(backend);
+
+    auto testThread = std::this_thread::get_id();
+    std::atomic<int> measuredOnTestThread{0};
+    std::atomic<int> measuredOffTestThread{0};
+    EXPECT_CALL(*backend, measure(_, _, _, _, _, _))
+        .WillRepeatedly(Invoke(
+            [&](apl::Component*, float, apl::MeasureMode, float, apl::MeasureMode, apl::LayoutSize& size) {
+                if (std::this_thread::get_id() == testThread) {
+                    measuredOnTestThread++;
+                } else {
+                    measuredOffTestThread++;
+                }
+                size = apl::LayoutSize{100, 50};
+                return true;
+            }));
+    // The runtime is only notified on the executor thread, including of measurements made by the worker
+    std::atomic<int> textMeasureEvents{0};
+    std::atomic<int> eventsOffTestThread{0};
+    EXPECT_CALL(*m_mockAplOptions, onRenderingEvent(_, _))
+        .WillRepeatedly(Invoke([&](const std::string&, AplRenderingEvent event) {
+            if (std::this_thread::get_id() != testThread) {
+                eventsOffTestThread++;
+            } else if (event == AplRenderingEvent::TEXT_MEASURE) {
+                textMeasureEvents++;
+            }
+        }));
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, true, _)).Times(2);
+
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+    ASSERT_EQ(0, measuredOffTestThread);
+
+    measuredOnTestThread = 0;
+    textMeasureEvents = 0;
+    m_aplCoreConnectionManager->setContent(apl::Content::create(SPECULATIVE_DOCUMENT), "");
+    m_aplCoreConnectionManager->handleMessage(BUILD_PAYLOAD);
+
+    ASSERT_GT(measuredOffTestThread, 0);
+    ASSERT_EQ(0, measuredOnTestThread);
+    ASSERT_GT(textMeasureEvents, 0);
+    ASSERT_EQ(0, eventsOffTestThread);
+}
+
+/**
+ * Tests that a speculative inflation is discarded and the document inflated again when the build message differs.
+ */
+TEST_F(AplCoreConnectionManagerTest, HandleBuildDiscardsMismatchedSpeculativeInflation) {
+    auto backend = std::make_shared<NiceMock<MockAplTextMeasurementBackend>>();
+    m_aplConfiguration->setTextMeasurementBackend(backend);
+
+    auto testThread = std::this_thread::get_id();
+    std::atomic<int> measuredOnTestThread{0};
+    EXPECT_CALL(*backend, measure(_, _, _, _, _, _))
+        .WillRepeatedly(Invoke(
+            [&](apl::Component*, float, apl::MeasureMode, float, apl::MeasureMode, apl::LayoutSize& size) {
+                if (std::this_thread::get_id() == testThread) {
+                    measuredOnTestThread++;
+                }
+                size = apl::LayoutSize{100, 50};
+                return true;
+            }));
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, true, _)).Times(2);
+
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+
+    measuredOnTestThread = 0;
+    m_aplCoreConnectionManager->setContent(apl::Content::create(SPECULATIVE_DOCUMENT), "");
+    m_aplCoreConnectionManager->handleMessage(RESIZED_BUILD_PAYLOAD);
+
+    ASSERT_GT(measuredOnTestThread, 0);
+}
+
+/**
+ * Tests that no speculative inflation is started when text can only be measured by the view host, which cannot
+ * reply before the handshake.
+ */
+TEST_F(AplCoreConnectionManagerTest, NoSpeculativeInflationWithoutTextMeasurement) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, true, _)).Times(2);
+
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+
+    recorder->onRenderingStarted(recorder->registerDocument());
+    m_aplCoreConnectionManager->setContent(apl::Content::create(SPECULATIVE_DOCUMENT), "");
+    m_aplCoreConnectionManager->handleMessage(BUILD_PAYLOAD);
+    recorder->flush();
+
+    ASSERT_EQ(0u, sink->counters.count("APL-Web.RootContext.speculativeInflationHit"));
+    ASSERT_EQ(0u, sink->counters.count("APL-Web.RootContext.speculativeInflationDiscarded"));
+}
+
+/**
+ * Tests that a document which could not be inflated with its first choice of scaling is inflated with the scaling it
+ * succeeded with on the first attempt when it is rendered again.
+ */
+TEST_F(AplCoreConnectionManagerTest, HandleBuildRemembersWorkingScaling) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, true, _)).Times(2);
+
+    const size_t documentHash = std::hash<std::string>()(NARROW_VIEWPORT_DOCUMENT);
+    std::vector<uint64_t> attempts;
+    std::vector<apl::ViewportSpecification> chosenSpecs;
+    for (int i = 0; i < 2; i++) {
+        recorder->onRenderingStarted(recorder->registerDocument());
+        m_aplCoreConnectionManager->setSupportedViewports(VIEWPORT);
+        m_aplCoreConnectionManager->setContent(apl::Content::create(NARROW_VIEWPORT_DOCUMENT), "", documentHash);
+        m_aplCoreConnectionManager->handleMessage(BUILD_PAYLOAD);
+        recorder->flush();
+        attempts.push_back(sink->counters["APL-Web.RootContext.inflationAttempts"]);
+        chosenSpecs.push_back(m_aplCoreConnectionManager->aplCoreMetrics()->getChosenSpec());
+        sink->counters.clear();
+    }
+
+    // The first choice of scaling is too wide for the document, so the first build has to try another one
+    ASSERT_GT(attempts[0], 1u);
+    // The second build starts from the scaling the first build ended with, and succeeds with it
+    ASSERT_EQ(1u, attempts[1]);
+    ASSERT_TRUE(chosenSpecs[0] == chosenSpecs[1]);
+}
+
+/**
+ * Tests that batched measurement requests are not sent to viewhosts which do not announce support for them.
+ */
+TEST_F(AplCoreConnectionManagerTest, HandleBuildWithoutBatchMeasurementSupport) {
+    const std::string measureBatchMessageType = "\"type\":\"measureBatch\"";
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, MatchOutMessage(measureBatchMessageType, ""))).Times(0);
+
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+}
+
+/**
+ * Tests that the sibling Text components are measured in a single batch, and that the measurements of the batch are
+ * cached so that the siblings do not need measuring again.
+ */
+TEST_F(AplCoreConnectionManagerTest, HandleBuildWithBatchMeasurement) {
+    const std::string document =
+        "{"
+        "  \"type\": \"APL\","
+        "  \"version\": \"1.5\","
+        "  \"mainTemplate\": {"
+        "    \"item\": {"
+        "      \"type\": \"Container\","
+        "      \"width\": 500,"
+        "      \"items\": ["
+        "        { \"type\": \"Text\", \"text\": \"First\" },"
+        "        { \"type\": \"Text\", \"text\": \"Second\" },"
+        "        { \"type\": \"Text\", \"text\": \"Third\" }"
+        "      ]"
+        "    }"
+        "  }"
+        "}";
+    auto buildPayload = BUILD_PAYLOAD;
+    buildPayload.replace(buildPayload.find("\"mode\""), 0, "\"measureBatch\":true,");
+
+    int batches = 0;
+    size_t batchedMeasurements = 0;
+    int measurements = 0;
+    ON_CALL(*m_mockAplOptions, sendMessage(_, _))
+        .WillByDefault(Invoke([&](const std::string&, const std::string& message) {
+            rapidjson::Document request;
+            request.Parse(message.c_str());
+            std::string type = request["type"].GetString();
+            if (type != "measureBatch" && type != "measure") {
+                return;
+            }
+
+            rapidjson::Document reply(rapidjson::kObjectType);
+            auto& allocator = reply.GetAllocator();
+            reply.AddMember("type", rapidjson::Value(type.c_str(), allocator), allocator);
+            reply.AddMember("seqno", request["seqno"].GetUint(), allocator);
+            rapidjson::Value size(rapidjson::kObjectType);
+            size.AddMember("width", 100, allocator);
+            size.AddMember("height", 20, allocator);
+            if (type == "measureBatch") {
+                batches++;
+                batchedMeasurements += request["payload"].Size();
+                rapidjson::Value sizes(rapidjson::kArrayType);
+                for (rapidjson::SizeType i = 0; i < request["payload"].Size(); i++) {
+                    sizes.PushBack(rapidjson::Value(size, allocator), allocator);
+                }
+                reply.AddMember("payload", sizes, allocator);
+            } else {
+                measurements++;
+                reply.AddMember("payload", size, allocator);
+            }
+
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            reply.Accept(writer);
+            m_aplCoreConnectionManager->shouldHandleMessage(buffer.GetString());
+        }));
+
+    auto content = apl::Content::create(document);
+    m_aplCoreConnectionManager->setSupportedViewports(VIEWPORT);
+    m_aplCoreConnectionManager->setContent(content, "");
+    m_aplCoreConnectionManager->handleMessage(buildPayload);
+
+    // Every batch holds all three texts, and measuring the siblings never needed a request of its own
+    ASSERT_GT(batches, 0);
+    ASSERT_EQ(3u * batches, batchedMeasurements);
+    ASSERT_EQ(0, measurements);
+}
+
 /**
  * Tests HandleMessage function with build type.
  */
@@ -937,6 +1515,49 @@ TEST_F(AplCoreConnectionManagerTest, HandleReInflateSuccess) {
     m_aplCoreConnectionManager->handleMessage(payload);
 }
 
+TEST_F(AplCoreConnectionManagerTest, RestoreHibernatedDocumentState) {
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+    // The size of the document state is only estimated on demand
+    ASSERT_EQ(0u, m_aplCoreConnectionManager->getActiveDocumentState()->estimatedSize);
+    auto documentState = m_aplCoreConnectionManager->getActiveDocumentState(true);
+    ASSERT_NE(nullptr, documentState);
+    ASSERT_GT(documentState->estimatedSize, 0u);
+
+    // When the document state is hibernated and restored
+    documentState->hibernate();
+    ASSERT_TRUE(documentState->isHibernated());
+    m_aplCoreConnectionManager->restoreDocumentState(documentState);
+
+    // Then the document is inflated again and its hierarchy sent out.
+    const std::string hierarchyMessageType = "\"type\":\"hierarchy\"";
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, _)).Times(AnyNumber());
+    EXPECT_CALL(*m_mockAplOptions, sendMessage(_, MatchOutMessage(hierarchyMessageType, "COMP1"))).Times(1);
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, true, _)).Times(1);
+    m_aplCoreConnectionManager->handleMessage(BUILD_PAYLOAD);
+    ASSERT_NE(nullptr, m_aplCoreConnectionManager->getActiveDocumentState());
+}
+
+/**
+ * Tests that the backstack size is reported as samples of its current size, along with the size of the added state.
+ */
+TEST_F(AplCoreConnectionManagerTest, BackstackSizeIsReportedAsSamples) {
+    auto sink = std::make_shared<CounterSink>();
+    auto recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(sink));
+    m_aplConfiguration->setMetricsRecorder(recorder);
+    recorder->onRenderingStarted(recorder->registerDocument());
+    BuildDocument(DOCUMENT, DATA, VIEWPORT);
+    auto documentState = m_aplCoreConnectionManager->getActiveDocumentState(true);
+    ASSERT_NE(nullptr, documentState);
+
+    m_aplCoreConnectionManager->reportBackstackSize(documentState, 3, 2 * documentState->estimatedSize);
+
+    recorder->flush();
+    ASSERT_EQ(3u, sink->counters["APL-Web.Backstack.cachedDocumentStates"]);
+    ASSERT_EQ(2 * documentState->estimatedSize, sink->counters["APL-Web.Backstack.cachedDocumentStateBytes"]);
+    ASSERT_EQ(documentState->estimatedSize, sink->counters["APL-Web.Backstack.documentStateBytes"]);
+}
+
 TEST_F(AplCoreConnectionManagerTest, HandleReHierarchySuccess) {
     EXPECT_CALL(*m_mockAplOptions, resetViewhost(_)).Times(1);
     EXPECT_CALL(*m_mockAplOptions, onRenderingEvent(_, _)).Times(5);
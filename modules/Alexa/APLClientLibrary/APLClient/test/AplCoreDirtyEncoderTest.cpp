@@ -0,0 +1,228 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "APLClient/AplCoreDirtyEncoder.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace APLClient {
+namespace test {
+
+using namespace ::testing;
+
+/// Number of frames replayed by the benchmark.
+static const int BENCHMARK_FRAMES = 600;
+
+/// Number of list items scrolled in every benchmark frame.
+static const int BENCHMARK_ITEMS = 20;
+
+/**
+ * A dirty property recorded from a frame.
+ */
+struct RecordedProperty {
+    std::string uid;
+    apl::PropertyKey key;
+    apl::Object value;
+};
+
+class AplCoreDirtyEncoderTest : public ::testing::Test {
+protected:
+    /**
+     * Serializes a JSON value to text.
+     */
+    static std::string toText(const rapidjson::Value& value) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        value.Accept(writer);
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    /**
+     * Records the dirty set of a frame of a scrolling list with a looping opacity animation: every item moves, while
+     * its text and the opacity of the list stay the same most of the time.
+     */
+    static std::vector<RecordedProperty> recordFrame(int frame) {
+        std::vector<RecordedProperty> dirty;
+        dirty.push_back({":1000", apl::kPropertyScrollPosition, apl::Object(frame * 4.0)});
+        dirty.push_back({":1000", apl::kPropertyOpacity, apl::Object((frame / 60) % 2 ? 1.0 : 0.5)});
+        for (int i = 0; i < BENCHMARK_ITEMS; i++) {
+            auto uid = ":" + std::to_string(1001 + i);
+            dirty.push_back({uid, apl::kPropertyBounds, apl::Object(apl::Rect(0, i * 100 - frame * 4.0, 1280, 100))});
+            dirty.push_back({uid, apl::kPropertyText, apl::Object("Item " + std::to_string(i))});
+            dirty.push_back({uid, apl::kPropertyChecked, apl::Object(i == frame % BENCHMARK_ITEMS)});
+        }
+        return dirty;
+    }
+
+    /**
+     * Encodes a frame the way the "dirty" message does, with every dirty property named in full.
+     */
+    static std::string encodeNamed(const std::vector<RecordedProperty>& dirty) {
+        rapidjson::Document document(rapidjson::kArrayType);
+        auto& allocator = document.GetAllocator();
+        std::map<std::string, rapidjson::Value> updates;
+        for (auto& property : dirty) {
+            auto it = updates.find(property.uid);
+            if (it == updates.end()) {
+                rapidjson::Value update(rapidjson::kObjectType);
+                update.AddMember("id", rapidjson::Value(property.uid.c_str(), allocator).Move(), allocator);
+                it = updates.emplace(property.uid, std::move(update)).first;
+            }
+            it->second.AddMember(
+                rapidjson::StringRef(apl::sComponentPropertyBimap.at(property.key).c_str()),
+                property.value.serialize(allocator),
+                allocator);
+        }
+        for (auto it = updates.rbegin(); it != updates.rend(); it++) {
+            document.PushBack(it->second.Move(), allocator);
+        }
+        return toText(document);
+    }
+
+    /**
+     * Adds the dirty properties of a frame to the encoder.
+     */
+    void add(const std::vector<RecordedProperty>& dirty) {
+        for (auto& property : dirty) {
+            m_encoder.addProperty(property.uid, property.key, property.value);
+        }
+    }
+
+    /**
+     * Encodes the current frame as a "dirtyDelta" payload.
+     */
+    std::string encodeJson() {
+        rapidjson::Document document;
+        return toText(m_encoder.encodeJson(document.GetAllocator()));
+    }
+
+    AplCoreDirtyEncoder m_encoder;
+};
+
+TEST_F(AplCoreDirtyEncoderTest, SendsPropertyNamesOnce) {
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    auto opacity = std::to_string(apl::kPropertyOpacity);
+    ASSERT_EQ(
+        "{\"names\":{\"" + opacity + "\":\"opacity\"},\"dirty\":[[\":1\"," + opacity + ",0.5]]}", encodeJson());
+
+    m_encoder.addProperty(":2", apl::kPropertyOpacity, apl::Object(0.25));
+    ASSERT_EQ("{\"names\":{},\"dirty\":[[\":2\"," + opacity + ",0.25]]}", encodeJson());
+}
+
+TEST_F(AplCoreDirtyEncoderTest, DropsUnchangedValues) {
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    encodeJson();
+
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    ASSERT_TRUE(m_encoder.empty());
+
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(1.0));
+    ASSERT_FALSE(m_encoder.empty());
+}
+
+TEST_F(AplCoreDirtyEncoderTest, AlwaysSendsChildrenChanges) {
+    auto change = apl::Object(std::make_shared<std::vector<apl::Object>>());
+    m_encoder.addProperty(":1", apl::kPropertyNotifyChildrenChanged, change);
+    encodeJson();
+
+    m_encoder.addProperty(":1", apl::kPropertyNotifyChildrenChanged, change);
+    ASSERT_FALSE(m_encoder.empty());
+}
+
+TEST_F(AplCoreDirtyEncoderTest, SerializedUpdateReplacesProperties) {
+    rapidjson::Document document;
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+
+    rapidjson::Value update(rapidjson::kObjectType);
+    update.AddMember("id", ":1", document.GetAllocator());
+    m_encoder.addSerialized(":1", std::move(update));
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(1.0));
+    ASSERT_TRUE(m_encoder.contains(":1"));
+
+    auto payload = m_encoder.encodeJson(document.GetAllocator());
+    ASSERT_EQ(1u, payload["dirty"].Size());
+    ASSERT_TRUE(payload["dirty"][0].IsObject());
+    ASSERT_STREQ(":1", payload["dirty"][0]["id"].GetString());
+
+    // The view host took the value from the full update, so it is sent again
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    ASSERT_FALSE(m_encoder.empty());
+}
+
+TEST_F(AplCoreDirtyEncoderTest, RemovedComponentForgetsValues) {
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    encodeJson();
+    m_encoder.remove(":1");
+
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    ASSERT_FALSE(m_encoder.empty());
+}
+
+TEST_F(AplCoreDirtyEncoderTest, ResetForgetsNames) {
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    encodeJson();
+    m_encoder.reset();
+
+    m_encoder.addProperty(":1", apl::kPropertyOpacity, apl::Object(0.5));
+    rapidjson::Document document;
+    auto payload = m_encoder.encodeJson(document.GetAllocator());
+    ASSERT_EQ(1u, payload["names"].MemberCount());
+    ASSERT_EQ(1u, payload["dirty"].Size());
+}
+
+/**
+ * Replays recorded dirty sets and compares the size and encoding time of the "dirty" message with the delta encoding.
+ */
+TEST_F(AplCoreDirtyEncoderTest, ReplayBenchmark) {
+    std::vector<std::vector<RecordedProperty>> frames;
+    for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+        frames.push_back(recordFrame(frame));
+    }
+
+    size_t namedBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& frame : frames) {
+        namedBytes += encodeNamed(frame).size();
+    }
+    auto namedTime = std::chrono::steady_clock::now() - start;
+
+    size_t deltaBytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto& frame : frames) {
+        add(frame);
+        deltaBytes += encodeJson().size();
+    }
+    auto deltaTime = std::chrono::steady_clock::now() - start;
+
+    ASSERT_LT(deltaBytes, namedBytes);
+
+    auto report = [](const std::string& name, size_t bytes, std::chrono::steady_clock::duration time) {
+        std::cout << name << ": " << bytes / BENCHMARK_FRAMES << " bytes/frame, "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(time).count() / BENCHMARK_FRAMES
+                  << " us/frame" << std::endl;
+    };
+    report("dirty", namedBytes, namedTime);
+    report("dirtyDelta", deltaBytes, deltaTime);
+}
+
+}  // namespace test
+}  // namespace APLClient
@@ -0,0 +1,263 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "APLClient/AplCoreConnectionManager.h"
+#include "MockAplOptionsInterface.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <APLClient/Telemetry/AplMetricsRecorder.h>
+
+// The replacement of the global allocation functions below applies to the whole test executable. It is kept in this
+// file, which is built into an executable of its own, so that it does not affect any other test.
+
+/// Number of heap allocations made by the test executable.
+static std::atomic<uint64_t> s_allocations{0};
+
+void* operator new(std::size_t size) {
+    s_allocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+namespace APLClient {
+namespace test {
+
+using namespace ::testing;
+
+/// A document with nothing to update once it is displayed.
+static const std::string STATIC_DOCUMENT =
+    "{"
+    "  \"type\": \"APL\","
+    "  \"version\": \"1.5\","
+    "  \"mainTemplate\": {"
+    "    \"item\": {"
+    "      \"type\": \"Frame\","
+    "      \"width\": 100,"
+    "      \"height\": 100,"
+    "      \"backgroundColor\": \"red\""
+    "    }"
+    "  }"
+    "}";
+
+/// A document animating the opacity of a component, so that every update tick has a dirty component to send.
+static const std::string ANIMATED_DOCUMENT =
+    "{"
+    "  \"type\": \"APL\","
+    "  \"version\": \"1.5\","
+    "  \"mainTemplate\": {"
+    "    \"item\": {"
+    "      \"type\": \"Frame\","
+    "      \"id\": \"animated\","
+    "      \"width\": 100,"
+    "      \"height\": 100,"
+    "      \"backgroundColor\": \"red\","
+    "      \"onMount\": ["
+    "        {"
+    "          \"type\": \"AnimateItem\","
+    "          \"duration\": 1000,"
+    "          \"repeatCount\": 100,"
+    "          \"repeatMode\": \"reverse\","
+    "          \"value\": [ { \"property\": \"opacity\", \"from\": 0.1, \"to\": 1 } ]"
+    "        }"
+    "      ]"
+    "    }"
+    "  }"
+    "}";
+
+static const std::string BUILD_PAYLOAD =
+    "{"
+    "  \"type\":\"build\","
+    "  \"payload\":"
+    "  {"
+    "    \"agentName\":\"SmartScreenSDK\","
+    "    \"agentVersion\":\"1.0\","
+    "    \"allowOpenUrl\":false,"
+    "    \"disallowVideo\":false,"
+    "    \"animationQuality\":\"normal\","
+    "    \"width\":1920,\"height\":1080,"
+    "    \"shape\":\"RECTANGLE\","
+    "    \"dpi\":160,"
+    "    \"mode\":\"TV\""
+    "  }"
+    "}";
+
+/// The type of the messages carrying dirty components.
+static const std::string DIRTY_MESSAGE_TYPE = "\"type\":\"dirty\"";
+
+/// The metric counting reused frame buffers which had to grow.
+static const std::string FRAME_BUFFER_GROWTHS = "APL-Web.RootContext.frameBufferGrowths";
+
+/// The metric counting the heap allocations made by update ticks.
+static const std::string FRAME_ALLOCATIONS = "APL-Web.RootContext.frameAllocations";
+
+/// Number of update ticks letting the reused frame buffers settle before ticks are measured.
+static const int WARM_UP_TICKS = 5;
+
+/// Number of update ticks of an idle document checked for heap allocations.
+static const int IDLE_UPDATE_TICKS = 10;
+
+/// Number of measured update ticks.
+static const int MEASURED_TICKS = 20;
+
+/// Time between update ticks, long enough for the animation to change the opacity.
+static const std::chrono::milliseconds TICK_INTERVAL{20};
+
+/**
+ * A metrics sink summing the counters reported to it.
+ */
+class CounterSink : public Telemetry::AplMetricsSinkInterface {
+public:
+    void reportTimer(
+        const std::map<std::string, std::string>& metadata,
+        const std::string& name,
+        const std::chrono::nanoseconds& value) override {
+    }
+
+    void reportCounter(const std::map<std::string, std::string>& metadata, const std::string& name, uint64_t value)
+        override {
+        counters[name] += value;
+    }
+
+    std::map<std::string, uint64_t> counters;
+};
+
+/// Test harness for the memory reused by the update loop of @c AplCoreConnectionManager.
+class AplCoreFrameAllocationTest : public ::testing::Test {
+public:
+    /// Set up the test harness for running a test.
+    void SetUp() override;
+
+    /// Clean up the test harness after running a test.
+    void TearDown() override;
+
+protected:
+    /**
+     * Runs update ticks, waiting @c TICK_INTERVAL before each.
+     *
+     * @param count The number of ticks
+     */
+    void tick(int count);
+
+    /**
+     * Renders a document and runs @c WARM_UP_TICKS update ticks, so that the reused frame buffers settle, then clears
+     * the metrics reported so far.
+     *
+     * @param document The document
+     */
+    void renderAndWarmUp(const std::string& document);
+
+    std::shared_ptr<MockAplOptionsInterface> m_mockAplOptions;
+    std::shared_ptr<CounterSink> m_sink;
+    std::shared_ptr<Telemetry::AplMetricsRecorder> m_recorder;
+    AplConfigurationPtr m_aplConfiguration;
+    std::shared_ptr<AplCoreConnectionManager> m_aplCoreConnectionManager;
+
+    /// Number of messages with dirty components sent to the view host.
+    std::atomic<int> m_dirtyMessages{0};
+};
+
+void AplCoreFrameAllocationTest::SetUp() {
+    m_mockAplOptions = std::make_shared<NiceMock<MockAplOptionsInterface>>();
+    m_sink = std::make_shared<CounterSink>();
+    m_recorder =
+        std::dynamic_pointer_cast<Telemetry::AplMetricsRecorder>(Telemetry::AplMetricsRecorder::create(m_sink));
+    m_aplConfiguration = std::make_shared<AplConfiguration>(m_mockAplOptions, m_recorder);
+    m_aplConfiguration->setAllocationCounter([]() { return s_allocations.load(); });
+    m_aplCoreConnectionManager = std::make_shared<AplCoreConnectionManager>(m_aplConfiguration);
+
+    ON_CALL(*m_mockAplOptions, sendMessage(_, _))
+        .WillByDefault(Invoke([this](const std::string&, const std::string& payload) {
+            if (payload.find(DIRTY_MESSAGE_TYPE) != std::string::npos) {
+                m_dirtyMessages++;
+            }
+        }));
+}
+
+void AplCoreFrameAllocationTest::TearDown() {
+    m_aplCoreConnectionManager.reset();
+}
+
+void AplCoreFrameAllocationTest::tick(int count) {
+    for (int i = 0; i < count; i++) {
+        std::this_thread::sleep_for(TICK_INTERVAL);
+        m_aplCoreConnectionManager->onUpdateTick();
+    }
+}
+
+void AplCoreFrameAllocationTest::renderAndWarmUp(const std::string& document) {
+    m_recorder->onRenderingStarted(m_recorder->registerDocument());
+    m_aplCoreConnectionManager->setContent(apl::Content::create(document), "");
+    m_aplCoreConnectionManager->handleMessage(BUILD_PAYLOAD);
+    tick(WARM_UP_TICKS);
+    m_recorder->flush();
+    m_sink->counters.clear();
+}
+
+/**
+ * Tests that update ticks of a document with nothing to update make no heap allocations, and report none.
+ */
+TEST_F(AplCoreFrameAllocationTest, IdleUpdateTicksDoNotAllocate) {
+    renderAndWarmUp(STATIC_DOCUMENT);
+    ASSERT_GT(m_aplCoreConnectionManager->getNextUpdateDelay(), std::chrono::milliseconds::zero());
+
+    m_dirtyMessages = 0;
+    auto allocations = s_allocations.load();
+    for (int i = 0; i < IDLE_UPDATE_TICKS; i++) {
+        m_aplCoreConnectionManager->onUpdateTick();
+    }
+    allocations = s_allocations.load() - allocations;
+    m_recorder->flush();
+
+    ASSERT_EQ(0, m_dirtyMessages.load());
+    ASSERT_EQ(0u, allocations);
+    ASSERT_EQ(0u, m_sink->counters.count(FRAME_ALLOCATIONS));
+}
+
+/**
+ * Tests that once the update loop has settled, update ticks which send dirty components do not grow the reused frame
+ * buffers, and that the heap allocations made per tick, most of which are made by APL Core, are reported.
+ */
+TEST_F(AplCoreFrameAllocationTest, DirtyUpdateTicksReuseFrameBuffers) {
+    renderAndWarmUp(ANIMATED_DOCUMENT);
+
+    m_dirtyMessages = 0;
+    auto allocations = s_allocations.load();
+    tick(MEASURED_TICKS);
+    allocations = s_allocations.load() - allocations;
+    m_recorder->flush();
+
+    ASSERT_EQ(MEASURED_TICKS, m_dirtyMessages.load());
+    ASSERT_EQ(0u, m_sink->counters[FRAME_BUFFER_GROWTHS]);
+    // The allocations made to report the metric itself are not part of the frame
+    ASSERT_GT(m_sink->counters[FRAME_ALLOCATIONS], 0u);
+    ASSERT_LE(m_sink->counters[FRAME_ALLOCATIONS], allocations);
+    std::cout << "dirty update tick: " << static_cast<double>(m_sink->counters[FRAME_ALLOCATIONS]) / MEASURED_TICKS
+              << " heap allocations/tick" << std::endl;
+}
+
+}  // namespace test
+}  // namespace APLClient
@@ -13,6 +13,13 @@
  * permissions and limitations under the License.
  */
 
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+#include "APLClient/AplCoreContentCache.h"
 #include "APLClient/AplCoreGuiRenderer.h"
 #include "APLClient/Telemetry/NullAplMetricsRecorder.h"
 #include "MockAplCoreConnectionManager.h"
@@ -64,6 +71,12 @@ static const std::string TOKEN = "";
 
 static const std::string DATA = "{}";
 
+/// Data source sizes rendered by the benchmark, in bytes.
+static const std::vector<size_t> BENCHMARK_DATA_SIZES = {50 * 1024, 250 * 1024, 1024 * 1024};
+
+/// Number of renders of each data source size in the benchmark.
+static const int BENCHMARK_RENDERS = 5;
+
 /// Test harness for @c AplCoreGuiRendererTest class.
 class AplCoreGuiRendererTest : public ::testing::Test {
 
@@ -75,6 +88,38 @@ void SetUp() override;
 void TearDown() override;
 
 protected:
+    /**
+     * Expects @c renders successful renders of @c DOCUMENT_APL_WITH_PACKAGE, each downloading its package and the
+     * package that it imports in turn.
+     *
+     * @param renders The number of renders.
+     */
+    void expectTransitivePackageRenders(int renders);
+
+    /// A package importing @c m_transitivePackageContent.
+    const std::string m_packageContent = "{"
+                         " \"type\": \"APL\","
+                         " \"version\": \"1.0.0\","
+                         " \"import\": ["
+                         "     {"
+                         "        \"name\":\"alexa-styles\","
+                         "        \"version\":\"1.0.0\""
+                         "     }"
+                         " ],"
+                         " \"resources\": []"
+                         " }";
+
+    /// The package imported by @c m_packageContent.
+    const std::string m_transitivePackageContent = "{"
+                         " \"type\": \"APL\","
+                         " \"version\": \"1.0.0\","
+                         " \"resources\": []"
+                         " }";
+
+    /// The source of @c m_transitivePackageContent.
+    const std::string m_transitiveSource =
+            "https://d2na8397m465mh.cloudfront.net/packages/alexa-styles/1.0.0/document.json";
+
     std::shared_ptr<MockAplOptionsInterface> m_mockAplOptions;
 
     std::shared_ptr<MockAplCoreConnectionManager> m_mockAplCoreConnectionManager;
@@ -104,6 +149,16 @@ void AplCoreGuiRendererTest::TearDown(){
     }
 }
 
+void AplCoreGuiRendererTest::expectTransitivePackageRenders(int renders){
+    EXPECT_CALL(*m_mockAplOptions, downloadResource(SOURCE)).Times(renders).WillRepeatedly(Return(m_packageContent));
+    EXPECT_CALL(*m_mockAplOptions, downloadResource(m_transitiveSource))
+        .Times(renders)
+        .WillRepeatedly(Return(m_transitivePackageContent));
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, _, _)).Times(0);
+    EXPECT_CALL(*m_mockAplCoreConnectionManager, setSupportedViewports(VIEWPORT_PAYLOAD)).Times(renders);
+    EXPECT_CALL(*m_mockAplOptions,getMaxNumberOfConcurrentDownloads()).Times(renders).WillRepeatedly(Return(1));
+}
+
 /**
  * Tests rendering empty document content.
  */
@@ -145,7 +200,7 @@ TEST_F(AplCoreGuiRendererTest, RenderWithDocumentContent){
                           "}";
 
     EXPECT_CALL(*m_mockAplCoreConnectionManager, setSupportedViewports(VIEWPORT_PAYLOAD)).Times(1);
-    EXPECT_CALL(*m_mockAplCoreConnectionManager, setContent(_, _)).Times(1);
+    EXPECT_CALL(*m_mockAplCoreConnectionManager, setContent(_, _, _, _)).Times(1);
 
     m_aplCoreGuiRenderer->renderDocument(document, DATA, VIEWPORT_PAYLOAD, TOKEN);
 }
@@ -192,12 +247,134 @@ TEST_F(AplCoreGuiRendererTest, RenderWithPackageContent){
     EXPECT_CALL(*m_mockAplOptions, logMessage(_, _, _)).Times(0);
     EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, _, _)).Times(0);
     EXPECT_CALL(*m_mockAplCoreConnectionManager, setSupportedViewports(VIEWPORT_PAYLOAD)).Times(1);
-    EXPECT_CALL(*m_mockAplCoreConnectionManager, setContent(_, _)).Times(1);
+    EXPECT_CALL(*m_mockAplCoreConnectionManager, setContent(_, _, _, _)).Times(1);
     EXPECT_CALL(*m_mockAplOptions,getMaxNumberOfConcurrentDownloads()).Times(1).WillOnce(Return(5));
 
     m_aplCoreGuiRenderer->renderDocument(DOCUMENT_APL_WITH_PACKAGE, DATA, VIEWPORT_PAYLOAD, TOKEN);
 }
 
+/**
+ * Tests that imports discovered in a downloaded package are downloaded and added to the content
+ */
+TEST_F(AplCoreGuiRendererTest, RenderWithTransitivePackageContent){
+    expectTransitivePackageRenders(1);
+    EXPECT_CALL(*m_mockAplCoreConnectionManager, setContent(_, _, _, _)).Times(1);
+
+    m_aplCoreGuiRenderer->renderDocument(DOCUMENT_APL_WITH_PACKAGE, DATA, VIEWPORT_PAYLOAD, TOKEN);
+}
+
+/**
+ * Tests that rendering a document again reuses its parsed content from the content cache, while its imported packages
+ * are requested again so that the download manager can revalidate them
+ */
+TEST_F(AplCoreGuiRendererTest, RenderCachedDocumentContent){
+    expectTransitivePackageRenders(2);
+    AplDocumentSourcePtr source;
+    EXPECT_CALL(
+        *m_mockAplCoreConnectionManager, setContent(_, _, std::hash<std::string>()(DOCUMENT_APL_WITH_PACKAGE), _))
+        .Times(2)
+        .WillRepeatedly(SaveArg<3>(&source));
+
+    m_aplCoreGuiRenderer->renderDocument(DOCUMENT_APL_WITH_PACKAGE, DATA, VIEWPORT_PAYLOAD, TOKEN);
+    ASSERT_EQ(1u, m_aplConfiguration->getContentCache()->size());
+    ASSERT_EQ(2u, source->packages.size());
+    // The time taken to parse the document and create its content is kept, to report the time a hit saves
+    std::chrono::nanoseconds creationTime;
+    ASSERT_TRUE(m_aplConfiguration->getContentCache()->get(
+        std::hash<std::string>()(DOCUMENT_APL_WITH_PACKAGE), DOCUMENT_APL_WITH_PACKAGE, &creationTime));
+    ASSERT_GT(creationTime.count(), 0);
+
+    const std::string otherData = "{\"payload\": {\"other\": 1}}";
+    m_aplCoreGuiRenderer->renderDocument(DOCUMENT_APL_WITH_PACKAGE, otherData, VIEWPORT_PAYLOAD, TOKEN);
+    ASSERT_EQ(1u, m_aplConfiguration->getContentCache()->size());
+
+    // The source of the document is enough to create its content again
+    ASSERT_EQ(otherData, source->data);
+    ASSERT_EQ(2u, source->packages.size());
+    ASSERT_NE(nullptr, source->createContent());
+}
+
+/**
+ * Tests that the content cache evicts the least recently used document and never returns a colliding document
+ */
+TEST_F(AplCoreGuiRendererTest, ContentCacheEvictsLeastRecentlyUsed){
+    AplCoreContentCache cache(2);
+    auto put = [&cache](size_t documentHash, const std::string& rawDocument) {
+        cache.put(
+            documentHash,
+            rawDocument,
+            AplCoreContentCache::parse(rawDocument),
+            std::chrono::milliseconds(documentHash));
+    };
+    put(1, "{\"a\": 1}");
+    put(2, "{\"b\": 2}");
+
+    std::chrono::nanoseconds creationTime;
+    ASSERT_TRUE(cache.get(1, "{\"a\": 1}", &creationTime));
+    ASSERT_EQ(std::chrono::milliseconds(1), creationTime);
+    put(3, "{\"c\": 3}");
+
+    ASSERT_TRUE(cache.get(1, "{\"a\": 1}"));
+    ASSERT_FALSE(cache.get(2, "{\"b\": 2}"));
+    // Documents of the same size and hash are told apart
+    ASSERT_FALSE(cache.get(3, "{\"d\": 4}"));
+    // Invalid documents are not cached
+    put(4, "{");
+    ASSERT_FALSE(cache.get(4, "{"));
+    ASSERT_EQ(nullptr, AplCoreContentCache::parse("{"));
+}
+
+/**
+ * Renders a document bound to data sources of 50 KB to 1 MB, and reports the time taken per render next to the time
+ * taken to parse the data sources once.
+ */
+TEST_F(AplCoreGuiRendererTest, RenderLargeDatasourcesBenchmark){
+    const std::string document = "{"
+                          "  \"type\": \"APL\","
+                          "  \"version\": \"1.6\","
+                          "  \"mainTemplate\": {"
+                          "    \"parameters\": [\"payload\", \"listData\"],"
+                          "    \"item\": {"
+                          "      \"type\": \"Sequence\","
+                          "      \"data\": \"${listData.items}\","
+                          "      \"item\": {\"type\": \"Text\", \"text\": \"${data.text}\"}"
+                          "    }"
+                          "  }"
+                          "}";
+
+    EXPECT_CALL(*m_mockAplOptions, onRenderDocumentComplete(_, _, _)).Times(0);
+    EXPECT_CALL(*m_mockAplCoreConnectionManager, setSupportedViewports(_)).Times(AnyNumber());
+    EXPECT_CALL(*m_mockAplCoreConnectionManager, setContent(_, _, _, _)).Times(AnyNumber());
+
+    for (auto size : BENCHMARK_DATA_SIZES) {
+        std::string data = "{\"listData\": {\"type\": \"object\", \"items\": [";
+        for (int i = 0; data.size() < size; i++) {
+            data += (i ? "," : "") + std::string("{\"id\": ") + std::to_string(i) + ", \"text\": \"Item " +
+                    std::to_string(i) + " " + std::string(64, 'x') + "\"}";
+        }
+        data += "]}}";
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_RENDERS; i++) {
+            rapidjson::Document parsed;
+            parsed.Parse(data.c_str());
+            ASSERT_FALSE(parsed.HasParseError());
+        }
+        auto parseTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_RENDERS; i++) {
+            m_aplCoreGuiRenderer->renderDocument(document, data, VIEWPORT_PAYLOAD, TOKEN);
+        }
+        auto renderTime = std::chrono::steady_clock::now() - start;
+
+        auto micros = [](std::chrono::steady_clock::duration time) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(time).count() / BENCHMARK_RENDERS;
+        };
+        std::cout << data.size() / 1024 << " KB data sources: " << micros(renderTime) << " us/render, "
+                  << micros(parseTime) << " us/parse" << std::endl;
+    }
+}
 
 } // namespace test
 } // namespace APLClient
@@ -0,0 +1,211 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "APLClient/AplCoreCaseMapping.h"
+#include "APLClient/AplCoreConnectionManager.h"
+#include "APLClient/AplCoreLocaleMethods.h"
+#include "APLClient/AplCoreLocaleMethodsCache.h"
+#include "MockAplOptionsInterface.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace APLClient {
+namespace test {
+
+using namespace ::testing;
+
+/// Number of bindings evaluated by the benchmark.
+static const int BENCHMARK_BINDINGS = 2000;
+
+/// Number of distinct values bound by the benchmark.
+static const int BENCHMARK_VALUES = 50;
+
+class AplCoreLocaleMethodsTest : public ::testing::Test {
+public:
+    /// Set up the test harness for running a test.
+    void SetUp() override;
+
+protected:
+    /**
+     * Maps a string natively, failing the test if it is not covered.
+     */
+    static std::string toCase(const std::string& value, const std::string& locale, bool upper) {
+        std::string result;
+        EXPECT_TRUE(AplCoreCaseMapping::toCase(value, locale, upper, result));
+        return result;
+    }
+
+    /**
+     * Answers a "localeMethod" message the way the viewhost does, upper casing ASCII values.
+     */
+    void replyFromViewhost(const std::string& message) {
+        m_viewhostRequests++;
+        rapidjson::Document request;
+        request.Parse(message.c_str());
+
+        std::string value = request["payload"]["value"].GetString();
+        for (auto& c : value) {
+            c = static_cast<char>(std::toupper(c));
+        }
+
+        rapidjson::Document reply(rapidjson::kObjectType);
+        auto& allocator = reply.GetAllocator();
+        reply.AddMember("type", "localeMethod", allocator);
+        reply.AddMember("seqno", request["seqno"].GetUint(), allocator);
+        rapidjson::Value payload(rapidjson::kObjectType);
+        payload.AddMember("value", value, allocator);
+        reply.AddMember("payload", payload, allocator);
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        reply.Accept(writer);
+        m_aplCoreConnectionManager->shouldHandleMessage(buffer.GetString());
+    }
+
+    std::shared_ptr<MockAplOptionsInterface> m_mockAplOptions;
+
+    AplConfigurationPtr m_aplConfiguration;
+
+    std::shared_ptr<AplCoreConnectionManager> m_aplCoreConnectionManager;
+
+    int m_viewhostRequests = 0;
+};
+
+void AplCoreLocaleMethodsTest::SetUp() {
+    m_mockAplOptions = std::make_shared<NiceMock<MockAplOptionsInterface>>();
+    m_aplConfiguration = std::make_shared<AplConfiguration>(m_mockAplOptions);
+    m_aplCoreConnectionManager = std::make_shared<AplCoreConnectionManager>(m_aplConfiguration);
+    ON_CALL(*m_mockAplOptions, sendMessage(_, _))
+        .WillByDefault(Invoke([this](const std::string&, const std::string& message) { replyFromViewhost(message); }));
+}
+
+TEST_F(AplCoreLocaleMethodsTest, MapsTurkishDottedAndDotlessI) {
+    ASSERT_EQ("\xC4\xB0STANBUL", toCase("istanbul", "tr-TR", true));
+    ASSERT_EQ("ISTANBUL", toCase("istanbul", "en-US", true));
+    ASSERT_EQ("\xC4\xB1sparta izmir", toCase("ISPARTA \xC4\xB0ZM\xC4\xB0R", "tr", false));
+    ASSERT_EQ("i\xCC\x87", toCase("\xC4\xB0", "en", false));
+    ASSERT_EQ("i", toCase("I\xCC\x87", "az", false));
+}
+
+TEST_F(AplCoreLocaleMethodsTest, MapsGermanSharpS) {
+    ASSERT_EQ("STRASSE", toCase("stra\xC3\x9F" "e", "de-DE", true));
+    ASSERT_EQ("\xC3\x9F", toCase("\xE1\xBA\x9E", "de-DE", false));
+}
+
+TEST_F(AplCoreLocaleMethodsTest, MapsGreekFinalSigma) {
+    // ΟΔΥΣΣΕΥΣ lowers to οδυσσευς
+    ASSERT_EQ(
+        "\xCE\xBF\xCE\xB4\xCF\x85\xCF\x83\xCF\x83\xCE\xB5\xCF\x85\xCF\x82",
+        toCase("\xCE\x9F\xCE\x94\xCE\xA5\xCE\xA3\xCE\xA3\xCE\x95\xCE\xA5\xCE\xA3", "el", false));
+    // A sigma on its own is not final
+    ASSERT_EQ("\xCF\x83", toCase("\xCE\xA3", "el", false));
+}
+
+TEST_F(AplCoreLocaleMethodsTest, RemovesGreekAccentsFromUpperCase) {
+    // άλφα upper cases to ΑΛΦΑ in Greek and to ΆΛΦΑ elsewhere
+    ASSERT_EQ("\xCE\x91\xCE\x9B\xCE\xA6\xCE\x91", toCase("\xCE\xAC\xCE\xBB\xCF\x86\xCE\xB1", "el-GR", true));
+    ASSERT_EQ("\xCE\x86\xCE\x9B\xCE\xA6\xCE\x91", toCase("\xCE\xAC\xCE\xBB\xCF\x86\xCE\xB1", "en", true));
+}
+
+TEST_F(AplCoreLocaleMethodsTest, LeavesUncoveredTextToViewhost) {
+    std::string result;
+    ASSERT_FALSE(AplCoreCaseMapping::toCase("abc", "lt", true, result));
+    // Armenian is not covered
+    ASSERT_FALSE(AplCoreCaseMapping::toCase("\xD5\xA1", "en", true, result));
+    // Invalid UTF-8
+    ASSERT_FALSE(AplCoreCaseMapping::toCase("\xC0\x80", "en", true, result));
+    // Scripts without case are covered
+    ASSERT_EQ("\xE6\x97\xA5\xE6\x9C\xAC ABC", toCase("\xE6\x97\xA5\xE6\x9C\xAC abc", "ja-JP", true));
+}
+
+TEST_F(AplCoreLocaleMethodsTest, AsksViewhostOnlyForUncoveredLocales) {
+    auto cache = std::make_shared<AplCoreLocaleMethodsCache>();
+    AplCoreLocaleMethods localeMethods(m_aplCoreConnectionManager, m_aplConfiguration, cache);
+
+    ASSERT_EQ("ABC", localeMethods.toUpperCase("abc", "en-US"));
+    ASSERT_EQ(0, m_viewhostRequests);
+
+    ASSERT_EQ("ABC", localeMethods.toUpperCase("abc", "lt-LT"));
+    ASSERT_EQ("ABC", localeMethods.toUpperCase("abc", "lt-LT"));
+    ASSERT_EQ(1, m_viewhostRequests);
+    ASSERT_EQ(2u, cache->size());
+}
+
+TEST_F(AplCoreLocaleMethodsTest, CacheEvictsLeastRecentlyUsed) {
+    AplCoreLocaleMethodsCache cache(2);
+    std::string result;
+    cache.put("toUpperCase", "en", "a", "A");
+    cache.put("toLowerCase", "en", "a", "a");
+
+    ASSERT_TRUE(cache.get("toUpperCase", "en", "a", result));
+    cache.put("toUpperCase", "tr", "i", "\xC4\xB0");
+
+    ASSERT_TRUE(cache.get("toUpperCase", "en", "a", result));
+    ASSERT_EQ("A", result);
+    ASSERT_FALSE(cache.get("toLowerCase", "en", "a", result));
+    ASSERT_TRUE(cache.get("toUpperCase", "tr", "i", result));
+}
+
+/**
+ * Evaluates upper case bindings through the viewhost, natively and natively with the cache, and reports the bindings
+ * evaluated per second. The viewhost answers in-process, so its cost excludes the WebSocket round-trip.
+ */
+TEST_F(AplCoreLocaleMethodsTest, BindingsBenchmark) {
+    std::vector<std::string> values;
+    for (int i = 0; i < BENCHMARK_VALUES; i++) {
+        values.push_back("Item number " + std::to_string(i));
+    }
+
+    auto run = [&values](AplCoreLocaleMethods& localeMethods, const std::string& locale) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_BINDINGS; i++) {
+            localeMethods.toUpperCase(values[i % BENCHMARK_VALUES], locale);
+        }
+        return std::chrono::steady_clock::now() - start;
+    };
+
+    // Lithuanian is left to the viewhost, as every locale was before the in-process mapping
+    AplCoreLocaleMethods viewhost(m_aplCoreConnectionManager, m_aplConfiguration);
+    auto viewhostTime = run(viewhost, "lt-LT");
+    ASSERT_EQ(BENCHMARK_BINDINGS, m_viewhostRequests);
+
+    AplCoreLocaleMethods native(m_aplCoreConnectionManager, m_aplConfiguration);
+    auto nativeTime = run(native, "en-US");
+
+    AplCoreLocaleMethods cached(
+        m_aplCoreConnectionManager, m_aplConfiguration, std::make_shared<AplCoreLocaleMethodsCache>());
+    auto cachedTime = run(cached, "en-US");
+    ASSERT_EQ(BENCHMARK_BINDINGS, m_viewhostRequests);
+
+    auto report = [](const std::string& name, std::chrono::steady_clock::duration time) {
+        auto micros = std::max<long long>(1, std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+        std::cout << name << ": " << BENCHMARK_BINDINGS * 1000000LL / micros << " bindings/s" << std::endl;
+    };
+    report("viewhost", viewhostTime);
+    report("native", nativeTime);
+    report("native cached", cachedTime);
+}
+
+}  // namespace test
+}  // namespace APLClient
@@ -0,0 +1,89 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "APLClient/AplCoreTextMeasurementCache.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace APLClient {
+namespace test {
+
+using namespace ::testing;
+
+class AplCoreTextMeasurementCacheTest : public ::testing::Test {
+public:
+    /// Set up the test harness for running a test.
+    void SetUp() override;
+
+protected:
+    std::shared_ptr<AplCoreTextMeasurementCache> m_cache;
+};
+
+void AplCoreTextMeasurementCacheTest::SetUp() {
+    m_cache = std::make_shared<AplCoreTextMeasurementCache>(2);
+}
+
+TEST_F(AplCoreTextMeasurementCacheTest, MissesUnknownKey) {
+    apl::LayoutSize size;
+    ASSERT_FALSE(m_cache->get("unknown", size));
+}
+
+TEST_F(AplCoreTextMeasurementCacheTest, ReturnsStoredMeasurement) {
+    m_cache->put("key", {10, 20});
+
+    apl::LayoutSize size;
+    ASSERT_TRUE(m_cache->get("key", size));
+    ASSERT_EQ(10, size.width);
+    ASSERT_EQ(20, size.height);
+}
+
+TEST_F(AplCoreTextMeasurementCacheTest, ReplacesExistingMeasurement) {
+    m_cache->put("key", {10, 20});
+    m_cache->put("key", {30, 40});
+
+    apl::LayoutSize size;
+    ASSERT_TRUE(m_cache->get("key", size));
+    ASSERT_EQ(30, size.width);
+    ASSERT_EQ(40, size.height);
+    ASSERT_EQ(1u, m_cache->size());
+}
+
+TEST_F(AplCoreTextMeasurementCacheTest, EvictsLeastRecentlyUsed) {
+    apl::LayoutSize size;
+    m_cache->put("first", {1, 1});
+    m_cache->put("second", {2, 2});
+
+    // Touch "first" so that "second" becomes the least recently used entry
+    ASSERT_TRUE(m_cache->get("first", size));
+    m_cache->put("third", {3, 3});
+
+    ASSERT_EQ(2u, m_cache->size());
+    ASSERT_TRUE(m_cache->get("first", size));
+    ASSERT_FALSE(m_cache->get("second", size));
+    ASSERT_TRUE(m_cache->get("third", size));
+}
+
+TEST_F(AplCoreTextMeasurementCacheTest, ClearRemovesAllMeasurements) {
+    m_cache->put("key", {10, 20});
+    m_cache->clear();
+
+    apl::LayoutSize size;
+    ASSERT_FALSE(m_cache->get("key", size));
+    ASSERT_EQ(0u, m_cache->size());
+}
+
+}  // namespace test
+}  // namespace APLClient
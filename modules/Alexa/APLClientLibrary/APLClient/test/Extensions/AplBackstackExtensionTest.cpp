@@ -28,6 +28,41 @@ static const std::string EXPECTED_URI = "aplext:backstack:10";
 static const auto EXPECTED_EVENTSOURCE = std::make_shared<apl::ObjectMap>();
 static const auto EXPECTED_EVENTPARAMS = std::make_shared<apl::ObjectMap>();
 
+/// A document with a scrolled container which keeps its position across hibernation.
+static const std::string SCROLLING_DOCUMENT =
+    "{"
+    "  \"type\": \"APL\","
+    "  \"version\": \"1.5\","
+    "  \"mainTemplate\": {"
+    "    \"item\": {"
+    "      \"type\": \"ScrollView\","
+    "      \"id\": \"scroller\","
+    "      \"width\": 400,"
+    "      \"height\": 400,"
+    "      \"item\": {"
+    "        \"type\": \"Frame\","
+    "        \"height\": 2000"
+    "      }"
+    "    }"
+    "  }"
+    "}";
+
+/**
+ * Creates a live document state for @c SCROLLING_DOCUMENT.
+ *
+ * @param estimatedSize The estimated size of the document state.
+ * @return The document state.
+ */
+static AplDocumentStatePtr createLiveDocumentState(size_t estimatedSize = 0) {
+    auto source = std::make_shared<AplDocumentSource>();
+    source->document = SCROLLING_DOCUMENT;
+    source->data = "{}";
+    auto root = apl::RootContext::create(apl::Metrics().size(1024, 800), source->createContent());
+    auto documentState = std::make_shared<AplDocumentState>("token", root, nullptr, source);
+    documentState->estimatedSize = estimatedSize;
+    return documentState;
+}
+
 class MockAplBackstackExtensionObserverInterface : public Backstack::AplBackstackExtensionObserverInterface {
 public:
     MOCK_METHOD1(onRestoreDocumentState, void(AplDocumentStatePtr));
@@ -158,6 +193,79 @@ TEST_F(AplBackstackExtensionTest, handleClearSuccess) {
     ASSERT_FALSE(m_backstackExtension->shouldCacheActiveDocument());
 }
 
+TEST_F(AplBackstackExtensionTest, HibernatesLeastRecentDocumentsOverDocumentLimit) {
+    m_backstackExtension->setCacheLimits(2, 0);
+    std::vector<AplDocumentStatePtr> documentStates;
+    for (int i = 0; i < 4; i++) {
+        auto settings = std::make_shared<apl::ObjectMap>();
+        settings->emplace("backstackId", "Document" + std::to_string(i));
+        m_backstackExtension->applySettings(settings);
+        documentStates.push_back(createLiveDocumentState());
+        m_backstackExtension->addDocumentStateToBackstack(documentStates.back());
+    }
+
+    // The two oldest documents are hibernated, the two most recent ones stay live
+    ASSERT_EQ(2u, m_backstackExtension->getHibernatedDocumentCount());
+    ASSERT_TRUE(documentStates[0]->isHibernated());
+    ASSERT_TRUE(documentStates[1]->isHibernated());
+    ASSERT_FALSE(documentStates[2]->isHibernated());
+    ASSERT_NE(nullptr, documentStates[3]->rootContext);
+
+    // Hibernated documents can still be restored
+    EXPECT_CALL(*m_backstackExtensionObserverInterface, onRestoreDocumentState(documentStates[0])).Times(1);
+    EXPECTED_EVENTPARAMS->emplace("backType", "id");
+    EXPECTED_EVENTPARAMS->emplace("backValue", "Document0");
+    extensionEvent("GoBack");
+    resetEventParams({"backType", "backValue"});
+}
+
+TEST_F(AplBackstackExtensionTest, HibernatesLeastRecentDocumentsOverSizeLimit) {
+    auto settings = std::make_shared<apl::ObjectMap>();
+    settings->emplace("backstackId", "Document");
+    std::vector<AplDocumentStatePtr> documentStates;
+    for (int i = 0; i < 3; i++) {
+        m_backstackExtension->applySettings(settings);
+        documentStates.push_back(createLiveDocumentState(1000));
+        m_backstackExtension->addDocumentStateToBackstack(documentStates.back());
+    }
+    ASSERT_EQ(0u, m_backstackExtension->getHibernatedDocumentCount());
+    ASSERT_FALSE(m_backstackExtension->needsDocumentStateSize());
+
+    // Tightening the limits applies them to the document states already in the backstack
+    m_backstackExtension->setCacheLimits(0, 2500);
+    ASSERT_TRUE(m_backstackExtension->needsDocumentStateSize());
+    ASSERT_EQ(1u, m_backstackExtension->getHibernatedDocumentCount());
+    ASSERT_TRUE(documentStates[0]->isHibernated());
+    ASSERT_EQ(0u, documentStates[0]->estimatedSize);
+    ASSERT_EQ(3u, m_backstackExtension->getDocumentCount());
+    ASSERT_EQ(2000u, m_backstackExtension->getLiveDocumentBytes());
+}
+
+TEST_F(AplBackstackExtensionTest, DocumentWithoutSourceStaysLive) {
+    auto root = apl::RootContext::create(apl::Metrics().size(1024, 800), apl::Content::create(SCROLLING_DOCUMENT));
+    auto documentState = std::make_shared<AplDocumentState>("token", root, nullptr);
+
+    documentState->hibernate();
+    ASSERT_FALSE(documentState->isHibernated());
+    ASSERT_NE(nullptr, documentState->rootContext);
+}
+
+TEST_F(AplBackstackExtensionTest, HibernatedDocumentKeepsComponentState) {
+    auto documentState = createLiveDocumentState();
+    documentState->rootContext->findComponentById("scroller")->update(apl::kUpdateScrollPosition, 300);
+
+    documentState->hibernate();
+    ASSERT_TRUE(documentState->isHibernated());
+    ASSERT_EQ(1u, documentState->componentStates.size());
+
+    ASSERT_EQ(nullptr, documentState->rootContext);
+
+    auto root = apl::RootContext::create(apl::Metrics().size(1024, 800), documentState->source->createContent());
+    documentState->restoreComponentStates(root);
+    auto position = root->findComponentById("scroller")->getCalculated(apl::kPropertyScrollPosition);
+    ASSERT_EQ(300, position.getAbsoluteDimension());
+}
+
 TEST_F(AplBackstackExtensionTest, OnExtensionEventGoBackCountSuccess) {
     EXPECT_CALL(*m_aplCoreExtensionEventCallbackResultInterface, onExtensionEventResult(_, true)).Times(1);
     // apply settings
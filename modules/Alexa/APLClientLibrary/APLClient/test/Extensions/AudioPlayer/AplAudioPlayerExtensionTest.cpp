@@ -315,6 +315,70 @@ TEST_F(AplAudioPlayerExtensionTest,UpdatePlaybackProgressSuccess) {
     ASSERT_EQ(expectedOffset, playbackState->get("offset").asInt());
 }
 
+TEST_F(AplAudioPlayerExtensionTest, UpdatePlaybackProgressQuantizedToGranularity) {
+    std::string expectedStateName = "unitTest";
+    auto settings = std::make_shared<apl::ObjectMap>();
+    settings->emplace("playbackStateName", expectedStateName);
+    m_audioPlayerExtension->applySettings(settings);
+    m_audioPlayerExtension->setPlaybackProgressGranularity(std::chrono::milliseconds(250));
+
+    auto liveObjects = m_audioPlayerExtension->getLiveDataObjects();
+    apl::LiveMap* playbackState = dynamic_cast<apl::LiveMap*>(liveObjects.find(expectedStateName)->second.get());
+
+    // offsets are rounded down to the granularity
+    m_audioPlayerExtension->updatePlaybackProgress(1240);
+    ASSERT_EQ(1000, playbackState->get("offset").asInt());
+    m_audioPlayerExtension->updatePlaybackProgress(1250);
+    ASSERT_EQ(1250, playbackState->get("offset").asInt());
+
+    // player activity changes publish the exact offset
+    m_audioPlayerExtension->updatePlayerActivity("PAUSED", 1377);
+    ASSERT_EQ(1377, playbackState->get("offset").asInt());
+}
+
+TEST_F(AplAudioPlayerExtensionTest, UpdatePlaybackProgressNeverStepsBack) {
+    std::string expectedStateName = "unitTest";
+    auto settings = std::make_shared<apl::ObjectMap>();
+    settings->emplace("playbackStateName", expectedStateName);
+    m_audioPlayerExtension->applySettings(settings);
+    m_audioPlayerExtension->setPlaybackProgressGranularity(std::chrono::milliseconds(250));
+
+    auto liveObjects = m_audioPlayerExtension->getLiveDataObjects();
+    apl::LiveMap* playbackState = dynamic_cast<apl::LiveMap*>(liveObjects.find(expectedStateName)->second.get());
+
+    // a lower progress report keeps the published offset
+    m_audioPlayerExtension->updatePlayerActivity("PLAYING", 0);
+    m_audioPlayerExtension->updatePlaybackProgress(1500);
+    ASSERT_EQ(1500, playbackState->get("offset").asInt());
+    m_audioPlayerExtension->updatePlaybackProgress(1490);
+    ASSERT_EQ(1500, playbackState->get("offset").asInt());
+
+    // player activity changes publish the exact offset, even when lower
+    m_audioPlayerExtension->updatePlayerActivity("PLAYING", 200);
+    ASSERT_EQ(200, playbackState->get("offset").asInt());
+    m_audioPlayerExtension->updatePlaybackProgress(500);
+    ASSERT_EQ(500, playbackState->get("offset").asInt());
+}
+
+TEST_F(AplAudioPlayerExtensionTest, NextPlaybackProgressDelayExtrapolatesOffset) {
+    // no progress is due while audio is not playing
+    ASSERT_EQ(std::chrono::milliseconds::max(), m_audioPlayerExtension->getNextPlaybackProgressDelay());
+
+    // every tick updates the progress without a granularity
+    m_audioPlayerExtension->updatePlayerActivity("PLAYING", 1000);
+    ASSERT_EQ(std::chrono::milliseconds::zero(), m_audioPlayerExtension->getNextPlaybackProgressDelay());
+
+    // the next update is due when the extrapolated offset reaches the next multiple of the granularity
+    m_audioPlayerExtension->setPlaybackProgressGranularity(std::chrono::milliseconds(1000));
+    m_audioPlayerExtension->updatePlaybackProgress(1900);
+    auto delay = m_audioPlayerExtension->getNextPlaybackProgressDelay();
+    ASSERT_LE(delay, std::chrono::milliseconds(100));
+    ASSERT_GT(delay, std::chrono::milliseconds(50));
+
+    m_audioPlayerExtension->updatePlayerActivity("STOPPED", 1950);
+    ASSERT_EQ(std::chrono::milliseconds::max(), m_audioPlayerExtension->getNextPlaybackProgressDelay());
+}
+
 TEST_F(AplAudioPlayerExtensionTest,UpdatePlayerActivitySuccess) {
     // applySettings
     std::string expectedStateName = "unitTest";
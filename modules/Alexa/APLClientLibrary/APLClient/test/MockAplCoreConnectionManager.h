@@ -27,7 +27,7 @@ namespace test {
             MOCK_METHOD2(blockingSend, rapidjson::Document(AplCoreViewhostMessage& message,
                     const std::chrono::milliseconds& timeout));
             MOCK_METHOD1(setSupportedViewports, void(const std::string&));
-            MOCK_METHOD2(setContent, void(const apl::ContentPtr, const std::string&));
+            MOCK_METHOD4(setContent, void(const apl::ContentPtr, const std::string&, size_t, AplDocumentSourcePtr));
         };
 } // namespace test
 } //namespace APLClient
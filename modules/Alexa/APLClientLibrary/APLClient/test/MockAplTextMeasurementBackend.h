@@ -0,0 +1,37 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace APLClient {
+namespace test {
+
+class MockAplTextMeasurementBackend : public AplTextMeasurementBackendInterface {
+public:
+    MOCK_METHOD6(
+        measure,
+        bool(
+            apl::Component* component,
+            float width,
+            apl::MeasureMode widthMode,
+            float height,
+            apl::MeasureMode heightMode,
+            apl::LayoutSize& size));
+    MOCK_METHOD4(baseline, bool(apl::Component* component, float width, float height, float& baseline));
+};
+
+}  // namespace test
+}  // namespace APLClient
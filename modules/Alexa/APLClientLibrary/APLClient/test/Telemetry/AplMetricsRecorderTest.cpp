@@ -177,6 +177,19 @@ TEST_F(AplMetricsRecorderTest, CreatesSegmentCounters) {
     m_metricsRecorder->flush();
 }
 
+TEST_F(AplMetricsRecorderTest, SetCountersReportTheLatestSample) {
+    auto counter = m_metricsRecorder->createCounter(m_document, "MyCounter");
+
+    counter->incrementBy(42);
+    counter->set(7);
+    counter->set(3);
+
+    EXPECT_CALL(*m_mockSink, reportCounter(IsEmpty(), Eq("MyCounter"), Eq(3UL)))
+        .Times(1);
+
+    m_metricsRecorder->flush();
+}
+
 TEST_F(AplMetricsRecorderTest, ReportsZeroCountersIfRequested) {
     auto counter = m_metricsRecorder->createCounter(m_document, "MyCounter", true);
 
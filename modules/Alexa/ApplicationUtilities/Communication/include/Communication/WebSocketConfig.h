@@ -52,6 +52,7 @@
 #include <websocketpp/transport/asio/security/tls.hpp>
 #endif
 
+#include "WebSocketDeflateExtension.h"
 #include "WebSocketSDKLogger.h"
 
 namespace alexaSmartScreenSDK {
@@ -96,6 +97,9 @@ struct WebSocketConfig : public websocketpp::config::asio {
     /// Random number generator type
     typedef base::rng_type rng_type;
 
+    /// The permessage-deflate extension, offering configurable compression
+    typedef WebSocketDeflateExtension permessage_deflate_type;
+
     /**
      * Specifies the transport configuration which will be used by websocketspp
      *
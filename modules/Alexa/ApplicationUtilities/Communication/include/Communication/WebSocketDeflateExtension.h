@@ -0,0 +1,129 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_COMMUNICATION_INCLUDE_COMMUNICATION_WEBSOCKETDEFLATEEXTENSION_H
+#define ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_COMMUNICATION_INCLUDE_COMMUNICATION_WEBSOCKETDEFLATEEXTENSION_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <zlib.h>
+
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
+
+namespace alexaSmartScreenSDK {
+namespace communication {
+
+/**
+ * The permessage-deflate extension used by WebSocketPP.
+ *
+ * Negotiation is delegated to the WebSocketPP implementation. Compression is done here, so that the compression level
+ * can be configured and the compressed bytes and compression time can be counted. Decompression is done here as well,
+ * so that the zlib states of the WebSocketPP implementation are never allocated.
+ *
+ * WebSocketPP creates one instance per connection, so the level and the counters are shared by all connections.
+ */
+class WebSocketDeflateExtension {
+public:
+    /// The result of negotiating the extension.
+    using NegotiationResult = std::pair<websocketpp::lib::error_code, std::string>;
+
+    /**
+     * Constructor.
+     */
+    WebSocketDeflateExtension();
+
+    /**
+     * Destructor.
+     */
+    ~WebSocketDeflateExtension();
+
+    /**
+     * Sets the zlib compression level of connections opened from now on.
+     *
+     * @param level The level, from 1 (fastest) to 9 (smallest), or @c Z_DEFAULT_COMPRESSION.
+     */
+    static void setCompressionLevel(int level);
+
+    /**
+     * @return The size of all compressed messages, as written on the wire.
+     */
+    static uint64_t getCompressedBytes();
+
+    /**
+     * @return The time spent compressing messages.
+     */
+    static std::chrono::nanoseconds getCompressionTime();
+
+    /// @name permessage-deflate extension interface of WebSocketPP
+    /// @{
+    bool is_implemented() const;
+    bool is_enabled() const;
+    std::string generate_offer() const;
+    websocketpp::lib::error_code validate_offer(websocketpp::http::attribute_list const& response);
+    NegotiationResult negotiate(websocketpp::http::attribute_list const& offer);
+    websocketpp::lib::error_code init(bool isServer);
+    websocketpp::lib::error_code compress(std::string const& in, std::string& out);
+    websocketpp::lib::error_code decompress(uint8_t const* buffer, size_t length, std::string& out);
+    /// @}
+
+private:
+    /// The configuration of the WebSocketPP implementation, which needs none.
+    struct DelegateConfig {};
+
+    /// The WebSocketPP implementation, used for negotiation only.
+    websocketpp::extensions::permessage_deflate::enabled<DelegateConfig> m_delegate;
+
+    /// The zlib compression state.
+    z_stream m_deflateState;
+
+    /// Whether @c m_deflateState was initialized.
+    bool m_deflateInitialized;
+
+    /// The zlib decompression state.
+    z_stream m_inflateState;
+
+    /// Whether @c m_inflateState was initialized.
+    bool m_inflateInitialized;
+
+    /// The window size negotiated for messages sent by the server, in bits.
+    int m_windowBits;
+
+    /// Whether the server may not reuse the compression context between messages.
+    bool m_noContextTakeover;
+
+    /// The compression output buffer.
+    std::unique_ptr<unsigned char[]> m_buffer;
+
+    /// The decompression output buffer, apart from @c m_buffer as messages are sent and received concurrently.
+    std::unique_ptr<unsigned char[]> m_inflateBuffer;
+
+    /// The compression level of new connections.
+    static std::atomic<int> s_compressionLevel;
+
+    /// The size of all compressed messages.
+    static std::atomic<uint64_t> s_compressedBytes;
+
+    /// The time spent compressing messages, in nanoseconds.
+    static std::atomic<uint64_t> s_compressionTime;
+};
+
+}  // namespace communication
+}  // namespace alexaSmartScreenSDK
+
+#endif  // ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_COMMUNICATION_INCLUDE_COMMUNICATION_WEBSOCKETDEFLATEEXTENSION_H
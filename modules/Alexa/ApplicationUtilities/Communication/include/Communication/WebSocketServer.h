@@ -16,8 +16,16 @@
 #ifndef ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_COMMUNICATION_INCLUDE_COMMUNICATION_WEBSOCKETSERVER_H_
 #define ALEXA_SMART_SCREEN_SDK_APPLICATIONUTILITIES_COMMUNICATION_INCLUDE_COMMUNICATION_WEBSOCKETSERVER_H_
 
-#include <string>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <websocketpp/server.hpp>
 #ifdef ENABLE_WEBSOCKET_SSL
@@ -41,24 +49,47 @@ namespace communication {
  is provided a callback, which is called when the the request is complete. In cases where the input is required for e.g.
  for read, ASIO returns control flow immediately, calling the supplied callback at some later time.
 
+ The ASIO loop is run by a pool of threads, see @c setThreadPoolSize. WebSocketPP runs the handlers of a connection on
+ a strand, and the tasks of this class for a connection run on a strand of their own, so each connection is served in
+ order while different connections are served in parallel. Received messages are moved to the listener rather than
+ copied, so it can hand them to its own thread cheaply.
+
  Top-level sequence expressed serially, session operations are handled by the WebSocketPP library:
 
  Setup listener socket on supplied port
  Wait for connection
  Get notified of new connection - add it to the set of connections
 
+ The first client to connect is the primary client. When it disconnects, the longest connected client becomes the
+ primary client. The observer is notified when the first client connects and when the last client disconnects, so the
+ session with the GUI is set up once however many clients share it.
+
  When data is received from a client, onMessage will be called with the message payload
 
- When sending a message to clients, the data is sent to each connection which is currently open.
+ When sending a message to clients, the data is queued for each connection which should receive it and the queues are
+ drained on the strand of each connection.
 
  When a client disconnects for any reason, onConnectionClose is called - the connection is removed from the
   set of connections
 
  Additional notes
  ----------------
- This implementation supports multiple clients; writes will be fanned out to all clients, reads are accepted
- from any client. The connection_hdl descriptor identifies the client which is opening/closing a connection or
- sending a message.
+ This implementation supports multiple clients, for example a main display and a mirror, reads are accepted from any
+ client. The connection_hdl descriptor identifies the client which is opening/closing a connection or sending a
+ message.
+
+ A client claims a window by sending a message carrying its "windowId". Messages carrying a "windowId" are only
+ written to the clients which claimed that window, or to the primary client if none did. Other messages are written to
+ every client. Requests, which expect a single reply, are written to one client only: the primary client, or the
+ longest connected client claiming their window if the primary client does not. See @c setRequestTypes.
+
+ Messages are compressed with permessage-deflate when the client offers it and the message is large enough for
+ compression to pay off. Messages can be sent in binary frames, which carry the same UTF-8 JSON but spare the client
+ the validation of text frames.
+
+ Each connection has its own bounded queue. Messages are handed to WebSocketPP only while the data it has buffered for
+ the connection stays below a limit, so a slow client only delays its own messages. A client whose queue overflows is
+ closed, as dropping single messages would leave it with an inconsistent view; it can reconnect and start afresh.
 */
 
 /**
@@ -89,6 +120,54 @@ public:
         const std::string& certificate,
         const std::string& privateKey);
 
+    /**
+     * Sets the number of threads running the ASIO loop, including the thread calling @c start. Must be called before
+     * @c start.
+     *
+     * @param size The number of threads, at least 1.
+     */
+    void setThreadPoolSize(size_t size);
+
+    /**
+     * Configures the compression of messages. Applies to connections opened from now on.
+     *
+     * @param enabled Whether messages are compressed when the client supports it.
+     * @param level The zlib compression level, from 1 (fastest) to 9 (smallest), or -1 for the zlib default.
+     * @param threshold The size of the smallest message to compress, in bytes.
+     */
+    void setCompression(bool enabled, int level, size_t threshold);
+
+    /**
+     * Configures whether messages are sent in binary frames rather than text frames.
+     *
+     * @param enabled Whether messages are sent in binary frames.
+     */
+    void setBinaryFrames(bool enabled);
+
+    /**
+     * Sets the types of the requests, the messages to which a single reply is expected. A message is a request when
+     * its top level "type", or the "type" leading its top level "payload" object, is one of these. Must be called
+     * before @c start.
+     *
+     * @param types The types of the requests.
+     */
+    void setRequestTypes(const std::set<std::string>& types);
+
+    /**
+     * @return The size of the messages handed to WebSocketPP, before compression.
+     */
+    uint64_t getPayloadBytesSent() const;
+
+    /**
+     * @return The size of the messages handed to WebSocketPP, after compression.
+     */
+    uint64_t getWireBytesSent() const;
+
+    /**
+     * @return The time spent compressing messages.
+     */
+    std::chrono::nanoseconds getCompressionTime() const;
+
     /// @name MessagingServerInterface Functions
     /// @{
     bool start() override;
@@ -106,6 +185,97 @@ private:
     typedef websocketpp::server<WebSocketConfig> server;
     using connection_hdl = websocketpp::connection_hdl;
 
+    /**
+     * The state of an open connection.
+     */
+    struct Connection {
+        /**
+         * Constructor.
+         *
+         * @param ioService The ASIO loop serving the connection.
+         */
+        explicit Connection(asio::io_service& ioService) : strand{ioService} {
+        }
+
+        /// The connection handle.
+        connection_hdl handle;
+
+        /// Orders the tasks of this class for the connection.
+        asio::io_service::strand strand;
+
+        /// Messages waiting to be handed to WebSocketPP.
+        std::deque<std::shared_ptr<const std::string>> queue;
+
+        /// The total size of the messages in @c queue.
+        size_t queuedBytes = 0;
+
+        /// Whether a drain of @c queue is scheduled on the ASIO thread.
+        bool drainScheduled = false;
+
+        /// Whether the connection is being closed because its queue overflowed.
+        bool overflowed = false;
+
+        /// The windows claimed by the client.
+        std::set<std::string> windowIds;
+
+        /// Whether the client agreed to compress messages.
+        bool compressionNegotiated = false;
+
+        /// The position of the connection in the order the connections were opened.
+        uint64_t openOrder = 0;
+    };
+
+    /**
+     * The parts of a message used to route it.
+     */
+    struct Route {
+        /// The top level "windowId" of the message, empty if it has none.
+        std::string windowId;
+
+        /// Whether the message is a request.
+        bool isRequest = false;
+    };
+
+    /**
+     * Queues a message for a connection and schedules the queue to be drained.
+     *
+     * @param connection The connection.
+     * @param message The message.
+     * @note Must be called with @c m_connectionsMutex held.
+     */
+    void enqueue(const std::shared_ptr<Connection>& connection, const std::shared_ptr<const std::string>& message);
+
+    /**
+     * Hands queued messages of a connection to WebSocketPP while it has room for them. Called on the strand of
+     * the connection.
+     *
+     * @param connection The connection.
+     */
+    void drain(const std::shared_ptr<Connection>& connection);
+
+    /**
+     * Closes a connection whose queue overflowed. Called on the strand of the connection.
+     *
+     * @param connection The connection.
+     */
+    void closeOverflowedConnection(const std::shared_ptr<Connection>& connection);
+
+    /**
+     * Extracts the top level "windowId" of a JSON message, without parsing more of the message than needed.
+     *
+     * @param payload The message.
+     * @return The window id, or an empty string if the message has none.
+     */
+    static std::string extractWindowId(const std::string& payload);
+
+    /**
+     * Extracts the route of a JSON message, without parsing more of the message than needed.
+     *
+     * @param payload The message.
+     * @return The route of the message.
+     */
+    Route extractRoute(const std::string& payload) const;
+
     /**
      * Callback from WebSocket server when a connection is opened.
      *
@@ -143,6 +313,24 @@ private:
      */
     bool onValidate(connection_hdl connectionHdl);
 
+    /// The number of threads running the ASIO loop.
+    size_t m_threadPoolSize;
+
+    /// Whether messages are compressed when the client supports it.
+    std::atomic_bool m_compressionEnabled{true};
+
+    /// The size of the smallest message to compress.
+    std::atomic<size_t> m_compressionThreshold;
+
+    /// Whether messages are sent in binary frames.
+    std::atomic_bool m_binaryFrames{false};
+
+    /// The size of the messages handed to WebSocketPP.
+    std::atomic<uint64_t> m_payloadBytesSent{0};
+
+    /// The size of the messages handed to WebSocketPP uncompressed.
+    std::atomic<uint64_t> m_uncompressedBytesSent{0};
+
     /// Indicates whether the server was successfully initialised
     std::atomic_bool m_initialised{false};
 
@@ -152,8 +340,20 @@ private:
     /// Reference to a message listener to be called when a new message is received
     std::shared_ptr<smartScreenSDKInterfaces::MessageListenerInterface> m_messageListener;
 
-    /// Reference to current session
-    connection_hdl m_connection;
+    /// Guards @c m_connections and the state of each connection.
+    std::mutex m_connectionsMutex;
+
+    /// The open connections.
+    std::map<connection_hdl, std::shared_ptr<Connection>, std::owner_less<connection_hdl>> m_connections;
+
+    /// The primary connection, @c nullptr when no connection is open.
+    std::shared_ptr<Connection> m_primaryConnection;
+
+    /// The position of the next opened connection in the order the connections were opened.
+    uint64_t m_nextOpenOrder = 0;
+
+    /// The types of the requests.
+    std::set<std::string> m_requestTypes;
 
     /// The websocket ssl certificate authority file
     std::string m_certificateAuthorityFile;
@@ -0,0 +1,189 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "Communication/WebSocketDeflateExtension.h"
+
+namespace alexaSmartScreenSDK {
+namespace communication {
+
+namespace deflateError = websocketpp::extensions::permessage_deflate::error;
+
+/// Size of the compression output buffer.
+static const size_t BUFFER_SIZE = 16 * 1024;
+
+/// The default and largest window size, in bits.
+static const int MAX_WINDOW_BITS = 15;
+
+/// The smallest window size zlib supports for raw deflate, in bits.
+static const int MIN_WINDOW_BITS = 9;
+
+/// The zlib memory level, matching WebSocketPP.
+static const int MEMORY_LEVEL = 4;
+
+/// The parameter of the negotiated response disabling context takeover by the server.
+static const std::string SERVER_NO_CONTEXT_TAKEOVER = "server_no_context_takeover";
+
+/// The parameter of the negotiated response limiting the window of the server.
+static const std::string SERVER_MAX_WINDOW_BITS = "server_max_window_bits=";
+
+/// The empty message as sent by WebSocketPP, an empty stored block followed by the trailer removed before sending.
+static const char EMPTY_MESSAGE[] = {0x02, 0x00, 0x00, 0x00, static_cast<char>(0xff), static_cast<char>(0xff)};
+
+/// The size of the trailer WebSocketPP removes from compressed messages before sending them.
+static const size_t TRAILER_SIZE = 4;
+
+std::atomic<int> WebSocketDeflateExtension::s_compressionLevel{Z_DEFAULT_COMPRESSION};
+std::atomic<uint64_t> WebSocketDeflateExtension::s_compressedBytes{0};
+std::atomic<uint64_t> WebSocketDeflateExtension::s_compressionTime{0};
+
+WebSocketDeflateExtension::WebSocketDeflateExtension() :
+        m_deflateInitialized{false},
+        m_inflateInitialized{false},
+        m_windowBits{MAX_WINDOW_BITS},
+        m_noContextTakeover{false} {
+    std::memset(&m_deflateState, 0, sizeof(m_deflateState));
+    std::memset(&m_inflateState, 0, sizeof(m_inflateState));
+}
+
+WebSocketDeflateExtension::~WebSocketDeflateExtension() {
+    if (m_deflateInitialized) {
+        deflateEnd(&m_deflateState);
+    }
+    if (m_inflateInitialized) {
+        inflateEnd(&m_inflateState);
+    }
+}
+
+void WebSocketDeflateExtension::setCompressionLevel(int level) {
+    s_compressionLevel = level;
+}
+
+uint64_t WebSocketDeflateExtension::getCompressedBytes() {
+    return s_compressedBytes;
+}
+
+std::chrono::nanoseconds WebSocketDeflateExtension::getCompressionTime() {
+    return std::chrono::nanoseconds(s_compressionTime);
+}
+
+bool WebSocketDeflateExtension::is_implemented() const {
+    return true;
+}
+
+bool WebSocketDeflateExtension::is_enabled() const {
+    return m_delegate.is_enabled();
+}
+
+std::string WebSocketDeflateExtension::generate_offer() const {
+    return m_delegate.generate_offer();
+}
+
+websocketpp::lib::error_code WebSocketDeflateExtension::validate_offer(
+    websocketpp::http::attribute_list const& response) {
+    return m_delegate.validate_offer(response);
+}
+
+WebSocketDeflateExtension::NegotiationResult WebSocketDeflateExtension::negotiate(
+    websocketpp::http::attribute_list const& offer) {
+    auto result = m_delegate.negotiate(offer);
+    if (!result.first) {
+        // Compress with the parameters the delegate agreed to
+        m_noContextTakeover = result.second.find(SERVER_NO_CONTEXT_TAKEOVER) != std::string::npos;
+        auto windowBits = result.second.find(SERVER_MAX_WINDOW_BITS);
+        if (windowBits != std::string::npos) {
+            m_windowBits = std::atoi(result.second.c_str() + windowBits + SERVER_MAX_WINDOW_BITS.size());
+            m_windowBits = std::max(MIN_WINDOW_BITS, std::min(MAX_WINDOW_BITS, m_windowBits));
+        }
+    }
+    return result;
+}
+
+websocketpp::lib::error_code WebSocketDeflateExtension::init(bool) {
+    // The delegate is not initialized, as it would allocate zlib states which are not used
+    int result = deflateInit2(
+        &m_deflateState, s_compressionLevel, Z_DEFLATED, -m_windowBits, MEMORY_LEVEL, Z_DEFAULT_STRATEGY);
+    if (result != Z_OK) {
+        return deflateError::make_error_code(deflateError::zlib_error);
+    }
+    m_deflateInitialized = true;
+
+    // The largest window decompresses messages of any window size the client chose
+    result = inflateInit2(&m_inflateState, -MAX_WINDOW_BITS);
+    if (result != Z_OK) {
+        return deflateError::make_error_code(deflateError::zlib_error);
+    }
+    m_inflateInitialized = true;
+
+    m_buffer.reset(new unsigned char[BUFFER_SIZE]);
+    m_inflateBuffer.reset(new unsigned char[BUFFER_SIZE]);
+    return websocketpp::lib::error_code();
+}
+
+websocketpp::lib::error_code WebSocketDeflateExtension::compress(std::string const& in, std::string& out) {
+    if (!m_deflateInitialized) {
+        return deflateError::make_error_code(deflateError::uninitialized);
+    }
+
+    if (in.empty()) {
+        out.append(EMPTY_MESSAGE, sizeof(EMPTY_MESSAGE));
+        return websocketpp::lib::error_code();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto initialSize = out.size();
+
+    m_deflateState.avail_in = static_cast<uInt>(in.size());
+    m_deflateState.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    do {
+        m_deflateState.avail_out = BUFFER_SIZE;
+        m_deflateState.next_out = m_buffer.get();
+        deflate(&m_deflateState, m_noContextTakeover ? Z_FULL_FLUSH : Z_SYNC_FLUSH);
+        out.append(reinterpret_cast<char*>(m_buffer.get()), BUFFER_SIZE - m_deflateState.avail_out);
+    } while (m_deflateState.avail_out == 0);
+
+    auto compressedSize = out.size() - initialSize;
+    s_compressedBytes += compressedSize > TRAILER_SIZE ? compressedSize - TRAILER_SIZE : 0;
+    s_compressionTime +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return websocketpp::lib::error_code();
+}
+
+websocketpp::lib::error_code WebSocketDeflateExtension::decompress(
+    uint8_t const* buffer,
+    size_t length,
+    std::string& out) {
+    if (!m_inflateInitialized) {
+        return deflateError::make_error_code(deflateError::uninitialized);
+    }
+
+    m_inflateState.avail_in = static_cast<uInt>(length);
+    m_inflateState.next_in = const_cast<Bytef*>(buffer);
+    do {
+        m_inflateState.avail_out = BUFFER_SIZE;
+        m_inflateState.next_out = m_inflateBuffer.get();
+        int result = inflate(&m_inflateState, Z_SYNC_FLUSH);
+        if (result == Z_NEED_DICT || result == Z_DATA_ERROR || result == Z_MEM_ERROR) {
+            return deflateError::make_error_code(deflateError::zlib_error);
+        }
+        out.append(reinterpret_cast<char*>(m_inflateBuffer.get()), BUFFER_SIZE - m_inflateState.avail_out);
+    } while (m_inflateState.avail_out == 0);
+    return websocketpp::lib::error_code();
+}
+
+}  // namespace communication
+}  // namespace alexaSmartScreenSDK
@@ -13,9 +13,12 @@
  * permissions and limitations under the License.
  */
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include <AVSCommon/Utils/Logger/Logger.h>
+#include <rapidjson/reader.h>
 
 #include "Communication/WebSocketServer.h"
 
@@ -37,7 +40,179 @@ using namespace websocketpp::lib::placeholders;
 using server = websocketpp::server<WebSocketConfig>;
 using connection_hdl = websocketpp::connection_hdl;
 
-WebSocketServer::WebSocketServer(const std::string& interface, const unsigned short port) {
+/// The maximum number of clients connected at the same time.
+static const size_t MAX_CONNECTIONS = 8;
+
+/// The maximum number of messages queued for a connection.
+static const size_t MAX_QUEUED_MESSAGES = 1024;
+
+/// The maximum size of the messages queued for a connection.
+static const size_t MAX_QUEUED_BYTES = 16 * 1024 * 1024;
+
+/// The size of the data WebSocketPP may have buffered for a connection before the queue stops being drained.
+static const size_t MAX_BUFFERED_BYTES = 1024 * 1024;
+
+/// How long to wait before draining a queue again once WebSocketPP buffered enough data for the connection.
+static const long DRAIN_RETRY_INTERVAL_MS = 5;
+
+/// The number of threads running the ASIO loop by default.
+static const size_t DEFAULT_THREAD_POOL_SIZE = 2;
+
+/// The size of the smallest message compressed by default, below which compression saves little.
+static const size_t DEFAULT_COMPRESSION_THRESHOLD = 1024;
+
+/// The name of the permessage-deflate extension.
+static const std::string PERMESSAGE_DEFLATE("permessage-deflate");
+
+/// The header carrying the extensions agreed on during the handshake.
+static const std::string EXTENSIONS_HEADER("Sec-WebSocket-Extensions");
+
+/// The key of the window id in messages.
+static const std::string WINDOW_ID_KEY("windowId");
+
+/// The key of the type in messages.
+static const std::string TYPE_KEY("type");
+
+/// The key of the payload in messages.
+static const std::string PAYLOAD_KEY("payload");
+
+/**
+ * A rapidjson SAX handler capturing the top level "windowId" and types of a message, stopping the parse once they are
+ * found. The type of the payload is only looked for as the first member of the top level "payload" object.
+ */
+class RouteHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, RouteHandler> {
+public:
+    /**
+     * Constructor.
+     *
+     * @param findTypes Whether the types are looked for, or only the window id.
+     */
+    explicit RouteHandler(bool findTypes) : m_typeFound{!findTypes}, m_payloadTypeFound{!findTypes} {
+    }
+
+    bool Default() {
+        if (m_expected == Expected::PAYLOAD || m_expected == Expected::PAYLOAD_FIRST_KEY ||
+            m_expected == Expected::PAYLOAD_TYPE) {
+            m_payloadTypeFound = true;
+        }
+        m_expected = Expected::NONE;
+        return !isComplete();
+    }
+
+    bool StartObject() {
+        m_depth++;
+        if (m_expected == Expected::PAYLOAD && m_depth == 2) {
+            m_expected = Expected::PAYLOAD_FIRST_KEY;
+            return true;
+        }
+        return Default();
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        m_depth--;
+        return Default();
+    }
+
+    bool StartArray() {
+        m_depth++;
+        return Default();
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        m_depth--;
+        return Default();
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        if (m_expected == Expected::PAYLOAD_FIRST_KEY) {
+            bool isType = TYPE_KEY.compare(0, std::string::npos, str, length) == 0;
+            m_expected = isType ? Expected::PAYLOAD_TYPE : Expected::NONE;
+            m_payloadTypeFound = m_payloadTypeFound || !isType;
+        } else if (m_depth == 1 && WINDOW_ID_KEY.compare(0, std::string::npos, str, length) == 0) {
+            m_expected = Expected::WINDOW_ID;
+        } else if (m_depth == 1 && TYPE_KEY.compare(0, std::string::npos, str, length) == 0) {
+            m_expected = Expected::TYPE;
+        } else if (m_depth == 1 && PAYLOAD_KEY.compare(0, std::string::npos, str, length) == 0) {
+            m_expected = Expected::PAYLOAD;
+        } else {
+            m_expected = Expected::NONE;
+        }
+        return !isComplete();
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        switch (m_expected) {
+            case Expected::WINDOW_ID:
+                windowId.assign(str, length);
+                m_windowIdFound = true;
+                break;
+            case Expected::TYPE:
+                type.assign(str, length);
+                m_typeFound = true;
+                break;
+            case Expected::PAYLOAD_TYPE:
+                payloadType.assign(str, length);
+                m_payloadTypeFound = true;
+                break;
+            default:
+                return Default();
+        }
+        m_expected = Expected::NONE;
+        return !isComplete();
+    }
+
+    /// The window id found, if any.
+    std::string windowId;
+
+    /// The top level type found, if any.
+    std::string type;
+
+    /// The type of the payload found, if any.
+    std::string payloadType;
+
+private:
+    /// The value expected next.
+    enum class Expected {
+        /// No value of interest.
+        NONE,
+        /// The top level window id.
+        WINDOW_ID,
+        /// The top level type.
+        TYPE,
+        /// The top level payload.
+        PAYLOAD,
+        /// The first key of the top level payload object.
+        PAYLOAD_FIRST_KEY,
+        /// The type of the top level payload object.
+        PAYLOAD_TYPE
+    };
+
+    /**
+     * @return Whether every value looked for was found, or cannot be found any more.
+     */
+    bool isComplete() const {
+        return m_windowIdFound && m_typeFound && m_payloadTypeFound;
+    }
+
+    /// The nesting depth of the current value.
+    int m_depth = 0;
+
+    /// The value expected next.
+    Expected m_expected = Expected::NONE;
+
+    /// Whether the window id was found.
+    bool m_windowIdFound = false;
+
+    /// Whether the top level type was found, or is not looked for.
+    bool m_typeFound;
+
+    /// Whether the type of the payload was found, is not looked for, or cannot be found any more.
+    bool m_payloadTypeFound;
+};
+
+WebSocketServer::WebSocketServer(const std::string& interface, const unsigned short port) :
+        m_threadPoolSize{DEFAULT_THREAD_POOL_SIZE},
+        m_compressionThreshold{DEFAULT_COMPRESSION_THRESHOLD} {
     websocketpp::lib::error_code errorCode;
     m_webSocketServer.init_asio(errorCode);
     if (errorCode) {
@@ -82,6 +257,37 @@ void WebSocketServer::setCertificateFile(
     m_privateKeyFile = privateKey;
 }
 
+void WebSocketServer::setThreadPoolSize(size_t size) {
+    m_threadPoolSize = std::max<size_t>(1, size);
+}
+
+void WebSocketServer::setCompression(bool enabled, int level, size_t threshold) {
+    ACSDK_INFO(LX("setCompression").d("enabled", enabled).d("level", level).d("threshold", threshold));
+    m_compressionEnabled = enabled;
+    m_compressionThreshold = threshold;
+    WebSocketDeflateExtension::setCompressionLevel(level);
+}
+
+void WebSocketServer::setBinaryFrames(bool enabled) {
+    m_binaryFrames = enabled;
+}
+
+void WebSocketServer::setRequestTypes(const std::set<std::string>& types) {
+    m_requestTypes = types;
+}
+
+uint64_t WebSocketServer::getPayloadBytesSent() const {
+    return m_payloadBytesSent;
+}
+
+uint64_t WebSocketServer::getWireBytesSent() const {
+    return m_uncompressedBytesSent + WebSocketDeflateExtension::getCompressedBytes();
+}
+
+std::chrono::nanoseconds WebSocketServer::getCompressionTime() const {
+    return WebSocketDeflateExtension::getCompressionTime();
+}
+
 bool WebSocketServer::start() {
     if (!m_initialised) {
         ACSDK_ERROR(LX("startFailed").d("reason", "server not initialised"));
@@ -117,9 +323,19 @@ bool WebSocketServer::start() {
         return false;
     }
 
-    ACSDK_INFO(LX("Listening for websocket connections").d("interface", endpoint.address()).d("port", endpoint.port()));
+    ACSDK_INFO(LX("Listening for websocket connections")
+                   .d("interface", endpoint.address())
+                   .d("port", endpoint.port())
+                   .d("threads", m_threadPoolSize));
 
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < m_threadPoolSize; i++) {
+        threads.emplace_back([this] { m_webSocketServer.run(); });
+    }
     m_webSocketServer.run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
 
     return true;
 }
@@ -133,45 +349,225 @@ void WebSocketServer::stop() {
                         .d("errorCategory", errorCode.category().name()));
     }
 
-    m_webSocketServer.close(m_connection, websocketpp::close::status::going_away, "shutting down", errorCode);
-    if (errorCode) {
-        ACSDK_ERROR(
-            LX("server::close").d("errorCode", errorCode.value()).d("errorCategory", errorCode.category().name()));
+    std::vector<connection_hdl> handles;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        for (auto& entry : m_connections) {
+            handles.push_back(entry.first);
+        }
+        m_connections.clear();
+        m_primaryConnection.reset();
+    }
+
+    for (auto& handle : handles) {
+        m_webSocketServer.close(handle, websocketpp::close::status::going_away, "shutting down", errorCode);
+        if (errorCode) {
+            ACSDK_ERROR(
+                LX("server::close").d("errorCode", errorCode.value()).d("errorCategory", errorCode.category().name()));
+        }
     }
 
-    m_connection.reset();
+    // The connections are forgotten already, so their close handlers do not notify the observer
+    if (!handles.empty() && m_observer) {
+        m_observer->onConnectionClosed();
+    }
 }
 
 void WebSocketServer::writeMessage(const std::string& payload) {
-    websocketpp::lib::error_code errorCode;
     ACSDK_DEBUG9(LX("writeMessageBegin"));
 
-    m_webSocketServer.send(m_connection, payload, websocketpp::frame::opcode::text, errorCode);
+    auto route = extractRoute(payload);
+    auto message = std::make_shared<const std::string>(payload);
+
+    std::lock_guard<std::mutex> lock(m_connectionsMutex);
+    if (!m_primaryConnection) {
+        return;
+    }
+
+    if (route.windowId.empty()) {
+        if (route.isRequest) {
+            enqueue(m_primaryConnection, message);
+        } else {
+            for (auto& entry : m_connections) {
+                enqueue(entry.second, message);
+            }
+        }
+        ACSDK_DEBUG9(LX("writeMessageComplete"));
+        return;
+    }
+
+    std::vector<std::shared_ptr<Connection>> claimants;
+    for (auto& entry : m_connections) {
+        if (entry.second->windowIds.count(route.windowId)) {
+            claimants.push_back(entry.second);
+        }
+    }
+
+    if (claimants.empty() || (route.isRequest && m_primaryConnection->windowIds.count(route.windowId))) {
+        enqueue(m_primaryConnection, message);
+    } else if (route.isRequest) {
+        auto oldest = std::min_element(
+            claimants.begin(),
+            claimants.end(),
+            [](const std::shared_ptr<Connection>& lhs, const std::shared_ptr<Connection>& rhs) {
+                return lhs->openOrder < rhs->openOrder;
+            });
+        enqueue(*oldest, message);
+    } else {
+        for (auto& claimant : claimants) {
+            enqueue(claimant, message);
+        }
+    }
+
+    ACSDK_DEBUG9(LX("writeMessageComplete"));
+}
+
+void WebSocketServer::enqueue(
+    const std::shared_ptr<Connection>& connection,
+    const std::shared_ptr<const std::string>& message) {
+    if (connection->overflowed) {
+        return;
+    }
+
+    if (connection->queue.size() >= MAX_QUEUED_MESSAGES ||
+        connection->queuedBytes + message->size() > MAX_QUEUED_BYTES) {
+        ACSDK_WARN(LX("enqueueFailed")
+                       .d("reason", "queueOverflow")
+                       .d("queuedMessages", connection->queue.size())
+                       .d("queuedBytes", connection->queuedBytes));
+        connection->overflowed = true;
+        connection->queue.clear();
+        connection->queuedBytes = 0;
+        connection->strand.post([this, connection] { closeOverflowedConnection(connection); });
+        return;
+    }
+
+    connection->queue.push_back(message);
+    connection->queuedBytes += message->size();
+    if (!connection->drainScheduled) {
+        connection->drainScheduled = true;
+        connection->strand.post([this, connection] { drain(connection); });
+    }
+}
+
+void WebSocketServer::drain(const std::shared_ptr<Connection>& connection) {
+    websocketpp::lib::error_code errorCode;
+    auto client = m_webSocketServer.get_con_from_hdl(connection->handle, errorCode);
+
+    std::unique_lock<std::mutex> lock(m_connectionsMutex);
+    if (errorCode) {
+        // The connection is gone
+        connection->drainScheduled = false;
+        connection->queue.clear();
+        connection->queuedBytes = 0;
+        return;
+    }
+
+    while (!connection->queue.empty() && client->get_buffered_amount() < MAX_BUFFERED_BYTES) {
+        auto message = std::move(connection->queue.front());
+        connection->queue.pop_front();
+        connection->queuedBytes -= message->size();
+
+        auto opcode = m_binaryFrames ? websocketpp::frame::opcode::binary : websocketpp::frame::opcode::text;
+        auto frame = std::make_shared<WebSocketConfig::message_type>(
+            WebSocketConfig::message_type::con_msg_man_ptr(), opcode, message->size());
+        frame->set_payload(*message);
+        bool compressed =
+            m_compressionEnabled && connection->compressionNegotiated && message->size() >= m_compressionThreshold;
+        frame->set_compressed(compressed);
+        m_payloadBytesSent += message->size();
+        if (!compressed) {
+            m_uncompressedBytesSent += message->size();
+        }
+
+        // Sending may call the connection handlers, which take the lock
+        lock.unlock();
+        errorCode = client->send(frame);
+        if (errorCode) {
+            ACSDK_ERROR(LX("server::send")
+                            .d("errorCode", errorCode.value())
+                            .d("errorCategory", errorCode.category().name()));
+        }
+        lock.lock();
+    }
+
+    // WebSocketPP does not report when its buffer drains, so check again shortly if messages are left
+    connection->drainScheduled = !connection->queue.empty();
+    if (connection->drainScheduled) {
+        m_webSocketServer.set_timer(DRAIN_RETRY_INTERVAL_MS, [this, connection](const websocketpp::lib::error_code&) {
+            connection->strand.post([this, connection] { drain(connection); });
+        });
+    }
+}
+
+void WebSocketServer::closeOverflowedConnection(const std::shared_ptr<Connection>& connection) {
+    websocketpp::lib::error_code errorCode;
+    m_webSocketServer.close(
+        connection->handle, websocketpp::close::status::try_again_later, "send queue overflow", errorCode);
     if (errorCode) {
         ACSDK_ERROR(
-            LX("server::send").d("errorCode", errorCode.value()).d("errorCategory", errorCode.category().name()));
+            LX("server::close").d("errorCode", errorCode.value()).d("errorCategory", errorCode.category().name()));
     }
+}
 
-    ACSDK_DEBUG9(LX("writeMessageComplete"));
+std::string WebSocketServer::extractWindowId(const std::string& payload) {
+    RouteHandler handler(false);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(payload.c_str());
+    reader.Parse(stream, handler);
+    return handler.windowId;
+}
+
+WebSocketServer::Route WebSocketServer::extractRoute(const std::string& payload) const {
+    RouteHandler handler(!m_requestTypes.empty());
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(payload.c_str());
+    reader.Parse(stream, handler);
+
+    Route route;
+    route.windowId = std::move(handler.windowId);
+    route.isRequest = m_requestTypes.count(handler.type) || m_requestTypes.count(handler.payloadType);
+    return route;
 }
 
 void WebSocketServer::onConnectionOpen(connection_hdl connectionHdl) {
-    m_connection = connectionHdl;
+    auto connection = std::make_shared<Connection>(m_webSocketServer.get_io_service());
+    connection->handle = connectionHdl;
 
     websocketpp::lib::error_code errorCode;
     auto client = m_webSocketServer.get_con_from_hdl(connectionHdl, errorCode);
     if (errorCode) {
         ACSDK_ERROR(
             LX("onConnectionOpen").d("errorCode", errorCode.value()).d("errorCategory", errorCode.category().name()));
+    } else {
+        connection->compressionNegotiated =
+            client->get_response_header(EXTENSIONS_HEADER).find(PERMESSAGE_DEFLATE) != std::string::npos;
+        ACSDK_INFO(LX("onConnectionOpen")
+                       .d("remoteHost", client->get_remote_endpoint())
+                       .d("compression", connection->compressionNegotiated));
+    }
+
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        connection->openOrder = m_nextOpenOrder++;
+        m_connections[connectionHdl] = connection;
+        first = !m_primaryConnection;
+        if (first) {
+            m_primaryConnection = connection;
+        }
+    }
+
+    if (errorCode || !first) {
         return;
     }
-    ACSDK_INFO(LX("onConnectionOpen").d("remoteHost", client->get_remote_endpoint()));
 
     m_observer->onConnectionOpened();
 }
 
 bool WebSocketServer::isReady() {
-    return !m_connection.expired();
+    std::lock_guard<std::mutex> lock(m_connectionsMutex);
+    return !m_connections.empty();
 }
 
 void WebSocketServer::setObserver(const std::shared_ptr<MessagingServerObserverInterface>& observer) {
@@ -179,16 +575,56 @@ void WebSocketServer::setObserver(const std::shared_ptr<MessagingServerObserverI
 }
 
 void WebSocketServer::onConnectionClose(connection_hdl connectionHdl) {
-    m_connection.reset();
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        auto it = m_connections.find(connectionHdl);
+        if (it == m_connections.end()) {
+            // Already forgotten by stop
+            return;
+        }
+        auto closed = it->second;
+        m_connections.erase(it);
+
+        if (closed == m_primaryConnection) {
+            m_primaryConnection.reset();
+            for (auto& entry : m_connections) {
+                if (!m_primaryConnection || entry.second->openOrder < m_primaryConnection->openOrder) {
+                    m_primaryConnection = entry.second;
+                }
+            }
+            if (m_primaryConnection) {
+                ACSDK_INFO(LX("onConnectionClose").m("primary client changed"));
+            }
+        }
+        last = m_connections.empty();
+    }
 
-    ACSDK_INFO(LX("onConnectionClose"));
+    ACSDK_INFO(LX("onConnectionClose")
+                   .d("payloadBytesSent", getPayloadBytesSent())
+                   .d("wireBytesSent", getWireBytesSent())
+                   .d("compressionTimeUs",
+                      std::chrono::duration_cast<std::chrono::microseconds>(getCompressionTime()).count()));
 
-    m_observer->onConnectionClosed();
+    if (last) {
+        m_observer->onConnectionClosed();
+    }
 }
 
 void WebSocketServer::onMessage(connection_hdl connectionHdl, server::message_ptr messagePtr) {
+    // A client claims the windows it sends messages for
+    auto windowId = extractWindowId(messagePtr->get_payload());
+    if (!windowId.empty()) {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        auto it = m_connections.find(connectionHdl);
+        if (it != m_connections.end() && it->second->windowIds.insert(windowId).second) {
+            ACSDK_INFO(LX("onMessage").m("window claimed").d("windowId", windowId));
+        }
+    }
+
     if (m_messageListener) {
-        m_messageListener->onMessage(messagePtr->get_payload());
+        // The message is not used after this handler, so its payload is handed over
+        m_messageListener->onMessage(std::move(messagePtr->get_raw_payload()));
     } else {
         ACSDK_WARN(
             LX("onMessageFailed").d("reason", "messageListener is null").d("message:", messagePtr->get_payload()));
@@ -253,11 +689,13 @@ std::shared_ptr<asio::ssl::context> WebSocketServer::onTlsInit() {
 #endif  // ENABLE_WEBSOCKET_SSL
 
 bool WebSocketServer::onValidate(connection_hdl connectionHdl) {
-    // As we currently don't support more than one connection in general and in GUIClient in particular reject all
-    // connections if we already have one.
-    bool result = m_connection.expired();
+    bool result;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        result = m_connections.size() < MAX_CONNECTIONS;
+    }
     if (!result) {
-        ACSDK_WARN(LX("onValidate").m("connection already open"));
+        ACSDK_WARN(LX("onValidate").m("too many connections open").d("maxConnections", MAX_CONNECTIONS));
         asio::error_code errorCode;
         auto conn = m_webSocketServer.get_con_from_hdl(connectionHdl, errorCode);
         if (!errorCode) {
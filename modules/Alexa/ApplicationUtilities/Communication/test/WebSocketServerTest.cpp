@@ -0,0 +1,776 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+#include "Communication/WebSocketServer.h"
+
+namespace alexaSmartScreenSDK {
+namespace communication {
+namespace test {
+
+using namespace smartScreenSDKInterfaces;
+
+/// The interface the test server listens on.
+static const std::string TEST_INTERFACE("127.0.0.1");
+
+/// The port the test server listens on.
+static const unsigned short TEST_PORT = 8943;
+
+/// The URI the test clients connect to.
+static const std::string TEST_URI("ws://127.0.0.1:8943");
+
+/// How long to wait for a connection or a message.
+static const std::chrono::milliseconds TIMEOUT{2000};
+
+/// How often to check whether a condition is met.
+static const std::chrono::milliseconds POLL_INTERVAL{5};
+
+/// A message claiming the test window.
+static const std::string CLAIM_MESSAGE(R"({"type":"claim","windowId":"window"})");
+
+/// A message for the test window which is not a request.
+static const std::string WINDOW_MESSAGE(R"({"type":"aplCore","windowId":"window","payload":{"type":"dirty"}})");
+
+/// A request for the test window.
+static const std::string WINDOW_REQUEST(R"({"type":"aplCore","windowId":"window","payload":{"type":"measure"}})");
+
+/// A message for a window no client claims.
+static const std::string UNCLAIMED_MESSAGE(R"({"type":"aplCore","windowId":"other","payload":{"type":"dirty"}})");
+
+/// A message for no window, which is not a request.
+static const std::string NOTIFICATION_MESSAGE(R"({"type":"alexaStateChanged"})");
+
+/// A request for no window.
+static const std::string NOTIFICATION_REQUEST(R"({"type":"initRequest"})");
+
+/// The trailer removed from compressed messages before they are sent.
+static const char DEFLATE_TRAILER[] = {0x00, 0x00, static_cast<char>(0xff), static_cast<char>(0xff)};
+
+/// The size of the smallest message compressed by the test server.
+static const size_t COMPRESSION_THRESHOLD = 256;
+
+/// The opcode of text frames.
+static const int TEXT_OPCODE = 0x1;
+
+/// The opcode of binary frames.
+static const int BINARY_OPCODE = 0x2;
+
+/// The number of threads serving the connections in the thread pool tests.
+static const size_t THREAD_POOL_SIZE = 4;
+
+/// The number of clients connected in the thread pool tests.
+static const size_t THREAD_POOL_CLIENTS = 4;
+
+/// The number of messages written in the thread pool tests.
+static const size_t THREAD_POOL_MESSAGES = 200;
+
+/**
+ * Builds a message of a given size, which compresses well.
+ *
+ * @param size The size of the message.
+ * @return The message.
+ */
+static std::string buildMessage(size_t size) {
+    std::string message = R"({"type":"alexaStateChanged","state":")";
+    while (message.size() + 2 < size) {
+        message += static_cast<char>('a' + message.size() % 7);
+    }
+    return message + "\"}";
+}
+
+/**
+ * Waits for a condition to be met.
+ *
+ * @param condition The condition.
+ * @return @c true if the condition was met before the timeout
+ */
+static bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    return true;
+}
+
+/**
+ * An observer counting the notifications of the server.
+ */
+class CountingObserver : public MessagingServerObserverInterface {
+public:
+    void onConnectionOpened() override {
+        opened++;
+    }
+
+    void onConnectionClosed() override {
+        closed++;
+    }
+
+    /// The number of open notifications.
+    std::atomic<int> opened{0};
+
+    /// The number of close notifications.
+    std::atomic<int> closed{0};
+};
+
+/**
+ * A listener counting the messages received by the server.
+ */
+class CountingListener : public MessageListenerInterface {
+public:
+    void onMessage(const std::string& payload) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        last = payload;
+        received++;
+    }
+
+    /// The number of received messages.
+    std::atomic<int> received{0};
+
+    /// Guards @c last.
+    std::mutex mutex;
+
+    /// The last received message.
+    std::string last;
+};
+
+/**
+ * A WebSocket client speaking the protocol over a plain socket, so that it can offer permessage-deflate and inspect
+ * the frames it receives.
+ */
+class RawClient {
+public:
+    /// A received frame.
+    struct Frame {
+        /// The opcode of the frame.
+        int opcode = 0;
+
+        /// Whether the payload was compressed.
+        bool compressed = false;
+
+        /// The payload, decompressed.
+        std::string payload;
+    };
+
+    /// Constructor.
+    RawClient();
+
+    /// Destructor.
+    ~RawClient();
+
+    /**
+     * Connects to the test server.
+     *
+     * @param offerCompression Whether to offer permessage-deflate.
+     * @return The headers of the handshake response.
+     */
+    std::string connect(bool offerCompression);
+
+    /**
+     * Reads the next frame sent by the server.
+     *
+     * @return The frame.
+     */
+    Frame readFrame();
+
+    /**
+     * Sends a compressed text frame to the server.
+     *
+     * @param payload The message.
+     */
+    void sendCompressed(const std::string& payload);
+
+private:
+    /**
+     * Reads bytes sent by the server.
+     *
+     * @param size The number of bytes.
+     * @return The bytes.
+     */
+    std::string read(size_t size);
+
+    /**
+     * Runs zlib over a message.
+     *
+     * @param stream The zlib stream.
+     * @param input The input.
+     * @param deflating Whether the stream deflates rather than inflates.
+     * @return The output.
+     */
+    static std::string process(z_stream& stream, const std::string& input, bool deflating);
+
+    /// The ASIO loop of the socket.
+    asio::io_service m_ioService;
+
+    /// The socket connected to the server.
+    asio::ip::tcp::socket m_socket;
+
+    /// The bytes received and not consumed yet.
+    asio::streambuf m_buffer;
+
+    /// The zlib state decompressing the messages of the server.
+    z_stream m_inflateState;
+
+    /// The zlib state compressing the messages to the server.
+    z_stream m_deflateState;
+};
+
+RawClient::RawClient() : m_socket{m_ioService} {
+    std::memset(&m_inflateState, 0, sizeof(m_inflateState));
+    std::memset(&m_deflateState, 0, sizeof(m_deflateState));
+    inflateInit2(&m_inflateState, -MAX_WBITS);
+    deflateInit2(&m_deflateState, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+}
+
+RawClient::~RawClient() {
+    inflateEnd(&m_inflateState);
+    deflateEnd(&m_deflateState);
+}
+
+std::string RawClient::connect(bool offerCompression) {
+    m_socket.connect(asio::ip::tcp::endpoint(asio::ip::address::from_string(TEST_INTERFACE), TEST_PORT));
+    std::string request =
+        "GET / HTTP/1.1\r\n"
+        "Host: " + TEST_INTERFACE + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n";
+    if (offerCompression) {
+        request += "Sec-WebSocket-Extensions: permessage-deflate\r\n";
+    }
+    request += "\r\n";
+    asio::write(m_socket, asio::buffer(request));
+
+    auto size = asio::read_until(m_socket, m_buffer, "\r\n\r\n");
+    return read(size);
+}
+
+RawClient::Frame RawClient::readFrame() {
+    auto header = read(2);
+    Frame frame;
+    frame.opcode = header[0] & 0x0f;
+    frame.compressed = (header[0] & 0x40) != 0;
+
+    uint64_t length = header[1] & 0x7f;
+    if (length >= 126) {
+        auto extendedLength = read(length == 126 ? 2 : 8);
+        length = 0;
+        for (auto byte : extendedLength) {
+            length = (length << 8) | static_cast<uint8_t>(byte);
+        }
+    }
+
+    frame.payload = read(static_cast<size_t>(length));
+    if (frame.compressed) {
+        frame.payload = process(m_inflateState, frame.payload + std::string(DEFLATE_TRAILER, 4), false);
+    }
+    return frame;
+}
+
+void RawClient::sendCompressed(const std::string& payload) {
+    auto compressed = process(m_deflateState, payload, true);
+    compressed.resize(compressed.size() - 4);
+
+    // A final compressed text frame, masked with a zero key as clients must mask their frames
+    std::string frame{static_cast<char>(0xc1)};
+    if (compressed.size() < 126) {
+        frame += static_cast<char>(0x80 | compressed.size());
+    } else {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>((compressed.size() >> 8) & 0xff);
+        frame += static_cast<char>(compressed.size() & 0xff);
+    }
+    frame.append(4, '\0');
+    frame += compressed;
+    asio::write(m_socket, asio::buffer(frame));
+}
+
+std::string RawClient::read(size_t size) {
+    if (m_buffer.size() < size) {
+        asio::read(m_socket, m_buffer, asio::transfer_exactly(size - m_buffer.size()));
+    }
+    std::string bytes(size, '\0');
+    m_buffer.sgetn(&bytes[0], size);
+    return bytes;
+}
+
+std::string RawClient::process(z_stream& stream, const std::string& input, bool deflating) {
+    std::string output;
+    unsigned char buffer[4096];
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    do {
+        stream.avail_out = sizeof(buffer);
+        stream.next_out = buffer;
+        deflating ? deflate(&stream, Z_SYNC_FLUSH) : inflate(&stream, Z_SYNC_FLUSH);
+        output.append(reinterpret_cast<char*>(buffer), sizeof(buffer) - stream.avail_out);
+    } while (stream.avail_out == 0);
+    return output;
+}
+
+/**
+ * A WebSocket client recording the messages it receives.
+ */
+class TestClient {
+public:
+    /// Constructor.
+    TestClient();
+
+    /// Destructor.
+    ~TestClient();
+
+    /**
+     * Connects to the test server.
+     *
+     * @return @c true if the connection was opened before the timeout
+     */
+    bool connect();
+
+    /**
+     * Sends a message to the server.
+     *
+     * @param payload The message.
+     */
+    void send(const std::string& payload);
+
+    /**
+     * Closes the connection and waits for the client to stop.
+     */
+    void close();
+
+    /**
+     * @param payload A message.
+     * @return The number of times the message was received.
+     */
+    size_t received(const std::string& payload);
+
+    /**
+     * @return The received messages, in the order they were received.
+     */
+    std::vector<std::string> messages();
+
+private:
+    using Client = websocketpp::client<websocketpp::config::asio_client>;
+
+    /// The client endpoint.
+    Client m_client;
+
+    /// The connection to the server.
+    Client::connection_ptr m_connection;
+
+    /// The thread running the client endpoint.
+    std::thread m_thread;
+
+    /// Guards the members below.
+    std::mutex m_mutex;
+
+    /// Notified when the connection opens or fails.
+    std::condition_variable m_condition;
+
+    /// Whether the connection is open.
+    bool m_open = false;
+
+    /// Whether the connection failed.
+    bool m_failed = false;
+
+    /// The received messages.
+    std::vector<std::string> m_messages;
+};
+
+TestClient::TestClient() {
+    m_client.clear_access_channels(websocketpp::log::alevel::all);
+    m_client.clear_error_channels(websocketpp::log::elevel::all);
+    m_client.init_asio();
+    m_client.set_open_handler([this](websocketpp::connection_hdl) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = true;
+        m_condition.notify_all();
+    });
+    m_client.set_fail_handler([this](websocketpp::connection_hdl) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failed = true;
+        m_condition.notify_all();
+    });
+    m_client.set_message_handler([this](websocketpp::connection_hdl, Client::message_ptr message) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_messages.push_back(message->get_payload());
+    });
+}
+
+TestClient::~TestClient() {
+    close();
+}
+
+bool TestClient::connect() {
+    websocketpp::lib::error_code errorCode;
+    m_connection = m_client.get_connection(TEST_URI, errorCode);
+    if (errorCode) {
+        return false;
+    }
+    m_client.connect(m_connection);
+    m_thread = std::thread([this] { m_client.run(); });
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_condition.wait_for(lock, TIMEOUT, [this] { return m_open || m_failed; }) && m_open;
+}
+
+void TestClient::send(const std::string& payload) {
+    websocketpp::lib::error_code errorCode;
+    m_client.send(m_connection->get_handle(), payload, websocketpp::frame::opcode::text, errorCode);
+}
+
+void TestClient::close() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    websocketpp::lib::error_code errorCode;
+    m_client.close(m_connection->get_handle(), websocketpp::close::status::normal, "", errorCode);
+    m_thread.join();
+}
+
+size_t TestClient::received(const std::string& payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count(m_messages.begin(), m_messages.end(), payload);
+}
+
+std::vector<std::string> TestClient::messages() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_messages;
+}
+
+/// Test harness for @c WebSocketServer serving several clients.
+class WebSocketServerTest : public ::testing::Test {
+public:
+    /// Set up the test harness for running a test.
+    void SetUp() override;
+
+    /// Clean up the test harness after running a test.
+    void TearDown() override;
+
+protected:
+    /**
+     * Starts the server with the current settings.
+     */
+    void startServer();
+
+    /**
+     * Connects a new client to the server.
+     *
+     * @return The client.
+     */
+    std::unique_ptr<TestClient> connectClient();
+
+    /**
+     * Writes a message to the clients once they all received every message written before it.
+     *
+     * @param clients The clients which must receive the message.
+     * @param payload The message.
+     * @return @c true if the clients received the message before the timeout
+     */
+    bool writeAndWait(const std::vector<TestClient*>& clients, const std::string& payload);
+
+    std::shared_ptr<WebSocketServer> m_server;
+    std::shared_ptr<CountingObserver> m_observer;
+    std::shared_ptr<CountingListener> m_listener;
+    std::thread m_serverThread;
+};
+
+void WebSocketServerTest::SetUp() {
+    m_server = std::make_shared<WebSocketServer>(TEST_INTERFACE, TEST_PORT);
+    m_observer = std::make_shared<CountingObserver>();
+    m_listener = std::make_shared<CountingListener>();
+    m_server->setObserver(m_observer);
+    m_server->setMessageListener(m_listener);
+    m_server->setRequestTypes({"measure", "initRequest"});
+}
+
+void WebSocketServerTest::TearDown() {
+    m_server->stop();
+    if (m_serverThread.joinable()) {
+        m_serverThread.join();
+    }
+}
+
+void WebSocketServerTest::startServer() {
+    m_serverThread = std::thread([this] { m_server->start(); });
+}
+
+std::unique_ptr<TestClient> WebSocketServerTest::connectClient() {
+    std::unique_ptr<TestClient> client(new TestClient());
+    EXPECT_TRUE(client->connect());
+    EXPECT_TRUE(waitFor([this] { return m_server->isReady(); }));
+    return client;
+}
+
+bool WebSocketServerTest::writeAndWait(const std::vector<TestClient*>& clients, const std::string& payload) {
+    auto expected = clients.front()->received(payload) + 1;
+    m_server->writeMessage(payload);
+    return waitFor([&clients, &payload, expected] {
+        for (auto client : clients) {
+            if (client->received(payload) < expected) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+/**
+ * Tests that the observer is notified when the first client connects and when the last client disconnects only.
+ */
+TEST_F(WebSocketServerTest, ObserverNotifiedOfFirstOpenAndLastClose) {
+    startServer();
+    auto primary = connectClient();
+    auto mirror = connectClient();
+    ASSERT_TRUE(writeAndWait({primary.get(), mirror.get()}, NOTIFICATION_MESSAGE));
+    ASSERT_EQ(1, m_observer->opened.load());
+
+    primary->close();
+    // Unclaimed messages reach the remaining client once it became the primary client
+    ASSERT_TRUE(waitFor([this, &mirror] {
+        m_server->writeMessage(UNCLAIMED_MESSAGE);
+        return mirror->received(UNCLAIMED_MESSAGE) > 0;
+    }));
+    ASSERT_EQ(0, m_observer->closed.load());
+
+    mirror->close();
+    ASSERT_TRUE(waitFor([this] { return m_observer->closed == 1; }));
+    ASSERT_EQ(1, m_observer->opened.load());
+}
+
+/**
+ * Tests that messages for a window no client claimed and requests for no window are written to the primary client
+ * only, while other messages for no window are written to every client.
+ */
+TEST_F(WebSocketServerTest, UnclaimedMessagesAndRequestsWrittenToPrimaryClient) {
+    startServer();
+    auto primary = connectClient();
+    auto mirror = connectClient();
+
+    m_server->writeMessage(UNCLAIMED_MESSAGE);
+    m_server->writeMessage(NOTIFICATION_REQUEST);
+    ASSERT_TRUE(writeAndWait({primary.get(), mirror.get()}, NOTIFICATION_MESSAGE));
+
+    ASSERT_EQ(1u, primary->received(UNCLAIMED_MESSAGE));
+    ASSERT_EQ(1u, primary->received(NOTIFICATION_REQUEST));
+    ASSERT_EQ(0u, mirror->received(UNCLAIMED_MESSAGE));
+    ASSERT_EQ(0u, mirror->received(NOTIFICATION_REQUEST));
+}
+
+/**
+ * Tests that messages for a claimed window are written to every client claiming it, except requests, which are
+ * written to the primary client only.
+ */
+TEST_F(WebSocketServerTest, WindowRequestsWrittenToPrimaryClient) {
+    startServer();
+    auto primary = connectClient();
+    auto mirror = connectClient();
+    primary->send(CLAIM_MESSAGE);
+    mirror->send(CLAIM_MESSAGE);
+    ASSERT_TRUE(waitFor([this] { return m_listener->received == 2; }));
+
+    m_server->writeMessage(WINDOW_REQUEST);
+    ASSERT_TRUE(writeAndWait({primary.get(), mirror.get()}, WINDOW_MESSAGE));
+
+    ASSERT_EQ(1u, primary->received(WINDOW_REQUEST));
+    ASSERT_EQ(0u, mirror->received(WINDOW_REQUEST));
+}
+
+/**
+ * Tests that once the primary client disconnects, requests are written to the longest connected client instead.
+ */
+TEST_F(WebSocketServerTest, PrimaryClientReplacedOnClose) {
+    startServer();
+    auto primary = connectClient();
+    auto second = connectClient();
+    auto third = connectClient();
+    second->send(CLAIM_MESSAGE);
+    third->send(CLAIM_MESSAGE);
+    ASSERT_TRUE(waitFor([this] { return m_listener->received == 2; }));
+
+    primary->close();
+    ASSERT_TRUE(waitFor([this, &second] {
+        m_server->writeMessage(UNCLAIMED_MESSAGE);
+        return second->received(UNCLAIMED_MESSAGE) > 0;
+    }));
+
+    m_server->writeMessage(WINDOW_REQUEST);
+    ASSERT_TRUE(writeAndWait({second.get(), third.get()}, WINDOW_MESSAGE));
+
+    ASSERT_EQ(1u, second->received(WINDOW_REQUEST));
+    ASSERT_EQ(0u, third->received(WINDOW_REQUEST));
+    ASSERT_EQ(0u, third->received(UNCLAIMED_MESSAGE));
+}
+
+/**
+ * Tests that permessage-deflate is agreed on when the client offers it only.
+ */
+TEST_F(WebSocketServerTest, CompressionNegotiatedWhenOffered) {
+    startServer();
+    RawClient offering;
+    ASSERT_NE(std::string::npos, offering.connect(true).find("permessage-deflate"));
+    RawClient notOffering;
+    ASSERT_EQ(std::string::npos, notOffering.connect(false).find("permessage-deflate"));
+}
+
+/**
+ * Tests that messages are only compressed from the configured threshold on, and never when the client did not offer
+ * compression.
+ */
+TEST_F(WebSocketServerTest, MessagesCompressedFromThreshold) {
+    m_server->setCompression(true, Z_DEFAULT_COMPRESSION, COMPRESSION_THRESHOLD);
+    startServer();
+    RawClient client;
+    client.connect(true);
+    ASSERT_TRUE(waitFor([this] { return m_server->isReady(); }));
+
+    auto small = buildMessage(COMPRESSION_THRESHOLD - 1);
+    auto large = buildMessage(COMPRESSION_THRESHOLD);
+    m_server->writeMessage(small);
+    m_server->writeMessage(large);
+
+    auto frame = client.readFrame();
+    ASSERT_FALSE(frame.compressed);
+    ASSERT_EQ(small, frame.payload);
+    frame = client.readFrame();
+    ASSERT_TRUE(frame.compressed);
+    ASSERT_EQ(large, frame.payload);
+}
+
+/**
+ * Tests that no message is compressed when compression is disabled, even though the client offered it.
+ */
+TEST_F(WebSocketServerTest, MessagesNotCompressedWhenDisabled) {
+    m_server->setCompression(false, Z_DEFAULT_COMPRESSION, COMPRESSION_THRESHOLD);
+    startServer();
+    RawClient client;
+    client.connect(true);
+    ASSERT_TRUE(waitFor([this] { return m_server->isReady(); }));
+
+    auto payloadBytesSent = m_server->getPayloadBytesSent();
+    auto wireBytesSent = m_server->getWireBytesSent();
+    auto large = buildMessage(COMPRESSION_THRESHOLD * 4);
+    m_server->writeMessage(large);
+
+    auto frame = client.readFrame();
+    ASSERT_FALSE(frame.compressed);
+    ASSERT_EQ(large, frame.payload);
+    ASSERT_EQ(m_server->getPayloadBytesSent() - payloadBytesSent, m_server->getWireBytesSent() - wireBytesSent);
+}
+
+/**
+ * Tests that compressed messages survive the round trip in both directions, including messages larger than the
+ * compression buffer and messages referring to the compression context of earlier ones.
+ */
+TEST_F(WebSocketServerTest, CompressedMessagesRoundTrip) {
+    m_server->setCompression(true, Z_BEST_COMPRESSION, COMPRESSION_THRESHOLD);
+    startServer();
+    RawClient client;
+    client.connect(true);
+    ASSERT_TRUE(waitFor([this] { return m_server->isReady(); }));
+
+    auto payloadBytesSent = m_server->getPayloadBytesSent();
+    auto wireBytesSent = m_server->getWireBytesSent();
+    std::vector<std::string> messages = {buildMessage(64 * 1024), buildMessage(64 * 1024), buildMessage(1024)};
+    for (auto& message : messages) {
+        m_server->writeMessage(message);
+    }
+    for (auto& message : messages) {
+        auto frame = client.readFrame();
+        ASSERT_TRUE(frame.compressed);
+        ASSERT_EQ(message, frame.payload);
+    }
+    ASSERT_LT(m_server->getWireBytesSent() - wireBytesSent, m_server->getPayloadBytesSent() - payloadBytesSent);
+
+    for (auto& message : messages) {
+        client.sendCompressed(message);
+        ASSERT_TRUE(waitFor([this, &message] {
+            std::lock_guard<std::mutex> lock(m_listener->mutex);
+            return m_listener->last == message;
+        }));
+    }
+}
+
+/**
+ * Tests that messages are sent in binary frames when configured to.
+ */
+TEST_F(WebSocketServerTest, BinaryFramesCarryMessages) {
+    startServer();
+    RawClient client;
+    client.connect(false);
+    ASSERT_TRUE(waitFor([this] { return m_server->isReady(); }));
+
+    m_server->writeMessage(NOTIFICATION_MESSAGE);
+    auto frame = client.readFrame();
+    ASSERT_EQ(TEXT_OPCODE, frame.opcode);
+    ASSERT_EQ(NOTIFICATION_MESSAGE, frame.payload);
+
+    m_server->setBinaryFrames(true);
+    m_server->writeMessage(NOTIFICATION_MESSAGE);
+    frame = client.readFrame();
+    ASSERT_EQ(BINARY_OPCODE, frame.opcode);
+    ASSERT_EQ(NOTIFICATION_MESSAGE, frame.payload);
+}
+
+/**
+ * Tests that with several threads serving the connections, every client receives every message in the order it was
+ * written, and every message is counted once per client.
+ */
+TEST_F(WebSocketServerTest, ThreadPoolKeepsMessageOrderPerClient) {
+    m_server->setThreadPoolSize(THREAD_POOL_SIZE);
+    startServer();
+    std::vector<std::unique_ptr<TestClient>> clients;
+    for (size_t i = 0; i < THREAD_POOL_CLIENTS; i++) {
+        clients.push_back(connectClient());
+    }
+
+    auto payloadBytesSent = m_server->getPayloadBytesSent();
+    std::vector<std::string> messages;
+    uint64_t messageBytes = 0;
+    for (size_t i = 0; i < THREAD_POOL_MESSAGES; i++) {
+        messages.push_back(R"({"type":"alexaStateChanged","index":)" + std::to_string(i) + "}");
+        messageBytes += messages.back().size();
+        m_server->writeMessage(messages.back());
+    }
+
+    for (auto& client : clients) {
+        ASSERT_TRUE(waitFor([&client] { return client->messages().size() == THREAD_POOL_MESSAGES; }));
+        ASSERT_EQ(messages, client->messages());
+    }
+    ASSERT_EQ(messageBytes * THREAD_POOL_CLIENTS, m_server->getPayloadBytesSent() - payloadBytesSent);
+}
+
+}  // namespace test
+}  // namespace communication
+}  // namespace alexaSmartScreenSDK
@@ -41,6 +41,14 @@ namespace sampleApp {
 struct AplClientBridgeParameter {
     // Maximum number of concurrent downloads allowed.
     int maxNumberOfConcurrentDownloads;
+    // Maximum number of APL Core update ticks per second.
+    int maxFrameRate;
+    // Granularity in milliseconds of the audio playback progress published to APL documents, 0 publishes every tick.
+    int audioProgressGranularity;
+    // Maximum number of backstack documents kept live, older ones are hibernated. 0 means no limit.
+    int maxLiveBackstackDocuments;
+    // Maximum estimated size in bytes of the backstack documents kept live. 0 means no limit.
+    int maxLiveBackstackBytes;
 };
 
 class AplClientBridge
@@ -160,6 +168,22 @@ public:
 
     void onUpdateTimer();
 
+    /**
+     * @return The number of update ticks which were dropped because a tick was already queued or deferred because
+     * of the frame rate cap
+     */
+    uint64_t getSkippedUpdateTickCount() const;
+
+    /**
+     * @return The number of update tick requests which were merged into an already scheduled tick
+     */
+    uint64_t getCoalescedUpdateTickCount() const;
+
+    /**
+     * @return The number of update ticks executed
+     */
+    uint64_t getUpdateTickCount() const;
+
     void setGUIManager(std::shared_ptr<alexaSmartScreenSDK::smartScreenSDKInterfaces::GUIServerInterface> guiManager);
 
     void renderDocument(
@@ -177,7 +201,7 @@ public:
 
     void dataSourceUpdate(const std::string& sourceType, const std::string& jsonPayload, const std::string& token);
 
-    void onMessage(const std::string& windowId, const std::string& message);
+    void onMessage(const std::string& windowId, std::shared_ptr<const rapidjson::Value> message);
 
     bool handleBack();
 
@@ -236,6 +260,32 @@ private:
      */
     void setTokenToWindow(const std::string& token, const std::string& windowId);
 
+    /**
+     * Requests an update tick as soon as the frame rate cap allows, must be called on the executor thread after any
+     * work which may have changed the state of a renderer.
+     */
+    void requestUpdateTick();
+
+    /**
+     * Schedules an update tick after the given delay, coalescing it with an already scheduled tick if that is due
+     * no later. Must be called on the executor thread.
+     *
+     * @param delay The delay until the update tick
+     */
+    void scheduleUpdateTick(std::chrono::milliseconds delay);
+
+    /**
+     * Runs the APL Core update loop on every renderer and schedules the next update tick, if any is needed.
+     * Must be called on the executor thread.
+     */
+    void executeUpdateTick();
+
+    /**
+     * @return The delay until the playback progress of any @c AplAudioPlayerExtension is due to change,
+     * @c std::chrono::milliseconds::max() if none is. Must be called on the executor thread.
+     */
+    std::chrono::milliseconds getNextPlaybackProgressDelay() const;
+
     /**
      * Executor method for clearing document, must be called in executor context.
      *
@@ -258,6 +308,27 @@ private:
     /// An internal timer use to run the APL Core update loop
     alexaClientSDK::avsCommon::utils::timing::Timer m_updateTimer;
 
+    /// Whether the GUI client is connected and update ticks should be scheduled
+    bool m_connectionOpen;
+
+    /// The minimum interval between two update ticks, derived from the frame rate cap
+    std::chrono::milliseconds m_minUpdateInterval;
+
+    /// The time of the last update tick
+    std::chrono::steady_clock::time_point m_lastUpdateTick;
+
+    /// The time the update timer is scheduled to fire at, only valid while the timer is active
+    std::chrono::steady_clock::time_point m_scheduledUpdateTick;
+
+    /// Number of update ticks skipped because one was already queued or because of the frame rate cap
+    std::atomic<uint64_t> m_skippedUpdateTicks;
+
+    /// Number of update tick requests coalesced into an already scheduled tick
+    std::atomic<uint64_t> m_coalescedUpdateTicks;
+
+    /// Number of update ticks executed
+    std::atomic<uint64_t> m_updateTicks;
+
     /// Pointer to the APL Client
     std::unique_ptr<APLClient::AplClientBinding> m_aplClientBinding;
 
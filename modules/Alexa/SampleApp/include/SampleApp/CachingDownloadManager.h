@@ -17,7 +17,11 @@
 #define ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_INCLUDE_SAMPLEAPP_CACHINGDOWNLOADMANAGER_H_
 
 #include <cstdint>
+#include <future>
+#include <list>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <AVSCommon/Utils/LibcurlUtils/HTTPContentFetcherFactory.h>
 #include <AVSCommon/Utils/Threading/Executor.h>
@@ -25,6 +29,8 @@
 
 #include <RegistrationManager/CustomerDataHandler.h>
 
+#include "SampleApp/PackageCacheStore.h"
+
 namespace alexaSmartScreenSDK {
 namespace sampleApp {
 
@@ -55,6 +61,25 @@ public:
          */
         virtual void onCacheHit(){};
 
+        /**
+         * Called when a resource was obtained from a download already in progress for another request, and
+         * downloading is not attempted.
+         */
+        virtual void onDownloadCoalesced(){};
+
+        /**
+         * Called when a resource was not found in the cache, or its cached copy has expired, and the source is
+         * contacted.
+         */
+        virtual void onCacheMiss(){};
+
+        /**
+         * Called when a cached resource is evicted to keep the cache within its budget.
+         *
+         * @param numberOfBytes The size of the evicted resource.
+         */
+        virtual void onCacheEviction(uint64_t numberOfBytes){};
+
         /**
          * Called during the download of a resource. Observers should expect multiple calls
          * to this method for a single download.
@@ -68,20 +93,26 @@ public:
      * Constructor.
      *
      * @param httpContentFetcherFactory Pointer to a http content fetcher factory for making download requests
-     * @param cachePeriodInSeconds Number of seconds to reuse cache for downloaded packages
-     * @param maxCacheSize Maximum cache size for caching downloaded packages
-     * @param miscStorage Wrapper to read and write to misc stor=age database
+     * @param cachePeriodInSeconds Number of seconds to reuse a cached package before revalidating it with the source
+     * @param maxCacheSize Maximum number of cached packages
+     * @param maxCacheSizeInBytes Maximum total size of cached packages in bytes, 0 for no limit
+     * @param miscStorage Wrapper to read and write to misc storage database
+     * @param customerDataManager Object that will track the CustomerDataHandler
+     * @param cacheDirectory Directory holding the cached package files
      */
     CachingDownloadManager(
         std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::HTTPContentFetcherInterfaceFactoryInterface>
             httpContentFetcherInterfaceFactoryInterface,
         unsigned long cachePeriodInSeconds,
         unsigned long maxCacheSize,
+        uint64_t maxCacheSizeInBytes,
         std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface> miscStorage,
-        const std::shared_ptr<alexaClientSDK::registrationManager::CustomerDataManagerInterface> customerDataManager);
+        const std::shared_ptr<alexaClientSDK::registrationManager::CustomerDataManagerInterface> customerDataManager,
+        const std::string& cacheDirectory);
 
     /**
-     * Method that should be called when requesting content
+     * Method that should be called when requesting content. Concurrent requests for a source that is not cached
+     * share a single download.
      *
      * @param source URL
      * @param observer An observer to notify of the download, or @c nullptr to disable notifications.
@@ -89,49 +120,67 @@ public:
      */
     std::string retrieveContent(const std::string& source, std::shared_ptr<Observer> observer = nullptr);
 
+private:
     /**
-     * Class to define a cached content item
+     * Fetches content from source, revalidating the cached copy if there is one, and caches the result.
+     * @param source URL
+     * @param observer An observer to notify of the download, or @c nullptr to disable notifications.
+     * @param cachedEntry The expired cached package for @c source, only valid if @c isCached is @c true.
+     * @param isCached Whether @c source has an expired cached package to revalidate.
+     * @return content, empty if it could not be fetched
      */
-    class CachedContent {
-    public:
-        /**
-         * Time when the content was put into cache
-         */
-        std::chrono::system_clock::time_point importTime;
-        /**
-         * Content of the item
-         */
-        std::string content;
-
-        CachedContent() = default;
-
-        /**
-         * Constructor
-         *
-         * @param importTime Time when the item was inserted into cache
-         * @param content The content of the item
-         */
-        CachedContent(std::chrono::system_clock::time_point importTime, const std::string& content);
-    };
-
-private:
+    std::string fetchContent(
+        const std::string& source,
+        std::shared_ptr<Observer> observer,
+        PackageCacheStore::Entry cachedEntry,
+        bool isCached);
     /**
      * Downloads content requested by import from provided URL from source.
      * @param source URL
      * @param observer An observer to notify of the download, or @c nullptr to disable notifications.
-     * @return content from source
+     * @param customHeaders Additional request headers, e.g. to make the request conditional.
+     * @param[out] notModified Set to @c true if the source replied that the content has not been modified.
+     * @return content from source, empty if the download failed or the content was not modified
+     */
+    std::string downloadFromSource(
+        const std::string& source,
+        std::shared_ptr<Observer> observer,
+        const std::vector<std::string>& customHeaders,
+        bool* notModified);
+    /**
+     * Reads a cached package from the package store, dropping the entry if its file can no longer be read.
+     * @param entry The cached package.
+     * @param[out] content The package content.
+     * @return @c true if the content was read.
+     */
+    bool readFromStore(const PackageCacheStore::Entry& entry, std::string* content);
+    /**
+     * A cached package along with its position in the recency list.
+     */
+    struct CacheItem {
+        /// The cached package.
+        PackageCacheStore::Entry entry;
+        /// Position of the package source in @c m_lruList.
+        std::list<std::string>::iterator lruPosition;
+    };
+    /**
+     * Adds or replaces a cached package as the most recently used one.
+     * @note @c cachedContentMapMutex must be held by the caller.
+     * @param entry The cached package.
      */
-    std::string downloadFromSource(const std::string& source, std::shared_ptr<Observer> observer);
+    void insertLocked(PackageCacheStore::Entry entry);
     /**
-     * Scans the cache to remove all expired entries, and evict the oldest entry if cache is full
+     * Removes a cached package from the in-memory cache, leaving storage untouched.
+     * @note @c cachedContentMapMutex must be held by the caller.
+     * @param it The cached package.
      */
-    void cleanUpCache();
+    void eraseLocked(std::unordered_map<std::string, CacheItem>::iterator it);
     /**
-     * Write the downloaded content to storage.
-     * @param source URL.
-     * @param content CachedContent object.
+     * Evicts the least recently used entries until the cache is within its entry and byte budgets.
+     * @note @c cachedContentMapMutex must be held by the caller.
+     * @param observer An observer to notify of evictions, or @c nullptr to disable notifications.
      */
-    void writeToStorage(std::string source, CachedContent content);
+    void cleanUpCache(std::shared_ptr<Observer> observer);
 
     /// @name CustomerDataHandler Function
     /// @{
@@ -139,17 +188,18 @@ private:
     /// @}
 
     /**
-     * Remove the downloaded content from storage.
-     * @param source  source URL.
+     * Remove the downloaded content from storage. The removal happens asynchronously and is ignored by the store if
+     * the source has been stored again in the meantime.
+     * @param entry The cached package.
      */
-    void removeFromStorage(std::string source);
+    void removeFromStorage(const PackageCacheStore::Entry& entry);
     /**
      * Used to create objects that can fetch remote HTTP content.
      */
     std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::HTTPContentFetcherInterfaceFactoryInterface>
         m_contentFetcherFactory;
     /**
-     * Reuse time for caching of downloaded content
+     * Time for which cached content is reused without revalidating it with the source
      */
     std::chrono::duration<double> m_cachePeriod;
     /**
@@ -157,31 +207,39 @@ private:
      */
     unsigned long m_maxCacheSize;
     /**
-     * The hashmap that maps the source url to a CachedContent
+     * Max total size in bytes of cached content, 0 for no limit
+     */
+    uint64_t m_maxCacheSizeInBytes;
+    /**
+     * Total size in bytes of cached content
      */
-    std::unordered_map<std::string, CachingDownloadManager::CachedContent> cachedContentMap;
+    uint64_t m_cacheSizeInBytes;
     /**
-     * The mutex for cachedContentMap
+     * The hashmap that maps the source url to the metadata of its cached package. Package contents stay on disk.
+     */
+    std::unordered_map<std::string, CacheItem> cachedContentMap;
+    /**
+     * Cached package sources ordered from most to least recently used
+     */
+    std::list<std::string> m_lruList;
+    /**
+     * Downloads in progress keyed by source url, joined by concurrent requests for the same source
+     */
+    std::unordered_map<std::string, std::shared_future<std::string>> m_pendingDownloads;
+    /**
+     * The mutex for cachedContentMap, m_lruList, m_cacheSizeInBytes and m_pendingDownloads
      */
     std::mutex cachedContentMapMutex;
     /**
-     * The wrapper to read and write to local misc storage.
+     * The persistent store holding the cached packages, @c nullptr if packages are not cached.
      */
-    std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface> m_miscStorage;
+    std::shared_ptr<PackageCacheStore> m_packageStore;
     /**
      * An internal executor that performs execution of callable objects passed to it sequentially but asynchronously.
      */
     alexaClientSDK::avsCommon::utils::threading::Executor m_executor;
 };
 
-/**
- * This is a function to convert the @c CachedContent to a string.
- */
-inline std::string cachedContentToString(CachingDownloadManager::CachedContent content, std::string delimiter) {
-    auto time = std::chrono::duration_cast<std::chrono::seconds>(content.importTime.time_since_epoch()).count();
-    return std::to_string(time) + delimiter + content.content;
-}
-
 }  // namespace sampleApp
 }  // namespace alexaSmartScreenSDK
 
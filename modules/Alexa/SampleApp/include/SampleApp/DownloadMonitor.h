@@ -40,6 +40,12 @@ public:
 
     void onCacheHit() override;
 
+    void onDownloadCoalesced() override;
+
+    void onCacheMiss() override;
+
+    void onCacheEviction(uint64_t numberOfBytes) override;
+
     void onBytesRead(uint64_t numberOfBytes) override;
 
 private:
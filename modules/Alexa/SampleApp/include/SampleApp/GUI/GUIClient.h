@@ -184,6 +184,7 @@ public:
     /// @name MessageListenerInterface Function
     /// @{
     void onMessage(const std::string& jsonPayload) override;
+    void onMessage(std::string&& jsonPayload) override;
     /// @}
 
     /// @name AuthObserverInterface Function
@@ -290,9 +291,27 @@ private:
         const std::string& APLMaxVersion,
         const std::shared_ptr<alexaClientSDK::registrationManager::CustomerDataManagerInterface> customerDataManager);
 
+    /**
+     * A message received from the server.
+     */
+    struct InboundMessage {
+        /// The received text, which the strings of @c document point into once it is parsed.
+        std::string buffer;
+
+        /// The message, parsed in place.
+        rapidjson::Document document;
+    };
+
     /// Server worker thread.
     void serverThread();
 
+    /**
+     * Parses a message received from the server in place and dispatches it to its handler. Called on the executor.
+     *
+     * @param message The message.
+     */
+    void executeOnMessage(const std::shared_ptr<InboundMessage>& message);
+
     /// Send initRequest message to the client and wait for init response.
     void sendInitRequestAndWait();
 
@@ -381,11 +400,12 @@ private:
     void executeHandleLogEvent(rapidjson::Document& message);
 
     /**
-     * Handle aplEvent message.
+     * Handle aplEvent message. The parsed event is handed to the APL renderer, which shares the ownership of the
+     * message so it does not have to parse the event again.
      *
      * @param message A complete message holding the event.
      */
-    void executeHandleAplEvent(rapidjson::Document& message);
+    void executeHandleAplEvent(const std::shared_ptr<InboundMessage>& message);
 
     /**
      * Handle deviceWindowState message.
@@ -492,25 +512,27 @@ private:
         std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::ChannelObserverInterface> channelObserver);
 
     /**
-     * Extracts the document section from an APL payload
-     * @param jsonPayload
+     * Extracts the document section from an APL payload, serialized back to JSON text as APLClient takes the document
+     * as text
+     * @param document The parsed payload
      * @return The extracted document
      */
-    std::string extractDocument(const std::string& jsonPayload);
+    std::string extractDocument(const rapidjson::Value& document);
 
     /**
-     * Extracts the datasource from an APL payload
-     * @param jsonPayload
+     * Extracts the datasource from an APL payload, serialized back to JSON text as APLClient takes the datasources as
+     * text
+     * @param document The parsed payload
      * @return The extracted section
      */
-    std::string extractDatasources(const std::string& jsonPayload);
+    std::string extractDatasources(const rapidjson::Value& document);
 
     /**
      * Extracts the SupportedViewports section from a directive
-     * @param jsonPayload
+     * @param document The parsed payload
      * @return The extracted section
      */
-    std::string extractSupportedViewports(const std::string& jsonPayload);
+    std::string extractSupportedViewports(const rapidjson::Value& document);
 
     /**
      * Initializes the @ConfigurationNodes for the GUI configs.
@@ -370,11 +370,11 @@ public:
      * Constructor.
      *
      * @param windowId The target windowId for this message.
-     * @param payload The APL Core message object to serialize.
+     * @param payload The serialized APL Core message, spliced into this message without being parsed again.
      */
     AplCoreMessage(std::string windowId, std::string payload) : GUIClientMessage(GUI_MSG_TYPE_APL_CORE) {
         setWindowId(windowId);
-        setParsedPayload(payload);
+        setRawPayload(std::move(payload));
     }
 };
 
@@ -125,6 +125,18 @@ public:
         return *this;
     }
 
+    /**
+     * Sets an already serialized json payload for this message. The payload is spliced verbatim into the output of
+     * @c get(), avoiding a parse and re-serialization of payloads which are only forwarded.
+     * @note The caller is responsible for @c payload being valid json
+     * @param payload The serialized json payload to send
+     * @return this
+     */
+    Message& setRawPayload(std::string payload) {
+        mRawPayload = std::move(payload);
+        return *this;
+    }
+
     /**
      * Retrieves the rapidjson allocator
      * @return The allocator
@@ -138,8 +150,7 @@ public:
      * @return json string representation of message
      */
     std::string get() {
-        rapidjson::StringBuffer buffer;
-        buffer.Clear();
+        rapidjson::StringBuffer buffer(nullptr, mRawPayload.size() + rapidjson::StringBuffer::kDefaultCapacity);
         rapidjson::Writer<
             rapidjson::StringBuffer,
             rapidjson::UTF8<>,
@@ -147,8 +158,21 @@ public:
             rapidjson::CrtAllocator,
             rapidjson::kWriteNanAndInfFlag>
             writer(buffer);
-        if (!mDocument.Accept(writer)) {
-            return EMPTY_JSON;
+        if (mRawPayload.empty()) {
+            if (!mDocument.Accept(writer)) {
+                return EMPTY_JSON;
+            }
+        } else {
+            writer.StartObject();
+            for (auto& member : mDocument.GetObject()) {
+                writer.Key(member.name.GetString(), member.name.GetStringLength());
+                if (!member.value.Accept(writer)) {
+                    return EMPTY_JSON;
+                }
+            }
+            writer.Key(MSG_PAYLOAD_TAG);
+            writer.RawValue(mRawPayload.c_str(), mRawPayload.size(), rapidjson::kObjectType);
+            writer.EndObject();
         }
         return std::string(buffer.GetString(), buffer.GetSize());
     }
@@ -158,8 +182,17 @@ public:
      * @return @c rapidjson::Value object representation of message
      */
     rapidjson::Value&& getValue() {
+        if (!mRawPayload.empty()) {
+            rapidjson::Document payload(&mDocument.GetAllocator());
+            mDocument.AddMember(MSG_PAYLOAD_TAG, payload.Parse(mRawPayload), mDocument.GetAllocator());
+            mRawPayload.clear();
+        }
         return std::move(mDocument);
     };
+
+private:
+    /// Serialized json payload set through @c setRawPayload, empty if none.
+    std::string mRawPayload;
 };
 }  // namespace messages
 }  // namespace sampleApp
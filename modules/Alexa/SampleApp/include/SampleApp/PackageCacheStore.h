@@ -0,0 +1,212 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_INCLUDE_SAMPLEAPP_PACKAGECACHESTORE_H_
+#define ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_INCLUDE_SAMPLEAPP_PACKAGECACHESTORE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <AVSCommon/SDKInterfaces/Storage/MiscStorageInterface.h>
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+
+/**
+ * A persistent store for downloaded APL packages. Each package body is written to its own file in a dedicated
+ * subdirectory of the cache directory, named after a hash and the size of its content, so identical packages served
+ * from different URLs share a single file. A file is only shared once its bytes are found to match. A small index
+ * table in misc storage maps each source URL (keyed by its hash) to the file and the time it was fetched.
+ *
+ * The subdirectory holds a marker file, and the store only ever deletes files there that follow its naming scheme.
+ *
+ * Only the index is read at startup; package bodies are read from disk when they are requested.
+ *
+ * This class is thread safe.
+ */
+class PackageCacheStore {
+public:
+    /**
+     * Metadata describing a single cached package.
+     */
+    struct Entry {
+        /// The source URL of the package.
+        std::string source;
+        /// Name of the file holding the package content, relative to the cache directory.
+        std::string fileName;
+        /// Size of the package content in bytes.
+        uint64_t size = 0;
+        /// Time when the package was last fetched or revalidated.
+        std::chrono::system_clock::time_point importTime;
+        /// Identifies the store operation that produced this entry. Only the latest generation of a source can be
+        /// touched or removed. It is not persisted.
+        uint64_t generation = 0;
+    };
+
+    /**
+     * Creates a @c PackageCacheStore.
+     *
+     * @param directory The cache directory, created if it does not exist. Package files are kept in a subdirectory.
+     * @param miscStorage Wrapper to read and write to the misc storage database holding the index.
+     * @return The new store, or @c nullptr if the directory or the index table could not be set up.
+     */
+    static std::shared_ptr<PackageCacheStore> create(
+        const std::string& directory,
+        std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface> miscStorage);
+
+    /**
+     * Loads the index of cached packages. Package contents are not read. Index rows whose file is missing or has an
+     * unexpected size are dropped, as are package files no longer referenced by the index.
+     *
+     * @param[out] entries The cached packages.
+     * @return @c true if the index was loaded.
+     */
+    bool loadIndex(std::vector<Entry>* entries);
+
+    /**
+     * Stores the content downloaded from @c source, replacing any previous entry for that source.
+     *
+     * @param source The source URL.
+     * @param content The package content.
+     * @param[out] entry The stored entry.
+     * @return @c true if the content and its index row were written.
+     */
+    bool put(const std::string& source, const std::string& content, Entry* entry);
+
+    /**
+     * Reads the content of a cached package from its file.
+     *
+     * @param entry The cached package.
+     * @param[out] content The package content.
+     * @return @c true if the content was read, @c false if the file is missing or does not match the entry.
+     */
+    bool read(const Entry& entry, std::string* content) const;
+
+    /**
+     * Marks a cached package as fetched now, after the source confirmed it has not changed.
+     *
+     * @param[in,out] entry The cached package, whose import time and generation are updated.
+     * @return @c true if the index row was updated, @c false if it failed or @c entry was removed or superseded.
+     */
+    bool touch(Entry* entry);
+
+    /**
+     * Removes a cached package. The file is deleted once no other source refers to it. Nothing is removed if the
+     * source has been stored again since @c entry was produced.
+     *
+     * @param entry The cached package.
+     */
+    void remove(const Entry& entry);
+
+    /**
+     * Removes all cached packages and their index.
+     *
+     * @return @c true if the store was cleared.
+     */
+    bool clear();
+
+    /**
+     * Returns the content address used to name the file holding @c content. Distinct contents with the same address
+     * are stored under numbered variants of it.
+     *
+     * @param content The package content.
+     * @return The file name for @c content.
+     */
+    static std::string contentFileName(const std::string& content);
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param directory The subdirectory holding the package files.
+     * @param miscStorage Wrapper to read and write to the misc storage database holding the index.
+     */
+    PackageCacheStore(
+        const std::string& directory,
+        std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface> miscStorage);
+
+    /**
+     * Writes the index row for @c entry.
+     *
+     * @param entry The cached package.
+     * @return @c true if the row was written.
+     */
+    bool writeIndex(const Entry& entry);
+
+    /**
+     * Drops a reference to @c fileName and deletes the file if it is no longer referenced.
+     * @note @c m_mutex must be held by the caller.
+     *
+     * @param fileName The package file.
+     */
+    void releaseFileLocked(const std::string& fileName);
+
+    /**
+     * Returns the absolute path of a package file.
+     *
+     * @param fileName The package file.
+     * @return The path of the file in the cache directory.
+     */
+    std::string pathOf(const std::string& fileName) const;
+
+    /**
+     * Checks that the package directory still carries the cache marker, before files are removed from it.
+     *
+     * @return @c true if files may be removed from the package directory.
+     */
+    bool ownsDirectory() const;
+
+    /// The subdirectory holding the package files.
+    const std::string m_directory;
+
+    /// The wrapper to read and write to local misc storage.
+    std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface> m_miscStorage;
+
+    /**
+     * The current state of a cached source.
+     */
+    struct StoredSource {
+        /// The file holding the content of the source.
+        std::string fileName;
+        /// The generation of the latest entry produced for the source.
+        uint64_t generation;
+    };
+
+    /// Guards @c m_sourceFiles, @c m_fileReferences and @c m_generation.
+    std::mutex m_mutex;
+
+    /// Maps each cached source to the file holding its content.
+    std::unordered_map<std::string, StoredSource> m_sourceFiles;
+
+    /// Number of cached sources referring to each file.
+    std::unordered_map<std::string, unsigned int> m_fileReferences;
+
+    /// Counter used to give concurrent writers distinct temporary files.
+    std::atomic<uint64_t> m_tempFileCounter;
+
+    /// The generation given to the latest entry produced by the store.
+    uint64_t m_generation;
+};
+
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
+
+#endif  // ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_INCLUDE_SAMPLEAPP_PACKAGECACHESTORE_H_
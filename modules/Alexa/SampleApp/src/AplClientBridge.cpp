@@ -30,6 +30,9 @@ namespace sampleApp {
 static const std::string TAG{"AplClientBridge"};
 #define LX(event) alexaClientSDK::avsCommon::utils::logger::LogEntry(TAG, event)
 
+/// The default maximum number of update ticks per second.
+static const int DEFAULT_MAX_FRAME_RATE = 60;
+
 using namespace alexaClientSDK::avsCommon::avs::attachment;
 using namespace alexaClientSDK::avsCommon::sdkInterfaces;
 using namespace alexaClientSDK::avsCommon::utils::libcurlUtils;
@@ -55,10 +58,28 @@ AplClientBridge::AplClientBridge(
     AplClientBridgeParameter parameters) :
         RequiresShutdown{"AplClientBridge"},
         m_contentDownloadManager{contentDownloadManager},
+        m_connectionOpen{false},
+        m_skippedUpdateTicks{0},
+        m_coalescedUpdateTicks{0},
+        m_updateTicks{0},
         m_guiClient{guiClient},
         m_renderQueued{false},
         m_parameters{parameters} {
     m_playerActivityState = alexaClientSDK::avsCommon::avs::PlayerActivity::FINISHED;
+    if (m_parameters.maxFrameRate < 1) {
+        m_parameters.maxFrameRate = DEFAULT_MAX_FRAME_RATE;
+    }
+    m_minUpdateInterval = std::chrono::milliseconds(1000 / m_parameters.maxFrameRate);
+    if (m_parameters.audioProgressGranularity < 0) {
+        m_parameters.audioProgressGranularity = 0;
+    }
+    if (m_parameters.maxLiveBackstackDocuments < 0) {
+        m_parameters.maxLiveBackstackDocuments = 0;
+    }
+    if (m_parameters.maxLiveBackstackBytes < 0) {
+        m_parameters.maxLiveBackstackBytes = 0;
+    }
+    m_scheduledUpdateTick = std::chrono::steady_clock::time_point::max();
 }
 
 void AplClientBridge::initializeRenderer(const std::string& windowId, std::set<std::string> supportedExtensions) {
@@ -68,10 +89,15 @@ void AplClientBridge::initializeRenderer(const std::string& windowId, std::set<s
             std::unordered_set<std::shared_ptr<APLClient::Extensions::AplCoreExtensionInterface>> extensions;
             for (auto& uri : supportedExtensions) {
                 if (APLClient::Extensions::Backstack::URI == uri) {
-                    extensions.emplace(std::make_shared<Backstack::AplBackstackExtension>(shared_from_this()));
+                    auto backstackExtension = std::make_shared<Backstack::AplBackstackExtension>(shared_from_this());
+                    backstackExtension->setCacheLimits(
+                        m_parameters.maxLiveBackstackDocuments, m_parameters.maxLiveBackstackBytes);
+                    extensions.emplace(backstackExtension);
                 } else if (APLClient::Extensions::AudioPlayer::URI == uri) {
                     auto audioPlayerExtension =
                         std::make_shared<AudioPlayer::AplAudioPlayerExtension>(shared_from_this());
+                    audioPlayerExtension->setPlaybackProgressGranularity(
+                        std::chrono::milliseconds(m_parameters.audioProgressGranularity));
                     extensions.emplace(audioPlayerExtension);
                     m_audioPlayerExtensions.push_back(audioPlayerExtension);
                 }
@@ -86,10 +112,9 @@ void AplClientBridge::initializeRenderer(const std::string& windowId, std::set<s
 
 void AplClientBridge::sendMessage(const std::string& token, const std::string& payload) {
     ACSDK_DEBUG9(LX(__func__));
-    std::string newPayload = payload;
     auto aplClientRenderer = getAplClientRendererFromAplToken(token);
     if (aplClientRenderer) {
-        auto aplCoreMessage = messages::AplCoreMessage(aplClientRenderer->getWindowId(), newPayload);
+        auto aplCoreMessage = messages::AplCoreMessage(aplClientRenderer->getWindowId(), payload);
         m_guiClient->sendMessage(aplCoreMessage);
     }
 }
@@ -195,6 +220,8 @@ void AplClientBridge::onExtensionEvent(
         if (aplClientRenderer) {
             aplClientRenderer->onExtensionEvent(uri, name, source, params, event, resultCallback);
         }
+        // Extensions may have resolved actions or changed properties, which only a tick renders
+        requestUpdateTick();
     });
 }
 
@@ -221,20 +248,25 @@ void AplClientBridge::logMessage(APLClient::LogLevel level, const std::string& s
 
 void AplClientBridge::onConnectionOpened() {
     ACSDK_DEBUG9(LX("onConnectionOpened"));
-    // Start the scheduled event timer to refresh the display at 60fps
+    // Update ticks are only scheduled while renderers have pending work, capped at the configured frame rate
     m_executor.submit([this] {
-        m_updateTimer.start(
-            std::chrono::milliseconds(16),
-            Timer::PeriodType::ABSOLUTE,
-            Timer::FOREVER,
-            std::bind(&AplClientBridge::onUpdateTimer, this));
+        m_connectionOpen = true;
+        requestUpdateTick();
     });
 }
 
 void AplClientBridge::onConnectionClosed() {
     ACSDK_DEBUG9(LX("onConnectionClosed"));
     // Stop the outstanding timer as the client is no longer connected
-    m_executor.submit([this] { m_updateTimer.stop(); });
+    m_executor.submit([this] {
+        m_connectionOpen = false;
+        m_updateTimer.stop();
+        m_scheduledUpdateTick = std::chrono::steady_clock::time_point::max();
+        ACSDK_DEBUG5(LX("updateTickStats")
+                         .d("skipped", m_skippedUpdateTicks.load())
+                         .d("coalesced", m_coalescedUpdateTicks.load())
+                         .d("executed", m_updateTicks.load()));
+    });
 }
 
 void AplClientBridge::provideState(const std::string& aplToken, const unsigned int stateRequestToken) {
@@ -252,22 +284,93 @@ void AplClientBridge::onUpdateTimer() {
     bool renderQueued = m_renderQueued.exchange(true);
     if (renderQueued) {
         // Render was already queued, we can safely skip this rendering
+        m_skippedUpdateTicks++;
         return;
     }
 
-    m_executor.submit([this] {
-        m_renderQueued = false;
-        for (auto aplClientRendererPair : m_aplClientRendererMap) {
-            aplClientRendererPair.second->onUpdateTick();
-        }
+    m_executor.submit([this] { executeUpdateTick(); });
+}
 
-        if (m_guiManager && alexaClientSDK::avsCommon::avs::PlayerActivity::PLAYING == m_playerActivityState) {
+void AplClientBridge::requestUpdateTick() {
+    scheduleUpdateTick(std::chrono::milliseconds::zero());
+}
+
+void AplClientBridge::scheduleUpdateTick(std::chrono::milliseconds delay) {
+    if (!m_connectionOpen) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto requestedTick = now + delay;
+    auto nextAllowedTick = m_lastUpdateTick + m_minUpdateInterval;
+    auto updateTick = requestedTick;
+    if (nextAllowedTick > requestedTick) {
+        updateTick = nextAllowedTick;
+        m_skippedUpdateTicks++;
+    }
+
+    if (m_scheduledUpdateTick <= updateTick) {
+        // A tick which is due no later is already scheduled
+        m_coalescedUpdateTicks++;
+        return;
+    }
+
+    m_updateTimer.stop();
+    m_scheduledUpdateTick = updateTick;
+    m_updateTimer.start(
+        std::chrono::duration_cast<std::chrono::milliseconds>(updateTick - now),
+        std::bind(&AplClientBridge::onUpdateTimer, this));
+}
+
+void AplClientBridge::executeUpdateTick() {
+    m_renderQueued = false;
+    m_updateTicks++;
+    m_lastUpdateTick = std::chrono::steady_clock::now();
+    m_scheduledUpdateTick = std::chrono::steady_clock::time_point::max();
+
+    auto nextUpdateDelay = std::chrono::milliseconds::max();
+    for (auto aplClientRendererPair : m_aplClientRendererMap) {
+        aplClientRendererPair.second->onUpdateTick();
+        nextUpdateDelay = std::min(nextUpdateDelay, aplClientRendererPair.second->getNextUpdateDelay());
+    }
+
+    if (m_guiManager && alexaClientSDK::avsCommon::avs::PlayerActivity::PLAYING == m_playerActivityState) {
+        // Only query the offset when an extension's published progress is due to change
+        auto progressDelay = getNextPlaybackProgressDelay();
+        if (std::chrono::milliseconds::zero() == progressDelay) {
             double audioItemOffset = m_guiManager->getAudioItemOffset().count();
             for (const auto& audioPlayerExtension : m_audioPlayerExtensions) {
                 audioPlayerExtension->updatePlaybackProgress(audioItemOffset);
             }
+            progressDelay = getNextPlaybackProgressDelay();
         }
-    });
+        // Keep ticking while audio is playing so that the playback progress stays current
+        nextUpdateDelay = std::min(nextUpdateDelay, progressDelay);
+    }
+
+    if (nextUpdateDelay != std::chrono::milliseconds::max()) {
+        scheduleUpdateTick(nextUpdateDelay);
+    }
+}
+
+std::chrono::milliseconds AplClientBridge::getNextPlaybackProgressDelay() const {
+    auto delay = std::chrono::milliseconds::max();
+    for (const auto& audioPlayerExtension : m_audioPlayerExtensions) {
+        delay = std::min(delay, audioPlayerExtension->getNextPlaybackProgressDelay());
+    }
+    return delay;
+}
+
+uint64_t AplClientBridge::getSkippedUpdateTickCount() const {
+    return m_skippedUpdateTicks;
+}
+
+uint64_t AplClientBridge::getCoalescedUpdateTickCount() const {
+    return m_coalescedUpdateTicks;
+}
+
+uint64_t AplClientBridge::getUpdateTickCount() const {
+    return m_updateTicks;
 }
 
 void AplClientBridge::setGUIManager(std::shared_ptr<GUIServerInterface> guiManager) {
@@ -299,13 +402,17 @@ void AplClientBridge::renderDocument(
 
         if (auto backExtension = getBackExtensionForRenderer(aplClientRenderer)) {
             if (backExtension->shouldCacheActiveDocument()) {
-                if (auto documentState = aplClientRenderer->getActiveDocumentState()) {
+                // The size of every cached state is estimated, as it is reported even without a byte limit
+                if (auto documentState = aplClientRenderer->getActiveDocumentState(true)) {
                     backExtension->addDocumentStateToBackstack(documentState);
+                    aplClientRenderer->reportBackstackSize(
+                        documentState, backExtension->getDocumentCount(), backExtension->getLiveDocumentBytes());
                 }
             }
         }
 
         aplClientRenderer->renderDocument(document, dataSources, supportedViewports, token);
+        requestUpdateTick();
     });
 }
 
@@ -342,6 +449,7 @@ void AplClientBridge::executeCommands(const std::string& jsonPayload, const std:
         auto aplClientRenderer = getAplClientRendererFromAplToken(token);
         if (aplClientRenderer) {
             aplClientRenderer->executeCommands(jsonPayload, token);
+            requestUpdateTick();
         }
     });
 }
@@ -352,6 +460,7 @@ void AplClientBridge::interruptCommandSequence(const std::string& token) {
         auto aplClientRenderer = getAplClientRendererFromAplToken(token);
         if (aplClientRenderer) {
             aplClientRenderer->interruptCommandSequence();
+            requestUpdateTick();
         }
     });
 }
@@ -365,16 +474,20 @@ void AplClientBridge::dataSourceUpdate(
         auto aplClientRenderer = getAplClientRendererFromAplToken(token);
         if (aplClientRenderer) {
             aplClientRenderer->dataSourceUpdate(sourceType, jsonPayload, token);
+            requestUpdateTick();
         }
     });
 }
 
-void AplClientBridge::onMessage(const std::string& windowId, const std::string& message) {
+void AplClientBridge::onMessage(const std::string& windowId, std::shared_ptr<const rapidjson::Value> message) {
     ACSDK_DEBUG9(LX(__func__));
 
     auto aplClientRenderer = getAplClientRendererFromWindowId(windowId);
-    if (aplClientRenderer && aplClientRenderer->shouldHandleMessage(message)) {
-        m_executor.submit([message, aplClientRenderer] { aplClientRenderer->handleMessage(message); });
+    if (aplClientRenderer && aplClientRenderer->shouldHandleMessage(*message)) {
+        m_executor.submit([this, message, aplClientRenderer] {
+            aplClientRenderer->handleMessage(*message);
+            requestUpdateTick();
+        });
     }
 }
 
@@ -383,7 +496,9 @@ bool AplClientBridge::handleBack() {
         .submit([this] {
             if (auto aplClientRenderer = getAplClientRendererFromWindowId(m_lastRenderedWindowId)) {
                 if (auto backExtension = getBackExtensionForRenderer(aplClientRenderer)) {
-                    return backExtension->handleBack();
+                    auto handled = backExtension->handleBack();
+                    requestUpdateTick();
+                    return handled;
                 }
             }
             return false;
@@ -421,8 +536,9 @@ void AplClientBridge::onRestoreDocumentState(std::shared_ptr<APLClient::AplDocum
     if (aplClientRenderer) {
         // The restored document's token is now associated with the active renderer's window id
         setTokenToWindow(documentState->token, aplClientRenderer->getWindowId());
-        return aplClientRenderer->restoreDocumentState(documentState);
+        aplClientRenderer->restoreDocumentState(documentState);
     }
+    m_executor.submit([this] { requestUpdateTick(); });
 }
 
 void AplClientBridge::onPlayerActivityChanged(
@@ -434,6 +550,7 @@ void AplClientBridge::onPlayerActivityChanged(
             audioPlayerExtension->updatePlayerActivity(
                 playerActivityToString(m_playerActivityState), context.offset.count());
         }
+        requestUpdateTick();
     });
 }
 
@@ -13,7 +13,9 @@
  * permissions and limitations under the License.
  */
 
-#include <fstream>
+#include <algorithm>
+#include <ctime>
+#include <future>
 #include <unordered_map>
 
 #include <AVSCommon/Utils/JSON/JSONUtils.h>
@@ -34,173 +36,278 @@ using namespace alexaClientSDK::avsCommon::utils::sds;
 
 /// Process attachment ID
 static const std::string PROCESS_ATTACHMENT_ID = "import_download:";
-/// A wait period for a polling loop that constantly check if a content fetcher finished fetching the payload or failed.
-static const std::chrono::milliseconds WAIT_FOR_ACTIVITY_TIMEOUT{100};
+/// How long a read from the attachment waits for data before checking on the content fetcher.
+static const std::chrono::milliseconds READ_TIMEOUT{100};
 /// Timeout to wait for am item to arrive from the content fetcher
 static const std::chrono::minutes FETCH_TIMEOUT{5};
-/// The number of bytes read from the attachment with each read in the read loop.
-static const size_t CHUNK_SIZE(1024);
-/// Component name for SmartScreenSampleApp
-static const std::string COMPONENT_NAME = "SmartScreenSampleApp";
-/// Table name for APL packages
-static const std::string TABLE_NAME = "Packages";
-/// Delimiter to separate package content and import time, since we currently have only one column for value in misc
-/// storage
-static const std::string DELIMITER = "||||";
+/// The maximum number of bytes read from the attachment with each read in the read loop.
+static const size_t READ_SIZE(64 * 1024);
+/// Upper bound on the buffer allocated up front from a Content-Length header.
+static const size_t MAX_PRESIZED_CONTENT_LENGTH(16 * 1024 * 1024);
 /// The number of retries when downloading a package from source
 static const int DOWNLOAD_FROM_SOURCE_RETRY_ATTEMPTS = 3;
+/// HTTP status returned by the source when a conditional request finds the content unchanged.
+static const long HTTP_NOT_MODIFIED = 304;
+
+/**
+ * Formats a time as an HTTP-date, for use in conditional request headers.
+ *
+ * @param time The time to format.
+ * @return The time formatted as in RFC 7231 section 7.1.1.1.
+ */
+static std::string toHttpDate(std::chrono::system_clock::time_point time) {
+    auto seconds = std::chrono::system_clock::to_time_t(time);
+    std::tm utc;
+    gmtime_r(&seconds, &utc);
+    char buffer[64];
+    auto length = std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+    return std::string(buffer, length);
+}
 
 CachingDownloadManager::CachingDownloadManager(
     std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::HTTPContentFetcherInterfaceFactoryInterface>
         httpContentFetcherInterfaceFactoryInterface,
     unsigned long cachePeriodInSeconds,
     unsigned long maxCacheSize,
+    uint64_t maxCacheSizeInBytes,
     std::shared_ptr<alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface> miscStorage,
-    const std::shared_ptr<alexaClientSDK::registrationManager::CustomerDataManagerInterface> customerDataManager) :
+    const std::shared_ptr<alexaClientSDK::registrationManager::CustomerDataManagerInterface> customerDataManager,
+    const std::string& cacheDirectory) :
         CustomerDataHandler{customerDataManager},
         m_contentFetcherFactory{httpContentFetcherInterfaceFactoryInterface},
         m_cachePeriod{std::chrono::seconds(cachePeriodInSeconds)},
         m_maxCacheSize{maxCacheSize},
-        m_miscStorage(miscStorage) {
-    bool doesTableExist = false;
-    if (!m_miscStorage->tableExists(COMPONENT_NAME, TABLE_NAME, &doesTableExist)) {
-        ACSDK_ERROR(LX(__func__).m("Cannot check for table existence."));
+        m_maxCacheSizeInBytes{maxCacheSizeInBytes},
+        m_cacheSizeInBytes{0},
+        m_packageStore{PackageCacheStore::create(cacheDirectory, miscStorage)} {
+    if (!m_packageStore) {
+        ACSDK_ERROR(LX(__func__).d("directory", cacheDirectory).m("Cannot create package store, caching disabled."));
+        return;
     }
 
-    if (!doesTableExist) {
-        if (!m_miscStorage->createTable(
-                COMPONENT_NAME,
-                TABLE_NAME,
-                alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface::KeyType::STRING_KEY,
-                alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface::ValueType::STRING_VALUE)) {
-            ACSDK_ERROR(LX(__func__).m("Cannot create table for storing APL packages."));
-        }
-    } else {
-        std::unordered_map<std::string, std::string> packageMap;
-        if (!m_miscStorage->load(COMPONENT_NAME, TABLE_NAME, &packageMap)) {
-            ACSDK_ERROR(LX(__func__).m("Cannot load downloaded packages."));
-        }
-        for (auto kvp : packageMap) {
-            size_t delimiterPos = kvp.second.find(DELIMITER);
-            if (delimiterPos == std::string::npos) {
-                ACSDK_ERROR(LX(__func__).m("Package content for " + kvp.first + " is corrupted."));
-            } else {
-                auto timeStamp = kvp.second.substr(0, delimiterPos);
-                auto packageContent = kvp.second.substr(delimiterPos + DELIMITER.length());
-                auto importTime =
-                    std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(std::stol(timeStamp)));
-                if (std::chrono::system_clock::now() - importTime < m_cachePeriod) {
-                    ACSDK_DEBUG9(LX(__func__).m("Loaded package " + kvp.first + " from misc storage"));
-                    cachedContentMap[kvp.first] = CachedContent(importTime, packageContent);
-                }
-            }
-        }
+    std::vector<PackageCacheStore::Entry> entries;
+    if (!m_packageStore->loadIndex(&entries)) {
+        ACSDK_ERROR(LX(__func__).m("Cannot load downloaded packages."));
     }
-}
 
-CachingDownloadManager::CachedContent::CachedContent(
-    std::chrono::system_clock::time_point importTime,
-    const std::string& content) {
-    this->importTime = importTime;
-    this->content = content;
+    // Access times are not persisted, so packages loaded from the index are ranked by when they were fetched.
+    std::sort(entries.begin(), entries.end(), [](const PackageCacheStore::Entry& a, const PackageCacheStore::Entry& b) {
+        return a.importTime < b.importTime;
+    });
+    const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
+    for (auto& entry : entries) {
+        ACSDK_DEBUG9(LX(__func__).m("Loaded package " + entry.source + " from package index"));
+        insertLocked(std::move(entry));
+    }
+    cleanUpCache(nullptr);
 }
 
 std::string CachingDownloadManager::retrieveContent(const std::string& source, std::shared_ptr<Observer> observer) {
-    {
-        const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
-        if (cachedContentMap.find(source) != cachedContentMap.end()) {
-            if ((std::chrono::system_clock::now() - cachedContentMap[source].importTime) < m_cachePeriod) {
-                ACSDK_DEBUG9(LX("retrieveContent").d("contentSource", "returnedFromCache"));
-                if (observer) {
-                    observer->onCacheHit();
+    std::string content;
+    PackageCacheStore::Entry cachedEntry;
+    bool isCached = false;
+    std::shared_ptr<std::promise<std::string>> download;
+    std::shared_future<std::string> pendingDownload;
+
+    // The cache lookup and the registration of a download happen under the same lock, so that concurrent requests
+    // for the same source either find the cached content or join a single download.
+    while (!download && !pendingDownload.valid()) {
+        {
+            const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
+            auto it = cachedContentMap.find(source);
+            isCached = it != cachedContentMap.end();
+            if (isCached) {
+                m_lruList.splice(m_lruList.begin(), m_lruList, it->second.lruPosition);
+                cachedEntry = it->second.entry;
+            }
+            if (!isCached || (std::chrono::system_clock::now() - cachedEntry.importTime) >= m_cachePeriod) {
+                auto pending = m_pendingDownloads.find(source);
+                if (pending != m_pendingDownloads.end()) {
+                    pendingDownload = pending->second;
+                } else {
+                    download = std::make_shared<std::promise<std::string>>();
+                    m_pendingDownloads.emplace(source, download->get_future().share());
                 }
-                return cachedContentMap[source].content;
+                break;
             }
         }
+
+        // A failed read drops the entry, so the next lookup starts a download.
+        if (readFromStore(cachedEntry, &content)) {
+            ACSDK_DEBUG9(LX("retrieveContent").d("contentSource", "returnedFromCache"));
+            if (observer) {
+                observer->onCacheHit();
+            }
+            return content;
+        }
+    }
+
+    if (pendingDownload.valid()) {
+        content = pendingDownload.get();
+        ACSDK_DEBUG9(LX("retrieveContent").d("contentSource", "joinedPendingDownload").d("success", !content.empty()));
+        if (observer && !content.empty()) {
+            observer->onDownloadCoalesced();
+        }
+        return content;
     }
 
+    content = fetchContent(source, observer, cachedEntry, isCached);
+    {
+        const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
+        m_pendingDownloads.erase(source);
+    }
+    download->set_value(content);
+    return content;
+}
+
+std::string CachingDownloadManager::fetchContent(
+    const std::string& source,
+    std::shared_ptr<Observer> observer,
+    PackageCacheStore::Entry cachedEntry,
+    bool isCached) {
     std::string content;
 
+    if (observer) {
+        observer->onCacheMiss();
+    }
+
+    // A stale entry is revalidated rather than discarded: the source only sends the content again if it changed since
+    // the entry was fetched.
+    std::vector<std::string> customHeaders;
+    if (isCached) {
+        customHeaders.push_back("If-Modified-Since: " + toHttpDate(cachedEntry.importTime));
+    }
+
     for (int i = 0; i < DOWNLOAD_FROM_SOURCE_RETRY_ATTEMPTS; i++) {
-        content = downloadFromSource(source, observer);
-        ACSDK_DEBUG9(LX("retrieveContent").d("contentSource", "downloadedFromSource"));
+        bool notModified = false;
+        content = downloadFromSource(source, observer, customHeaders, &notModified);
+
+        if (notModified) {
+            if (readFromStore(cachedEntry, &content)) {
+                ACSDK_DEBUG9(LX("fetchContent").d("contentSource", "revalidatedCache"));
+                // The entry may have been evicted while revalidating, in which case it is not cached again.
+                if (m_packageStore->touch(&cachedEntry)) {
+                    const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
+                    insertLocked(std::move(cachedEntry));
+                } else {
+                    ACSDK_WARN(LX("fetchContent").m("Failed to refresh package index entry."));
+                }
+                return content;
+            }
+            // The cached file vanished while revalidating, fetch the whole content instead.
+            isCached = false;
+            customHeaders.clear();
+            continue;
+        }
+
+        ACSDK_DEBUG9(LX("fetchContent").d("contentSource", "downloadedFromSource"));
 
         if (!content.empty()) {
-            auto cachedContent = CachedContent(std::chrono::system_clock::now(), content);
-            {
+            PackageCacheStore::Entry entry;
+            if (m_packageStore && m_packageStore->put(source, content, &entry)) {
                 const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
-                cachedContentMap[source] = cachedContent;
-                cleanUpCache();
+                insertLocked(std::move(entry));
+                cleanUpCache(observer);
+            } else if (m_packageStore) {
+                ACSDK_ERROR(LX("fetchContent").m("Failed to write package to disk storage."));
             }
-
-            writeToStorage(source, cachedContent);
             return content;
         }
     }
-    ACSDK_ERROR(LX("retrieveContent").d("contentSource", "downloadedFromSourceFailedAllRetries"));
+    ACSDK_ERROR(LX("fetchContent").d("contentSource", "downloadedFromSourceFailedAllRetries"));
+
+    // Serving a stale package is better than failing the import when the source cannot be reached.
+    if (isCached && readFromStore(cachedEntry, &content)) {
+        ACSDK_WARN(LX("fetchContent").d("contentSource", "returnedStaleFromCache"));
+        if (observer) {
+            observer->onCacheHit();
+        }
+    }
 
     return content;
 }
 
-void CachingDownloadManager::writeToStorage(
-    std::string source,
-    alexaSmartScreenSDK::sampleApp::CachingDownloadManager::CachedContent content) {
-    m_executor.submit([this, source, content] {
-        if (!m_miscStorage->put(COMPONENT_NAME, TABLE_NAME, source, cachedContentToString(content, DELIMITER))) {
-            ACSDK_ERROR(LX(__func__).m("Failed to write package to disk storage."));
-        } else {
-            ACSDK_DEBUG9(LX(__func__).m("Successfully stored " + source + " to disk"));
-        }
-    });
+bool CachingDownloadManager::readFromStore(const PackageCacheStore::Entry& entry, std::string* content) {
+    if (m_packageStore && m_packageStore->read(entry, content)) {
+        return true;
+    }
+
+    const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
+    auto it = cachedContentMap.find(entry.source);
+    if (it != cachedContentMap.end() && it->second.entry.generation == entry.generation) {
+        removeFromStorage(it->second.entry);
+        eraseLocked(it);
+    }
+    return false;
 }
 
-void CachingDownloadManager::cleanUpCache() {
-    std::chrono::system_clock::time_point oldestTime = std::chrono::system_clock::time_point::max();
-    std::string oldestSource;
-
-    for (auto it = cachedContentMap.begin(); it != cachedContentMap.end();) {
-        if ((std::chrono::system_clock::now() - it->second.importTime) > m_cachePeriod) {
-            removeFromStorage(it->first);
-            it = cachedContentMap.erase(it);
-            ACSDK_DEBUG9(LX("cleanUpCache").d("deletedCacheEntry", "entryExpired"));
-        } else {
-            if (it->second.importTime < oldestTime) {
-                oldestTime = it->second.importTime;
-                oldestSource = it->first;
-            }
-            it++;
-        }
+void CachingDownloadManager::insertLocked(PackageCacheStore::Entry entry) {
+    auto it = cachedContentMap.find(entry.source);
+    if (it != cachedContentMap.end()) {
+        eraseLocked(it);
     }
+    m_lruList.push_front(entry.source);
+    m_cacheSizeInBytes += entry.size;
+    auto source = entry.source;
+    cachedContentMap.emplace(std::move(source), CacheItem{std::move(entry), m_lruList.begin()});
+}
+
+void CachingDownloadManager::eraseLocked(std::unordered_map<std::string, CacheItem>::iterator it) {
+    m_cacheSizeInBytes -= it->second.entry.size;
+    m_lruList.erase(it->second.lruPosition);
+    cachedContentMap.erase(it);
+}
 
-    if (cachedContentMap.size() > m_maxCacheSize) {
-        cachedContentMap.erase(oldestSource);
-        ACSDK_DEBUG9(LX("cleanUpCache").d("deletedCacheEntry", "maxCacheSizeReached"));
+void CachingDownloadManager::cleanUpCache(std::shared_ptr<Observer> observer) {
+    while (!m_lruList.empty() && (cachedContentMap.size() > m_maxCacheSize ||
+                                  (m_maxCacheSizeInBytes > 0 && m_cacheSizeInBytes > m_maxCacheSizeInBytes))) {
+        auto it = cachedContentMap.find(m_lruList.back());
+        auto evictedBytes = it->second.entry.size;
+        removeFromStorage(it->second.entry);
+        eraseLocked(it);
+        ACSDK_DEBUG9(LX("cleanUpCache")
+                         .d("deletedCacheEntry", "cacheBudgetReached")
+                         .d("entries", cachedContentMap.size())
+                         .d("bytes", m_cacheSizeInBytes));
+        if (observer) {
+            observer->onCacheEviction(evictedBytes);
+        }
     }
 }
 
 void CachingDownloadManager::clearData() {
     ACSDK_DEBUG5(LX(__func__));
-    if (!m_miscStorage->clearTable(COMPONENT_NAME, TABLE_NAME)) {
-        ACSDK_ERROR(LX("clearTableFailed").d("reason", "unable to clear the table from the database"));
+    {
+        const std::lock_guard<std::mutex> lock(cachedContentMapMutex);
+        cachedContentMap.clear();
+        m_lruList.clear();
+        m_cacheSizeInBytes = 0;
+    }
+    if (m_packageStore && !m_packageStore->clear()) {
+        ACSDK_ERROR(LX("clearTableFailed").d("reason", "unable to clear the package store"));
     }
 }
 
-void CachingDownloadManager::removeFromStorage(std::string source) {
-    m_executor.submit([this, source] {
-        if (!m_miscStorage->remove(COMPONENT_NAME, TABLE_NAME, source)) {
-            ACSDK_ERROR(LX(__func__).m("Failed to remove package " + source + " from disk."));
-        } else {
-            ACSDK_DEBUG9(LX(__func__).m("Removed package " + source + " from disk."));
-        }
+void CachingDownloadManager::removeFromStorage(const PackageCacheStore::Entry& entry) {
+    if (!m_packageStore) {
+        return;
+    }
+    m_executor.submit([this, entry] {
+        m_packageStore->remove(entry);
+        ACSDK_DEBUG9(LX(__func__).m("Removed package " + entry.source + " from disk."));
     });
 }
 
-std::string CachingDownloadManager::downloadFromSource(const std::string& source, std::shared_ptr<Observer> observer) {
+std::string CachingDownloadManager::downloadFromSource(
+    const std::string& source,
+    std::shared_ptr<Observer> observer,
+    const std::vector<std::string>& customHeaders,
+    bool* notModified) {
     if (observer) {
         observer->onDownloadStarted();
     }
     auto contentFetcher = m_contentFetcherFactory->create(source);
-    contentFetcher->getContent(HTTPContentFetcherInterface::FetchOptions::ENTIRE_BODY);
+    contentFetcher->getContent(HTTPContentFetcherInterface::FetchOptions::ENTIRE_BODY, nullptr, customHeaders);
 
     HTTPContentFetcherInterface::Header header = contentFetcher->getHeader(nullptr);
     if (!header.successful) {
@@ -211,6 +318,15 @@ std::string CachingDownloadManager::downloadFromSource(const std::string& source
         return "";
     }
 
+    if (HTTP_NOT_MODIFIED == header.responseCode && !customHeaders.empty()) {
+        ACSDK_DEBUG9(LX("downloadFromSource").sensitive("url", source).m("notModified"));
+        *notModified = true;
+        if (observer) {
+            observer->onDownloadComplete();
+        }
+        return "";
+    }
+
     if (!isStatusCodeSuccess(header.responseCode)) {
         ACSDK_ERROR(LX("downloadFromSourceFailed")
                         .d("statusCode", header.responseCode)
@@ -230,6 +346,9 @@ std::string CachingDownloadManager::downloadFromSource(const std::string& source
 
     auto stream = std::make_shared<InProcessAttachment>(PROCESS_ATTACHMENT_ID);
     std::shared_ptr<AttachmentWriter> streamWriter = stream->createWriter(WriterPolicy::BLOCKING);
+    // The body is consumed while it is being fetched, so that the reader wakes up as data arrives instead of
+    // waiting for the fetch to complete, and a body larger than the attachment buffer cannot stall the writer.
+    std::unique_ptr<AttachmentReader> reader = stream->createReader(ReaderPolicy::BLOCKING);
 
     if (!contentFetcher->getBody(streamWriter)) {
         ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "getBodyFailed"));
@@ -238,61 +357,59 @@ std::string CachingDownloadManager::downloadFromSource(const std::string& source
         }
         return "";
     }
+    // The fetcher closes the stream once the body is complete.
+    streamWriter.reset();
 
-    auto startTime = std::chrono::steady_clock::now();
-    auto elapsedTime = std::chrono::steady_clock::now() - startTime;
-    HTTPContentFetcherInterface::State contentFetcherState = contentFetcher->getState();
-    while ((FETCH_TIMEOUT > elapsedTime) && (HTTPContentFetcherInterface::State::BODY_DONE != contentFetcherState) &&
-           (HTTPContentFetcherInterface::State::ERROR != contentFetcherState)) {
-        std::this_thread::sleep_for(WAIT_FOR_ACTIVITY_TIMEOUT);
-        elapsedTime = std::chrono::steady_clock::now() - startTime;
-        contentFetcherState = contentFetcher->getState();
-    }
-
-    if (FETCH_TIMEOUT <= elapsedTime) {
-        ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "waitTimeout"));
-        if (observer) {
-            observer->onDownloadFailed();
-        }
-        return "";
-    }
-
-    if (HTTPContentFetcherInterface::State::ERROR == contentFetcherState) {
-        ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "receivingBodyFailed"));
-        if (observer) {
-            observer->onDownloadFailed();
-        }
-        return "";
+    // Read straight into the result, sized from Content-Length when the source provides it. One spare byte leaves room
+    // for the final read that observes the end of the stream, so an exact length never causes a reallocation.
+    std::string content;
+    size_t contentSize = 0;
+    if (header.contentLength > 0) {
+        content.resize(std::min(static_cast<size_t>(header.contentLength), MAX_PRESIZED_CONTENT_LENGTH) + 1);
     }
 
-    std::unique_ptr<AttachmentReader> reader = stream->createReader(ReaderPolicy::NONBLOCKING);
-
-    std::string content;
+    auto startTime = std::chrono::steady_clock::now();
     auto readStatus = AttachmentReader::ReadStatus::OK;
-    std::vector<char> buffer(CHUNK_SIZE, 0);
+    bool isBodyDone = false;
     bool streamClosed = false;
-    AttachmentReader::ReadStatus previousStatus = AttachmentReader::ReadStatus::OK_TIMEDOUT;
-    ssize_t bytesReadSoFar = 0;
-    ssize_t bytesRead = -1;
-    while (!streamClosed && bytesRead != 0) {
-        bytesRead = reader->read(buffer.data(), buffer.size(), &readStatus);
-        bytesReadSoFar += bytesRead;
-        if (previousStatus != readStatus) {
-            ACSDK_DEBUG9(LX(__func__).d("readStatus", readStatus));
-            previousStatus = readStatus;
+    while (!streamClosed) {
+        if (content.size() == contentSize) {
+            content.resize(contentSize + READ_SIZE);
         }
+        auto bytesRead = reader->read(
+            &content[contentSize], std::min(content.size() - contentSize, READ_SIZE), &readStatus, READ_TIMEOUT);
         switch (readStatus) {
             case AttachmentReader::ReadStatus::CLOSED:
                 streamClosed = true;
-                if (bytesRead == 0) {
-                    break;
-                }
                 /* FALL THROUGH - to add any data received even if closed */
             case AttachmentReader::ReadStatus::OK:
             case AttachmentReader::ReadStatus::OK_WOULDBLOCK:
-            case AttachmentReader::ReadStatus::OK_TIMEDOUT:
-                content.append(buffer.data(), bytesRead);
                 break;
+            case AttachmentReader::ReadStatus::OK_TIMEDOUT: {
+                // No data for a while. The stream is expected to be closed when the body is complete, but if the
+                // fetcher has finished without closing it, everything written has been read after one more timeout.
+                if (isBodyDone) {
+                    streamClosed = true;
+                    break;
+                }
+                auto contentFetcherState = contentFetcher->getState();
+                if (HTTPContentFetcherInterface::State::ERROR == contentFetcherState) {
+                    ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "receivingBodyFailed"));
+                    if (observer) {
+                        observer->onDownloadFailed();
+                    }
+                    return "";
+                }
+                isBodyDone = HTTPContentFetcherInterface::State::BODY_DONE == contentFetcherState;
+                if (!isBodyDone && FETCH_TIMEOUT <= std::chrono::steady_clock::now() - startTime) {
+                    ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "waitTimeout"));
+                    if (observer) {
+                        observer->onDownloadFailed();
+                    }
+                    return "";
+                }
+                break;
+            }
             case AttachmentReader::ReadStatus::OK_OVERRUN_RESET:
                 // Current AttachmentReader policy renders this outcome impossible.
                 ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "overrunReset"));
@@ -306,14 +423,24 @@ std::string CachingDownloadManager::downloadFromSource(const std::string& source
                 }
                 return "";
         }
-        if (0 == bytesRead) {
-            ACSDK_DEBUG9(LX("downloadFromSource").m("alreadyReadAllBytes"));
-        } else if (observer) {
-            observer->onBytesRead(bytesRead);
+        if (bytesRead > 0) {
+            contentSize += bytesRead;
+            if (observer) {
+                observer->onBytesRead(bytesRead);
+            }
+        }
+    }
+    content.resize(contentSize);
+
+    if (HTTPContentFetcherInterface::State::ERROR == contentFetcher->getState()) {
+        ACSDK_ERROR(LX("downloadFromSourceFailed").d("reason", "receivingBodyFailed"));
+        if (observer) {
+            observer->onDownloadFailed();
         }
+        return "";
     }
 
-    ACSDK_DEBUG9(LX("downloadFromSource").d("URL", contentFetcher->getUrl()));
+    ACSDK_DEBUG9(LX("downloadFromSource").d("URL", contentFetcher->getUrl()).d("size", contentSize));
 
     if (observer) {
         observer->onDownloadComplete();
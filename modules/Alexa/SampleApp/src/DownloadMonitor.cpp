@@ -38,6 +38,18 @@ void DownloadMonitor::onCacheHit() {
     m_metricsEmitter->onCacheHit();
 }
 
+void DownloadMonitor::onDownloadCoalesced() {
+    m_metricsEmitter->onDownloadCoalesced();
+}
+
+void DownloadMonitor::onCacheMiss() {
+    m_metricsEmitter->onCacheMiss();
+}
+
+void DownloadMonitor::onCacheEviction(uint64_t numberOfBytes) {
+    m_metricsEmitter->onCacheEviction(numberOfBytes);
+}
+
 void DownloadMonitor::onBytesRead(uint64_t numberOfBytes) {
     m_metricsEmitter->onBytesRead(numberOfBytes);
 }
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include <AVSCommon/Utils/JSON/JSONUtils.h>
+#include <rapidjson/error/en.h>
 #include <AVSCommon/Utils/Timing/Timer.h>
 
 #include <Utils/SmartScreenSDKVersion.h>
@@ -387,8 +388,6 @@ GUIClient::GUIClient(
         MESSAGE_TYPE_ACTIVITY_EVENT, [this](rapidjson::Document& payload) { executeHandleActivityEvent(payload); });
     m_messageHandlers.emplace(
         MESSAGE_TYPE_NAVIGATION_EVENT, [this](rapidjson::Document& payload) { executeHandleNavigationEvent(payload); });
-    m_messageHandlers.emplace(
-        MESSAGE_TYPE_APL_EVENT, [this](rapidjson::Document& payload) { executeHandleAplEvent(payload); });
     m_messageHandlers.emplace(
         MESSAGE_TYPE_LOG_EVENT, [this](rapidjson::Document& payload) { executeHandleLogEvent(payload); });
     m_messageHandlers.emplace(MESSAGE_TYPE_DEVICE_WINDOW_STATE, [this](rapidjson::Document& payload) {
@@ -553,36 +552,57 @@ void GUIClient::stop() {
 }
 
 void GUIClient::onMessage(const std::string& jsonPayload) {
-    m_executor.submit([this, jsonPayload]() {
-        ACSDK_DEBUG9(LX("onMessageInExector").d("payload", jsonPayload));
-        rapidjson::Document message;
-        rapidjson::ParseResult result = message.Parse(jsonPayload);
-        if (!result) {
-            ACSDK_ERROR(LX("onMessageFailed").d("reason", "parsingPayloadFailed").d("message", jsonPayload));
-            return;
-        }
+    onMessage(std::string(jsonPayload));
+}
 
-        if (m_messageListener) {
-            m_messageListener->onMessage(jsonPayload);
-        }
+void GUIClient::onMessage(std::string&& jsonPayload) {
+    // Move the payload into the task, so heavy messages are not copied on the socket thread
+    auto message = std::make_shared<InboundMessage>();
+    message->buffer = std::move(jsonPayload);
+    m_executor.submit([this, message]() { executeOnMessage(message); });
+}
 
-        std::string messageType;
-        if (!jsonUtils::retrieveValue(message, TYPE_TAG, &messageType)) {
-            ACSDK_ERROR(LX("onMessageFailed").d("reason", "typeNotFound").sensitive("message", jsonPayload));
-            return;
-        }
+void GUIClient::executeOnMessage(const std::shared_ptr<InboundMessage>& message) {
+    ACSDK_DEBUG9(LX("onMessageInExector").d("payload", message->buffer));
 
-        if (MESSAGE_TYPE_INIT_RESPONSE == messageType) {
-            executeProcessInitResponse(message);
+    // Parsing in place overwrites the buffer, so the listener gets a copy of the text
+    std::string listenerPayload;
+    if (m_messageListener) {
+        listenerPayload = message->buffer;
+    }
+
+    auto& document = message->document;
+    rapidjson::ParseResult result = document.ParseInsitu(&message->buffer[0]);
+    if (!result) {
+        ACSDK_ERROR(LX("onMessageFailed")
+                        .d("reason", "parsingPayloadFailed")
+                        .d("error", rapidjson::GetParseError_En(result.Code()))
+                        .d("offset", result.Offset()));
+        return;
+    }
+
+    if (m_messageListener) {
+        m_messageListener->onMessage(std::move(listenerPayload));
+    }
+
+    std::string messageType;
+    if (!jsonUtils::retrieveValue(document, TYPE_TAG, &messageType)) {
+        ACSDK_ERROR(LX("onMessageFailed").d("reason", "typeNotFound"));
+        return;
+    }
+
+    if (MESSAGE_TYPE_INIT_RESPONSE == messageType) {
+        executeProcessInitResponse(document);
+    } else if (MESSAGE_TYPE_APL_EVENT == messageType) {
+        executeHandleAplEvent(message);
+    } else {
+        auto messageHandler = m_messageHandlers.find(messageType);
+        if (messageHandler != m_messageHandlers.end()) {
+            messageHandler->second(document);
         } else {
-            auto messageHandler = m_messageHandlers.find(messageType);
-            if (messageHandler != m_messageHandlers.end()) {
-                messageHandler->second(message);
-            } else {
-                ACSDK_WARN(LX("onMessageFailed").d("reason", "unknownType").d("type", messageType));
-            }
+            ACSDK_WARN(LX("onMessageFailed").d("reason", "unknownType").d("type", messageType));
         }
-    });
+    }
 }
 
 void GUIClient::executeCommands(const std::string& command, const std::string& token) {
@@ -826,9 +846,11 @@ void GUIClient::executeHandleRenderStaticDocument(rapidjson::Document& message)
         return;
     }
 
-    std::string document = extractDocument(payload);
-    std::string datasources = extractDatasources(payload);
-    std::string supportedViewports = extractSupportedViewports(payload);
+    rapidjson::Document parsedPayload;
+    parsedPayload.Parse(payload);
+    std::string document = extractDocument(parsedPayload);
+    std::string datasources = extractDatasources(parsedPayload);
+    std::string supportedViewports = extractSupportedViewports(parsedPayload);
 
     m_aplClientBridge->renderDocument(token, document, datasources, supportedViewports, windowId);
 }
@@ -897,25 +919,27 @@ void GUIClient::executeHandleNavigationEvent(rapidjson::Document& message) {
     m_guiManager->handleNavigationEvent(navigationEvent);
 }
 
-void GUIClient::executeHandleAplEvent(rapidjson::Document& message) {
+void GUIClient::executeHandleAplEvent(const std::shared_ptr<InboundMessage>& message) {
     if (!m_aplClientBridge) {
         ACSDK_ERROR(LX("handleAplEventFailed").d("reason", "APL Renderer has not been configured"));
         return;
     }
 
-    std::string payload;
-    if (!jsonUtils::retrieveValue(message, PAYLOAD_TAG, &payload)) {
+    auto& document = message->document;
+    auto payload = document.FindMember(PAYLOAD_TAG.c_str());
+    if (payload == document.MemberEnd()) {
         ACSDK_ERROR(LX("handleAplEventFailed").d("reason", "payloadNotFound"));
         return;
     }
 
     std::string windowId;
-    if (!jsonUtils::retrieveValue(message, WINDOW_ID_TAG, &windowId)) {
+    if (!jsonUtils::retrieveValue(document, WINDOW_ID_TAG, &windowId)) {
         ACSDK_ERROR(LX("handleAplEventFailed").d("reason", "windowIdNotFound"));
         return;
     }
 
-    m_aplClientBridge->onMessage(windowId, payload);
+    // The event keeps the message, and with it the buffer its strings point into, alive
+    m_aplClientBridge->onMessage(windowId, std::shared_ptr<const rapidjson::Value>(message, &payload->value));
 }
 
 void GUIClient::executeHandleDeviceWindowState(rapidjson::Document& message) {
@@ -1032,9 +1056,12 @@ void GUIClient::renderDocument(const std::string& jsonPayload, const std::string
     m_executor.submit([this, jsonPayload, windowId, token]() {
         bool isWindowIdPresent = m_reportedWindowIds.find(windowId) != m_reportedWindowIds.end();
 
-        std::string document = extractDocument(jsonPayload);
-        std::string datasources = extractDatasources(jsonPayload);
-        std::string supportedViewports = extractSupportedViewports(jsonPayload);
+        // Parse the payload once for all sections, it can be hundreds of kilobytes with inline datasources
+        rapidjson::Document payload;
+        payload.Parse(jsonPayload);
+        std::string document = extractDocument(payload);
+        std::string datasources = extractDatasources(payload);
+        std::string supportedViewports = extractSupportedViewports(payload);
         std::string targetWindowId = isWindowIdPresent ? windowId : m_defaultWindowId;
 
         m_aplClientBridge->renderDocument(token, document, datasources, supportedViewports, targetWindowId);
@@ -1320,10 +1347,7 @@ void GUIClient::executeWriteMessage(const std::string& payload) {
     m_serverImplementation->writeMessage(payload);
 }
 
-std::string GUIClient::extractDocument(const std::string& jsonPayload) {
-    rapidjson::Document document;
-    document.Parse(jsonPayload);
-
+std::string GUIClient::extractDocument(const rapidjson::Value& document) {
     std::string aplDocument;
     if (!jsonUtils::retrieveValue(document, DOCUMENT_FIELD, &aplDocument)) {
         aplDocument = DEFAULT_PARAM_VALUE;
@@ -1332,10 +1356,7 @@ std::string GUIClient::extractDocument(const std::string& jsonPayload) {
     return aplDocument;
 }
 
-std::string GUIClient::extractDatasources(const std::string& jsonPayload) {
-    rapidjson::Document document;
-    document.Parse(jsonPayload);
-
+std::string GUIClient::extractDatasources(const rapidjson::Value& document) {
     std::string aplData;
     if (!jsonUtils::retrieveValue(document, DATASOURCES_FIELD, &aplData)) {
         aplData = DEFAULT_PARAM_VALUE;
@@ -1344,10 +1365,7 @@ std::string GUIClient::extractDatasources(const std::string& jsonPayload) {
     return aplData;
 }
 
-std::string GUIClient::extractSupportedViewports(const std::string& jsonPayload) {
-    rapidjson::Document document;
-    document.Parse(jsonPayload);
-
+std::string GUIClient::extractSupportedViewports(const rapidjson::Value& document) {
     std::string supportedViewports;
     rapidjson::Value::ConstMemberIterator jsonIt;
     if (!jsonUtils::findNode(document, SUPPORTED_VIEWPORTS_FIELD, &jsonIt)) {
@@ -0,0 +1,534 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <AVSCommon/Utils/Logger/Logger.h>
+
+#include "SampleApp/PackageCacheStore.h"
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+
+static const std::string TAG{"PackageCacheStore"};
+#define LX(event) alexaClientSDK::avsCommon::utils::logger::LogEntry(TAG, event)
+
+using namespace alexaClientSDK::avsCommon::sdkInterfaces::storage;
+
+/// Component name for SmartScreenSampleApp
+static const std::string COMPONENT_NAME = "SmartScreenSampleApp";
+/// Table name for the index of cached APL packages
+static const std::string INDEX_TABLE_NAME = "PackageIndex";
+/// Table name used by earlier releases to store whole APL packages in misc storage
+static const std::string LEGACY_TABLE_NAME = "Packages";
+/// Delimiter to separate the fields of an index row, since we only have one column for value in misc storage
+static const std::string DELIMITER = "||||";
+/// Number of fields in an index row
+static const size_t INDEX_FIELD_COUNT = 4;
+/// Suffix of files being written, which are renamed into place once complete
+static const std::string TEMP_FILE_SUFFIX = ".tmp";
+/// Subdirectory of the configured cache directory holding the package files
+static const std::string PACKAGE_DIRECTORY_NAME = "packages";
+/// File marking a directory as owned by the package cache
+static const std::string MARKER_FILE_NAME = ".aplPackageCache";
+/// Number of hex digits in a content hash
+static const size_t HASH_HEX_LENGTH = 16;
+/// Maximum number of distinct contents sharing a hash and size before a put fails
+static const unsigned int MAX_FILE_VARIANTS = 16;
+/// Size of the chunks used to compare a package file with new content
+static const size_t COMPARE_CHUNK_SIZE = 64 * 1024;
+/// Permissions for the cache directory
+static const mode_t DIRECTORY_MODE = 0700;
+/// FNV-1a 64 bit offset basis
+static const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+/// FNV-1a 64 bit prime
+static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+/**
+ * Hashes @c data with 64 bit FNV-1a.
+ *
+ * @param data The data to hash.
+ * @return The hash as a fixed width hex string.
+ */
+static std::string hashToHex(const std::string& data) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return stream.str();
+}
+
+/**
+ * Creates @c path and any missing parent directories.
+ *
+ * @param path The directory to create.
+ * @return @c true if the directory exists on return.
+ */
+static bool createDirectories(const std::string& path) {
+    if (path.empty()) {
+        return false;
+    }
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+        auto partial = path.substr(0, pos);
+        if (mkdir(partial.c_str(), DIRECTORY_MODE) != 0 && errno != EEXIST) {
+            ACSDK_ERROR(LX("createDirectoriesFailed").d("path", partial).d("error", strerror(errno)));
+            return false;
+        }
+        if (pos == std::string::npos) {
+            break;
+        }
+    }
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+/**
+ * Checks whether @c text starts at @c pos with one or more decimal digits and advances @c pos past them.
+ */
+static bool skipDigits(const std::string& text, size_t* pos) {
+    auto start = *pos;
+    while (*pos < text.size() && std::isdigit(static_cast<unsigned char>(text[*pos]))) {
+        ++*pos;
+    }
+    return *pos > start;
+}
+
+/**
+ * Checks whether @c name follows the naming scheme of package files, "<hash>-<size>[-<variant>]", optionally followed
+ * by the temporary suffix of an interrupted write. Only such files are ever deleted from the cache directory.
+ *
+ * @param name The file name.
+ * @return @c true if @c name may be a package file.
+ */
+static bool isPackageFileName(const std::string& name) {
+    if (name.size() <= HASH_HEX_LENGTH || name[HASH_HEX_LENGTH] != '-') {
+        return false;
+    }
+    for (size_t i = 0; i < HASH_HEX_LENGTH; ++i) {
+        if (!std::isxdigit(static_cast<unsigned char>(name[i])) || std::isupper(static_cast<unsigned char>(name[i]))) {
+            return false;
+        }
+    }
+    size_t pos = HASH_HEX_LENGTH + 1;
+    if (!skipDigits(name, &pos)) {
+        return false;
+    }
+    if (pos < name.size() && name[pos] == '-' && !skipDigits(name, &++pos)) {
+        return false;
+    }
+    if (name.compare(pos, TEMP_FILE_SUFFIX.size(), TEMP_FILE_SUFFIX) == 0) {
+        pos += TEMP_FILE_SUFFIX.size();
+        if (!skipDigits(name, &pos)) {
+            return false;
+        }
+    }
+    return pos == name.size();
+}
+
+/**
+ * Reads @c size bytes from @c fd.
+ *
+ * @param fd The file descriptor.
+ * @param data The buffer to fill.
+ * @param size The number of bytes to read.
+ * @return @c true if all bytes were read.
+ */
+static bool readFully(int fd, char* data, size_t size) {
+    while (size > 0) {
+        auto count = ::read(fd, data, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+/**
+ * Checks whether a file holds exactly @c content.
+ *
+ * @param path The file.
+ * @param content The expected content.
+ * @return @c true if the file content equals @c content.
+ */
+static bool fileContentEquals(const std::string& path, const std::string& content) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    bool equal = fstat(fd, &info) == 0 && static_cast<uint64_t>(info.st_size) == content.size();
+    std::vector<char> buffer(std::min(COMPARE_CHUNK_SIZE, content.size()));
+    for (size_t offset = 0; equal && offset < content.size(); offset += buffer.size()) {
+        auto length = std::min(buffer.size(), content.size() - offset);
+        equal = readFully(fd, buffer.data(), length) && content.compare(offset, length, buffer.data(), length) == 0;
+    }
+    close(fd);
+    return equal;
+}
+
+/**
+ * Returns the size of a regular file.
+ *
+ * @param path The file.
+ * @param[out] size The size of the file.
+ * @return @c true if @c path is a regular file.
+ */
+static bool fileSize(const std::string& path, uint64_t* size) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    *size = static_cast<uint64_t>(info.st_size);
+    return true;
+}
+
+/**
+ * Serializes an index row.
+ */
+static std::string entryToString(const PackageCacheStore::Entry& entry) {
+    auto time = std::chrono::duration_cast<std::chrono::seconds>(entry.importTime.time_since_epoch()).count();
+    return std::to_string(time) + DELIMITER + std::to_string(entry.size) + DELIMITER + entry.fileName + DELIMITER +
+           entry.source;
+}
+
+/**
+ * Parses an index row. The source is the last field so that it may contain any character.
+ */
+static bool entryFromString(const std::string& value, PackageCacheStore::Entry* entry) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (fields.size() < INDEX_FIELD_COUNT - 1) {
+        auto delimiterPos = value.find(DELIMITER, start);
+        if (delimiterPos == std::string::npos) {
+            return false;
+        }
+        fields.push_back(value.substr(start, delimiterPos - start));
+        start = delimiterPos + DELIMITER.length();
+    }
+    fields.push_back(value.substr(start));
+
+    char* end = nullptr;
+    auto seconds = std::strtoll(fields[0].c_str(), &end, 10);
+    if (fields[0].empty() || *end != '\0') {
+        return false;
+    }
+    auto size = std::strtoull(fields[1].c_str(), &end, 10);
+    if (fields[1].empty() || *end != '\0' || fields[2].empty() || fields[3].empty()) {
+        return false;
+    }
+
+    entry->importTime = std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+    entry->size = size;
+    entry->fileName = fields[2];
+    entry->source = fields[3];
+    return true;
+}
+
+std::shared_ptr<PackageCacheStore> PackageCacheStore::create(
+    const std::string& directory,
+    std::shared_ptr<MiscStorageInterface> miscStorage) {
+    if (!miscStorage) {
+        ACSDK_ERROR(LX("createFailed").d("reason", "nullMiscStorage"));
+        return nullptr;
+    }
+    auto packageDirectory = directory + "/" + PACKAGE_DIRECTORY_NAME;
+    if (!createDirectories(packageDirectory)) {
+        ACSDK_ERROR(LX("createFailed").d("reason", "cannotCreateDirectory").d("directory", packageDirectory));
+        return nullptr;
+    }
+    auto markerPath = packageDirectory + "/" + MARKER_FILE_NAME;
+    uint64_t markerSize = 0;
+    if (!fileSize(markerPath, &markerSize)) {
+        std::ofstream marker(markerPath, std::ios::trunc);
+        marker << "Downloaded APL packages. Files in this directory may be deleted at any time.\n";
+        if (!marker) {
+            ACSDK_ERROR(LX("createFailed").d("reason", "cannotWriteMarker").d("directory", packageDirectory));
+            return nullptr;
+        }
+    }
+
+    bool doesTableExist = false;
+    if (!miscStorage->tableExists(COMPONENT_NAME, INDEX_TABLE_NAME, &doesTableExist)) {
+        ACSDK_ERROR(LX("createFailed").d("reason", "cannotCheckTableExistence"));
+        return nullptr;
+    }
+    if (!doesTableExist && !miscStorage->createTable(
+                               COMPONENT_NAME,
+                               INDEX_TABLE_NAME,
+                               MiscStorageInterface::KeyType::STRING_KEY,
+                               MiscStorageInterface::ValueType::STRING_VALUE)) {
+        ACSDK_ERROR(LX("createFailed").d("reason", "cannotCreateIndexTable"));
+        return nullptr;
+    }
+
+    // Packages cached by earlier releases held their whole content in misc storage. Drop them rather than migrating,
+    // they will be downloaded again on demand.
+    bool doesLegacyTableExist = false;
+    if (miscStorage->tableExists(COMPONENT_NAME, LEGACY_TABLE_NAME, &doesLegacyTableExist) && doesLegacyTableExist) {
+        if (!miscStorage->clearTable(COMPONENT_NAME, LEGACY_TABLE_NAME) ||
+            !miscStorage->deleteTable(COMPONENT_NAME, LEGACY_TABLE_NAME)) {
+            ACSDK_WARN(LX(__func__).m("Cannot remove legacy package table."));
+        }
+    }
+
+    return std::shared_ptr<PackageCacheStore>(new PackageCacheStore(packageDirectory, miscStorage));
+}
+
+PackageCacheStore::PackageCacheStore(const std::string& directory, std::shared_ptr<MiscStorageInterface> miscStorage) :
+        m_directory{directory},
+        m_miscStorage{miscStorage},
+        m_tempFileCounter{0},
+        m_generation{0} {
+}
+
+std::string PackageCacheStore::contentFileName(const std::string& content) {
+    return hashToHex(content) + "-" + std::to_string(content.size());
+}
+
+std::string PackageCacheStore::pathOf(const std::string& fileName) const {
+    return m_directory + "/" + fileName;
+}
+
+bool PackageCacheStore::ownsDirectory() const {
+    uint64_t markerSize = 0;
+    if (!fileSize(pathOf(MARKER_FILE_NAME), &markerSize)) {
+        ACSDK_WARN(LX(__func__).d("directory", m_directory).m("Marker file missing, not removing any files."));
+        return false;
+    }
+    return true;
+}
+
+bool PackageCacheStore::loadIndex(std::vector<Entry>* entries) {
+    std::unordered_map<std::string, std::string> rows;
+    if (!m_miscStorage->load(COMPONENT_NAME, INDEX_TABLE_NAME, &rows)) {
+        ACSDK_ERROR(LX("loadIndexFailed").d("reason", "cannotLoadIndexTable"));
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_sourceFiles.clear();
+    m_fileReferences.clear();
+    for (const auto& row : rows) {
+        Entry entry;
+        uint64_t size = 0;
+        if (!entryFromString(row.second, &entry) || row.first != hashToHex(entry.source) ||
+            !fileSize(pathOf(entry.fileName), &size) || size != entry.size) {
+            ACSDK_WARN(LX(__func__).d("key", row.first).m("Dropping stale package index entry."));
+            m_miscStorage->remove(COMPONENT_NAME, INDEX_TABLE_NAME, row.first);
+            continue;
+        }
+        entry.generation = ++m_generation;
+        m_sourceFiles[entry.source] = StoredSource{entry.fileName, entry.generation};
+        m_fileReferences[entry.fileName]++;
+        entries->push_back(std::move(entry));
+    }
+
+    // Remove files left behind by interrupted writes or by index rows that could not be updated.
+    DIR* dir = ownsDirectory() ? opendir(m_directory.c_str()) : nullptr;
+    if (dir) {
+        while (auto dirEntry = readdir(dir)) {
+            std::string name = dirEntry->d_name;
+            if (!isPackageFileName(name) || m_fileReferences.count(name)) {
+                continue;
+            }
+            if (unlink(pathOf(name).c_str()) != 0) {
+                ACSDK_WARN(LX(__func__).d("file", name).d("error", strerror(errno)).m("Cannot remove orphaned file."));
+            }
+        }
+        closedir(dir);
+    }
+
+    ACSDK_DEBUG5(LX(__func__).d("entries", entries->size()).d("files", m_fileReferences.size()));
+    return true;
+}
+
+bool PackageCacheStore::put(const std::string& source, const std::string& content, Entry* entry) {
+    auto baseName = contentFileName(content);
+    std::string fileName;
+    std::string path;
+
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    // A file with the same hash and size is only shared once its bytes are known to match. Different content with the
+    // same name goes to the next free variant, unless the existing file is unreferenced and can be replaced.
+    bool reuseFile = false;
+    for (unsigned int variant = 0; !reuseFile; ++variant) {
+        if (variant == MAX_FILE_VARIANTS) {
+            ACSDK_ERROR(LX("putFailed").d("reason", "tooManyFileVariants").d("file", baseName));
+            return false;
+        }
+        fileName = variant ? baseName + "-" + std::to_string(variant) : baseName;
+        path = pathOf(fileName);
+        uint64_t existingSize = 0;
+        if (!fileSize(path, &existingSize) || !m_fileReferences.count(fileName)) {
+            break;
+        }
+        reuseFile = existingSize == content.size() && fileContentEquals(path, content);
+    }
+    if (!reuseFile) {
+        auto tempPath = path + TEMP_FILE_SUFFIX + std::to_string(m_tempFileCounter++);
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(content.data(), content.size());
+            if (!file) {
+                ACSDK_ERROR(LX("putFailed").d("reason", "cannotWriteFile").d("file", tempPath));
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            ACSDK_ERROR(LX("putFailed").d("reason", "cannotRenameFile").d("error", strerror(errno)));
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    entry->source = source;
+    entry->fileName = fileName;
+    entry->size = content.size();
+    entry->importTime = std::chrono::system_clock::now();
+    entry->generation = ++m_generation;
+
+    auto previous = m_sourceFiles.find(source);
+    if (previous == m_sourceFiles.end() || previous->second.fileName != fileName) {
+        if (previous != m_sourceFiles.end()) {
+            releaseFileLocked(previous->second.fileName);
+        }
+        m_fileReferences[fileName]++;
+    }
+    m_sourceFiles[source] = StoredSource{fileName, entry->generation};
+
+    if (!writeIndex(*entry)) {
+        ACSDK_ERROR(LX("putFailed").d("reason", "cannotWriteIndex"));
+        m_sourceFiles.erase(source);
+        releaseFileLocked(fileName);
+        return false;
+    }
+    return true;
+}
+
+bool PackageCacheStore::read(const Entry& entry, std::string* content) const {
+    auto path = pathOf(entry.fileName);
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ACSDK_WARN(LX("readFailed").d("reason", "cannotOpenFile").d("file", entry.fileName));
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) != entry.size || entry.size == 0) {
+        ACSDK_WARN(LX("readFailed").d("reason", "sizeMismatch").d("file", entry.fileName));
+        close(fd);
+        return false;
+    }
+
+    // The content is read straight into the caller's string, which is the only copy made.
+    content->resize(entry.size);
+    bool success = readFully(fd, &(*content)[0], entry.size);
+    close(fd);
+    if (!success) {
+        ACSDK_WARN(LX("readFailed").d("reason", "cannotReadFile").d("error", strerror(errno)));
+        content->clear();
+    }
+    return success;
+}
+
+bool PackageCacheStore::touch(Entry* entry) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_sourceFiles.find(entry->source);
+    if (it == m_sourceFiles.end() || it->second.generation != entry->generation) {
+        ACSDK_DEBUG5(LX(__func__).d("reason", "entrySuperseded"));
+        return false;
+    }
+    entry->importTime = std::chrono::system_clock::now();
+    entry->generation = ++m_generation;
+    it->second.generation = entry->generation;
+    return writeIndex(*entry);
+}
+
+void PackageCacheStore::remove(const Entry& entry) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    // Removals may be carried out after the source was stored again, which must not be undone.
+    auto it = m_sourceFiles.find(entry.source);
+    if (it == m_sourceFiles.end() || it->second.generation != entry.generation) {
+        return;
+    }
+    if (!m_miscStorage->remove(COMPONENT_NAME, INDEX_TABLE_NAME, hashToHex(entry.source))) {
+        ACSDK_ERROR(LX("removeFailed").d("reason", "cannotRemoveIndexRow"));
+    }
+    m_sourceFiles.erase(it);
+    releaseFileLocked(entry.fileName);
+}
+
+bool PackageCacheStore::clear() {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    bool success = m_miscStorage->clearTable(COMPONENT_NAME, INDEX_TABLE_NAME);
+    if (!success) {
+        ACSDK_ERROR(LX("clearFailed").d("reason", "cannotClearIndexTable"));
+    }
+    DIR* dir = ownsDirectory() ? opendir(m_directory.c_str()) : nullptr;
+    if (dir) {
+        while (auto dirEntry = readdir(dir)) {
+            std::string name = dirEntry->d_name;
+            if (isPackageFileName(name) && unlink(pathOf(name).c_str()) != 0) {
+                ACSDK_ERROR(LX("clearFailed").d("file", name).d("error", strerror(errno)));
+                success = false;
+            }
+        }
+        closedir(dir);
+    }
+    m_sourceFiles.clear();
+    m_fileReferences.clear();
+    return success;
+}
+
+bool PackageCacheStore::writeIndex(const Entry& entry) {
+    return m_miscStorage->put(COMPONENT_NAME, INDEX_TABLE_NAME, hashToHex(entry.source), entryToString(entry));
+}
+
+void PackageCacheStore::releaseFileLocked(const std::string& fileName) {
+    auto it = m_fileReferences.find(fileName);
+    if (it == m_fileReferences.end()) {
+        return;
+    }
+    if (--it->second == 0) {
+        m_fileReferences.erase(it);
+        if (unlink(pathOf(fileName).c_str()) != 0) {
+            ACSDK_WARN(LX(__func__).d("file", fileName).d("error", strerror(errno)).m("Cannot remove package file."));
+        }
+    }
+}
+
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
@@ -184,6 +184,25 @@ static const std::string DEFAULT_WEBSOCKET_INTERFACE = "127.0.0.1";
 /// WebSocket port to listen on.
 static const int DEFAULT_WEBSOCKET_PORT = 8933;
 
+/// The number of threads serving WebSocket connections.
+static const int DEFAULT_WEBSOCKET_THREAD_POOL_SIZE = 2;
+
+/// Whether WebSocket messages are compressed when the client supports it.
+static const bool DEFAULT_WEBSOCKET_COMPRESSION = true;
+
+/// The zlib compression level of WebSocket messages, -1 being the zlib default.
+static const int DEFAULT_WEBSOCKET_COMPRESSION_LEVEL = -1;
+
+/// The size in bytes of the smallest WebSocket message to compress.
+static const int DEFAULT_WEBSOCKET_COMPRESSION_THRESHOLD = 1024;
+
+/// Whether WebSocket messages are sent in binary frames.
+static const bool DEFAULT_WEBSOCKET_BINARY_FRAMES = false;
+
+/// The types of the messages to the GUI client expecting a single reply, which only one WebSocket client must answer.
+static const std::set<std::string> WEBSOCKET_REQUEST_TYPES =
+    {"initRequest", "measure", "measureBatch", "baseline", "localeMethod", "reHierarchy"};
+
 /// The sample rate of microphone audio data.
 static const unsigned int SAMPLE_RATE_HZ = 16000;
 
@@ -236,6 +255,22 @@ static const std::string WEBSOCKET_PRIVATE_KEY("websocketPrivateKey");
 /// configuration node.
 static const std::string WEBSOCKET_CERTIFICATE_AUTHORITY("websocketCertificateAuthority");
 
+/// Key for setting the number of threads serving websocket connections, @c SAMPLE_APP_CONFIG_KEY configuration node.
+static const std::string WEBSOCKET_THREAD_POOL_SIZE_KEY("websocketThreadPoolSize");
+
+/// Key for enabling the compression of websocket messages, @c SAMPLE_APP_CONFIG_KEY configuration node.
+static const std::string WEBSOCKET_COMPRESSION_KEY("websocketCompression");
+
+/// Key for setting the compression level of websocket messages, @c SAMPLE_APP_CONFIG_KEY configuration node.
+static const std::string WEBSOCKET_COMPRESSION_LEVEL_KEY("websocketCompressionLevel");
+
+/// Key for setting the size in bytes of the smallest websocket message to compress, @c SAMPLE_APP_CONFIG_KEY
+/// configuration node.
+static const std::string WEBSOCKET_COMPRESSION_THRESHOLD_KEY("websocketCompressionThreshold");
+
+/// Key for sending websocket messages in binary frames, @c SAMPLE_APP_CONFIG_KEY configuration node.
+static const std::string WEBSOCKET_BINARY_FRAMES_KEY("websocketBinaryFrames");
+
 /// Key for the Audio MediaPlayer pool size.
 static const std::string AUDIO_MEDIAPLAYER_POOL_SIZE_KEY("audioMediaPlayerPoolSize");
 
@@ -251,12 +286,54 @@ static const std::string CONTENT_CACHE_MAX_SIZE_KEY("contentCacheMaxSize");
 /// Default value for max number of cache entries for imported packages.
 static const std::string DEFAULT_CONTENT_CACHE_MAX_SIZE("50");
 
+/// Key for max total size in bytes of cached imported packages.
+static const std::string CONTENT_CACHE_MAX_SIZE_IN_BYTES_KEY("contentCacheMaxSizeInBytes");
+
+/// Default value for max total size in bytes of cached imported packages, 0 for no limit.
+static const std::string DEFAULT_CONTENT_CACHE_MAX_SIZE_IN_BYTES("0");
+
+/// Key for the directory holding cached imported packages.
+static const std::string CONTENT_CACHE_DIRECTORY_KEY("contentCacheDirectory");
+
+/// Key for the misc database configuration node, used to locate the default package cache directory.
+static const std::string MISC_DATABASE_CONFIG_KEY("miscDatabase");
+
+/// Key for the misc database file path.
+static const std::string MISC_DATABASE_FILE_PATH_KEY("databaseFilePath");
+
+/// Name of the default package cache directory, created next to the misc database.
+static const std::string DEFAULT_CONTENT_CACHE_DIRECTORY_NAME("aplPackageCache");
+
 /// The key in our config file to find the maxNumberOfConcurrentDownloads configuration.
 static const std::string MAX_NUMBER_OF_CONCURRENT_DOWNLOAD_CONFIGURATION_KEY = "maxNumberOfConcurrentDownloads";
 
 // The default value for the maximum number of concurrent downloads.
 static const int DEFAULT_MAX_NUMBER_OF_CONCURRENT_DOWNLOAD = 5;
 
+/// The key in our config file to find the maximum number of APL update ticks per second.
+static const std::string APL_MAX_FRAME_RATE_CONFIGURATION_KEY = "aplMaxFrameRate";
+
+// The default value for the maximum number of APL update ticks per second.
+static const int DEFAULT_APL_MAX_FRAME_RATE = 60;
+
+/// The key in our config file to find the granularity of the audio playback progress published to APL documents.
+static const std::string APL_AUDIO_PROGRESS_GRANULARITY_CONFIGURATION_KEY = "aplAudioProgressGranularityMs";
+
+// The default granularity in milliseconds of the audio playback progress published to APL documents.
+static const int DEFAULT_APL_AUDIO_PROGRESS_GRANULARITY_MS = 250;
+
+/// The key in our config file to find the maximum number of backstack documents kept live.
+static const std::string APL_BACKSTACK_MAX_LIVE_DOCUMENTS_CONFIGURATION_KEY = "aplBackstackMaxLiveDocuments";
+
+// The default maximum number of backstack documents kept live.
+static const int DEFAULT_APL_BACKSTACK_MAX_LIVE_DOCUMENTS = 3;
+
+/// The key in our config file to find the maximum estimated size of the backstack documents kept live.
+static const std::string APL_BACKSTACK_MAX_LIVE_SIZE_CONFIGURATION_KEY = "aplBackstackMaxLiveSizeInBytes";
+
+// The default maximum estimated size in bytes of the backstack documents kept live, 0 for no limit.
+static const int DEFAULT_APL_BACKSTACK_MAX_LIVE_SIZE = 0;
+
 using namespace alexaClientSDK;
 using namespace alexaClientSDK::acsdkExternalMediaPlayer;
 using namespace alexaClientSDK::acsdkManufactory;
@@ -1151,6 +1228,32 @@ bool SampleApplication::initialize(
     webSocketServer->setCertificateFile(sslCaFile, sslCertificateFile, sslPrivateKeyFile);
 #endif  // ENABLE_WEBSOCKET_SSL
 
+    int websocketThreadPoolSize;
+    sampleAppConfig.getInt(
+        WEBSOCKET_THREAD_POOL_SIZE_KEY, &websocketThreadPoolSize, DEFAULT_WEBSOCKET_THREAD_POOL_SIZE);
+    webSocketServer->setThreadPoolSize(static_cast<size_t>(std::max(1, websocketThreadPoolSize)));
+
+    bool websocketCompression;
+    sampleAppConfig.getBool(WEBSOCKET_COMPRESSION_KEY, &websocketCompression, DEFAULT_WEBSOCKET_COMPRESSION);
+
+    int websocketCompressionLevel;
+    sampleAppConfig.getInt(
+        WEBSOCKET_COMPRESSION_LEVEL_KEY, &websocketCompressionLevel, DEFAULT_WEBSOCKET_COMPRESSION_LEVEL);
+
+    int websocketCompressionThreshold;
+    sampleAppConfig.getInt(
+        WEBSOCKET_COMPRESSION_THRESHOLD_KEY, &websocketCompressionThreshold, DEFAULT_WEBSOCKET_COMPRESSION_THRESHOLD);
+
+    webSocketServer->setCompression(
+        websocketCompression,
+        websocketCompressionLevel,
+        static_cast<size_t>(std::max(0, websocketCompressionThreshold)));
+
+    bool websocketBinaryFrames;
+    sampleAppConfig.getBool(WEBSOCKET_BINARY_FRAMES_KEY, &websocketBinaryFrames, DEFAULT_WEBSOCKET_BINARY_FRAMES);
+    webSocketServer->setBinaryFrames(websocketBinaryFrames);
+    webSocketServer->setRequestTypes(WEBSOCKET_REQUEST_TYPES);
+
 #endif  // UWP_BUILD
 
     /*
@@ -1172,19 +1275,35 @@ bool SampleApplication::initialize(
 
     std::string cachePeriodInSeconds;
     std::string maxCacheSize;
+    std::string maxCacheSizeInBytes;
 
     sampleAppConfig.getString(
         CONTENT_CACHE_REUSE_PERIOD_IN_SECONDS_KEY,
         &cachePeriodInSeconds,
         DEFAULT_CONTENT_CACHE_REUSE_PERIOD_IN_SECONDS);
     sampleAppConfig.getString(CONTENT_CACHE_MAX_SIZE_KEY, &maxCacheSize, DEFAULT_CONTENT_CACHE_MAX_SIZE);
+    sampleAppConfig.getString(
+        CONTENT_CACHE_MAX_SIZE_IN_BYTES_KEY, &maxCacheSizeInBytes, DEFAULT_CONTENT_CACHE_MAX_SIZE_IN_BYTES);
+
+    std::string contentCacheDirectory;
+    if (!sampleAppConfig.getString(CONTENT_CACHE_DIRECTORY_KEY, &contentCacheDirectory) ||
+        contentCacheDirectory.empty()) {
+        std::string miscDatabaseFilePath;
+        config[MISC_DATABASE_CONFIG_KEY].getString(MISC_DATABASE_FILE_PATH_KEY, &miscDatabaseFilePath);
+        auto separatorPos = miscDatabaseFilePath.rfind('/');
+        auto databaseDirectory =
+            separatorPos == std::string::npos ? std::string(".") : miscDatabaseFilePath.substr(0, separatorPos);
+        contentCacheDirectory = databaseDirectory + "/" + DEFAULT_CONTENT_CACHE_DIRECTORY_NAME;
+    }
 
     auto contentDownloadManager = std::make_shared<CachingDownloadManager>(
         httpContentFetcherFactory,
         std::stol(cachePeriodInSeconds),
         std::stol(maxCacheSize),
+        std::stoull(maxCacheSizeInBytes),
         miscStorage,
-        customerDataManager);
+        customerDataManager,
+        contentCacheDirectory);
 
     int maxNumberOfConcurrentDownloads;
     sampleAppConfig.getInt(
@@ -1197,7 +1316,50 @@ bool SampleApplication::initialize(
         ACSDK_ERROR(LX("Invalid values for maxNumberOfConcurrentDownloads"));
     }
 
-    auto parameters = AplClientBridgeParameter{maxNumberOfConcurrentDownloads};
+    int aplMaxFrameRate;
+    sampleAppConfig.getInt(APL_MAX_FRAME_RATE_CONFIGURATION_KEY, &aplMaxFrameRate, DEFAULT_APL_MAX_FRAME_RATE);
+
+    if (1 > aplMaxFrameRate) {
+        aplMaxFrameRate = DEFAULT_APL_MAX_FRAME_RATE;
+        ACSDK_ERROR(LX("Invalid values for aplMaxFrameRate"));
+    }
+
+    int aplAudioProgressGranularity;
+    sampleAppConfig.getInt(
+        APL_AUDIO_PROGRESS_GRANULARITY_CONFIGURATION_KEY,
+        &aplAudioProgressGranularity,
+        DEFAULT_APL_AUDIO_PROGRESS_GRANULARITY_MS);
+
+    if (0 > aplAudioProgressGranularity) {
+        aplAudioProgressGranularity = DEFAULT_APL_AUDIO_PROGRESS_GRANULARITY_MS;
+        ACSDK_ERROR(LX("Invalid values for aplAudioProgressGranularityMs"));
+    }
+
+    int aplBackstackMaxLiveDocuments;
+    sampleAppConfig.getInt(
+        APL_BACKSTACK_MAX_LIVE_DOCUMENTS_CONFIGURATION_KEY,
+        &aplBackstackMaxLiveDocuments,
+        DEFAULT_APL_BACKSTACK_MAX_LIVE_DOCUMENTS);
+
+    if (0 > aplBackstackMaxLiveDocuments) {
+        aplBackstackMaxLiveDocuments = DEFAULT_APL_BACKSTACK_MAX_LIVE_DOCUMENTS;
+        ACSDK_ERROR(LX("Invalid values for aplBackstackMaxLiveDocuments"));
+    }
+
+    int aplBackstackMaxLiveSize;
+    sampleAppConfig.getInt(
+        APL_BACKSTACK_MAX_LIVE_SIZE_CONFIGURATION_KEY, &aplBackstackMaxLiveSize, DEFAULT_APL_BACKSTACK_MAX_LIVE_SIZE);
+
+    if (0 > aplBackstackMaxLiveSize) {
+        aplBackstackMaxLiveSize = DEFAULT_APL_BACKSTACK_MAX_LIVE_SIZE;
+        ACSDK_ERROR(LX("Invalid values for aplBackstackMaxLiveSizeInBytes"));
+    }
+
+    auto parameters = AplClientBridgeParameter{maxNumberOfConcurrentDownloads,
+                                               aplMaxFrameRate,
+                                               aplAudioProgressGranularity,
+                                               aplBackstackMaxLiveDocuments,
+                                               aplBackstackMaxLiveSize};
     m_aplClientBridge = AplClientBridge::create(contentDownloadManager, m_guiClient, parameters);
 
     m_guiClient->setAplClientBridge(m_aplClientBridge);
@@ -0,0 +1,143 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <SampleApp/AplClientBridge.h>
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+namespace test {
+
+using namespace ::testing;
+
+/// How long to wait for the bridge to execute an update tick.
+static const std::chrono::milliseconds UPDATE_TICK_TIMEOUT{2000};
+
+/// How often to check whether the bridge executed an update tick.
+static const std::chrono::milliseconds UPDATE_TICK_POLL_INTERVAL{5};
+
+/// The frame rate cap of the bridge under test for the frame rate cap.
+static const int CAPPED_FRAME_RATE = 10;
+
+/// How long update ticks are requested for when testing the frame rate cap.
+static const std::chrono::milliseconds CAPPED_TICKS_DURATION{1000};
+
+/// Test harness for @c AplClientBridge update tick scheduling.
+class AplClientBridgeTest : public ::testing::Test {
+public:
+    /// Set up the test harness for running a test.
+    void SetUp() override;
+
+    /// Clean up the test harness after running a test.
+    void TearDown() override;
+
+protected:
+    /**
+     * Waits for the bridge to have executed a number of update ticks.
+     *
+     * @param count The number of update ticks
+     * @return @c true if the ticks were executed before the timeout
+     */
+    bool waitForUpdateTicks(uint64_t count);
+
+    std::shared_ptr<AplClientBridge> m_aplClientBridge;
+};
+
+void AplClientBridgeTest::SetUp() {
+    AplClientBridgeParameter parameters = {1, 60, 0, 0, 0};
+    m_aplClientBridge = AplClientBridge::create(nullptr, nullptr, parameters);
+    m_aplClientBridge->onConnectionOpened();
+    // Opening the connection ticks once, then nothing is pending
+    ASSERT_TRUE(waitForUpdateTicks(1));
+}
+
+void AplClientBridgeTest::TearDown() {
+    m_aplClientBridge->shutdown();
+}
+
+bool AplClientBridgeTest::waitForUpdateTicks(uint64_t count) {
+    auto deadline = std::chrono::steady_clock::now() + UPDATE_TICK_TIMEOUT;
+    while (m_aplClientBridge->getUpdateTickCount() < count) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(UPDATE_TICK_POLL_INTERVAL);
+    }
+    return true;
+}
+
+/**
+ * Tests that an extension event is followed by an update tick, so that its effects are rendered.
+ */
+TEST_F(AplClientBridgeTest, ExtensionEventRequestsUpdateTick) {
+    m_aplClientBridge->onExtensionEvent("token", "aplext:test", "event", "{}", "{}", 1, nullptr);
+
+    ASSERT_TRUE(waitForUpdateTicks(2));
+}
+
+/**
+ * Tests that restoring a backstack document is followed by an update tick, so that it is rendered.
+ */
+TEST_F(AplClientBridgeTest, RestoreDocumentStateRequestsUpdateTick) {
+    m_aplClientBridge->onRestoreDocumentState(std::make_shared<APLClient::AplDocumentState>());
+
+    ASSERT_TRUE(waitForUpdateTicks(2));
+}
+
+/**
+ * Tests that update ticks requested with a zero delay as soon as the previous one ran, as for a document which is
+ * dirty on every tick, are clamped to the minimum frame interval.
+ */
+TEST_F(AplClientBridgeTest, ZeroDelayUpdateTicksClampedToFrameRate) {
+    AplClientBridgeParameter parameters = {1, CAPPED_FRAME_RATE, 0, 0, 0};
+    auto aplClientBridge = AplClientBridge::create(nullptr, nullptr, parameters);
+    aplClientBridge->onConnectionOpened();
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t lastTicks = 0;
+    while (std::chrono::steady_clock::now() - start < CAPPED_TICKS_DURATION) {
+        auto ticks = aplClientBridge->getUpdateTickCount();
+        if (ticks != lastTicks) {
+            lastTicks = ticks;
+            aplClientBridge->onExtensionEvent("token", "aplext:test", "event", "{}", "{}", 1, nullptr);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    aplClientBridge->shutdown();
+
+    // One tick when the connection opens, then at most one per minimum frame interval
+    auto maxTicks = 1 + CAPPED_FRAME_RATE * CAPPED_TICKS_DURATION.count() / 1000 + 1;
+    ASSERT_LE(aplClientBridge->getUpdateTickCount(), static_cast<uint64_t>(maxTicks));
+    ASSERT_GE(aplClientBridge->getUpdateTickCount(), static_cast<uint64_t>(maxTicks / 2));
+    ASSERT_GT(aplClientBridge->getSkippedUpdateTickCount(), 0u);
+}
+
+/**
+ * Tests that no update tick is executed while the GUI client is disconnected.
+ */
+TEST_F(AplClientBridgeTest, NoUpdateTickWhileDisconnected) {
+    m_aplClientBridge->onConnectionClosed();
+    m_aplClientBridge->onExtensionEvent("token", "aplext:test", "event", "{}", "{}", 1, nullptr);
+
+    ASSERT_FALSE(waitForUpdateTicks(2));
+}
+
+}  // namespace test
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
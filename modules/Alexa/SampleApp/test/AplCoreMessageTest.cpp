@@ -0,0 +1,119 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <SampleApp/Messages/GUIClientMessage.h>
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+namespace test {
+
+using namespace ::testing;
+
+/// The target window of the test messages.
+static const std::string WINDOW_ID = "tvFullscreen";
+
+/// A small APL Core message payload.
+static const std::string CORE_PAYLOAD =
+    R"({"type":"measure","seqno":12,"payload":{"id":":1000","text":"Hello \"World\"","widthMode":1}})";
+
+/// Number of frames used by the envelope benchmark.
+static const int BENCHMARK_FRAMES = 600;
+
+/// Number of dirty components in each frame of the envelope benchmark.
+static const int BENCHMARK_DIRTY_COMPONENTS = 50;
+
+/**
+ * Builds the envelope the way it was built before payloads were spliced, by parsing the core payload into the
+ * message document.
+ */
+static std::string buildParsedEnvelope(const std::string& payload) {
+    messages::GUIClientMessage message(messages::GUI_MSG_TYPE_APL_CORE);
+    message.setWindowId(WINDOW_ID);
+    message.setParsedPayload(payload);
+    return message.get();
+}
+
+/**
+ * Builds a core payload resembling a @c dirty update.
+ */
+static std::string buildDirtyPayload() {
+    std::ostringstream payload;
+    payload << R"({"type":"dirty","seqno":1,"payload":[)";
+    for (int i = 0; i < BENCHMARK_DIRTY_COMPONENTS; i++) {
+        if (i > 0) {
+            payload << ",";
+        }
+        payload << R"({"id":":10)" << i << R"(","_bounds":[0,)" << i * 10
+                << R"(,1280,10],"opacity":1,"text":"Item )" << i << R"(","color":"#fafafaff"})";
+    }
+    payload << "]}";
+    return payload.str();
+}
+
+TEST(AplCoreMessageTest, SplicesPayloadIntoEnvelope) {
+    messages::AplCoreMessage message(WINDOW_ID, CORE_PAYLOAD);
+
+    ASSERT_EQ(buildParsedEnvelope(CORE_PAYLOAD), message.get());
+}
+
+TEST(AplCoreMessageTest, GetValueContainsPayload) {
+    messages::AplCoreMessage message(WINDOW_ID, CORE_PAYLOAD);
+
+    rapidjson::Document document;
+    document.CopyFrom(message.getValue(), document.GetAllocator());
+
+    ASSERT_TRUE(document.HasMember(MSG_PAYLOAD_TAG));
+    ASSERT_STREQ("measure", document[MSG_PAYLOAD_TAG]["type"].GetString());
+    ASSERT_EQ(12, document[MSG_PAYLOAD_TAG]["seqno"].GetInt());
+}
+
+/**
+ * Microbenchmark comparing the per-frame cost of wrapping a dirty update by parsing it against splicing it.
+ */
+TEST(AplCoreMessageTest, DirtyFrameEnvelopeBenchmark) {
+    const auto payload = buildDirtyPayload();
+
+    size_t parsedBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+        parsedBytes += buildParsedEnvelope(payload).size();
+    }
+    auto parsedDuration = std::chrono::steady_clock::now() - start;
+
+    size_t splicedBytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+        splicedBytes += messages::AplCoreMessage(WINDOW_ID, payload).get().size();
+    }
+    auto splicedDuration = std::chrono::steady_clock::now() - start;
+
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    std::cout << "[ BENCHMARK ] per frame: parsed "
+              << duration_cast<nanoseconds>(parsedDuration).count() / BENCHMARK_FRAMES << "ns, spliced "
+              << duration_cast<nanoseconds>(splicedDuration).count() / BENCHMARK_FRAMES << "ns" << std::endl;
+
+    ASSERT_EQ(parsedBytes, splicedBytes);
+}
+
+}  // namespace test
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
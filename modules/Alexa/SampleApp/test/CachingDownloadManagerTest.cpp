@@ -0,0 +1,349 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <RegistrationManager/CustomerDataManager.h>
+#include <SampleApp/CachingDownloadManager.h>
+
+#include "InMemoryMiscStorage.h"
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+namespace test {
+
+using namespace ::testing;
+using namespace alexaClientSDK::avsCommon::avs::attachment;
+using namespace alexaClientSDK::avsCommon::sdkInterfaces;
+
+/// Size of the chunks in which the local source writes a body.
+static const size_t SOURCE_CHUNK_SIZE = 16 * 1024;
+
+/// Size of a small package.
+static const size_t SMALL_PACKAGE_SIZE = 4 * 1024;
+
+/// Size of a large package.
+static const size_t LARGE_PACKAGE_SIZE = 2 * 1024 * 1024;
+
+/// Number of downloads per package size in the benchmark.
+static const int BENCHMARK_DOWNLOADS = 20;
+
+/// Number of callers requesting the same package concurrently.
+static const int CONCURRENT_CALLERS = 8;
+
+/// Time given to the concurrent callers to reach the download manager before the source replies.
+static const std::chrono::milliseconds CONCURRENT_CALLERS_DELAY{100};
+
+/**
+ * A local stand-in for an HTTP source, serving a fixed body from a background thread the way the libcurl fetcher does:
+ * the body is written to the attachment as it "arrives" and the stream is closed once complete.
+ */
+class LocalContentFetcher : public HTTPContentFetcherInterface {
+public:
+    LocalContentFetcher(
+        const std::string& url,
+        const std::string& body,
+        bool sendContentLength,
+        std::shared_future<void> reply) :
+            m_url{url},
+            m_body{body},
+            m_sendContentLength{sendContentLength},
+            m_reply{reply},
+            m_state{State::INITIALIZED} {
+    }
+
+    ~LocalContentFetcher() override {
+        shutdown();
+    }
+
+    State getState() override {
+        return m_state;
+    }
+
+    std::string getUrl() const override {
+        return m_url;
+    }
+
+    Header getHeader(std::atomic<bool>* shouldShutdown) override {
+        if (m_reply.valid()) {
+            m_reply.wait();
+        }
+        Header header;
+        header.successful = true;
+        header.responseCode = 200;
+        header.contentType = "application/json";
+        header.contentLength = m_sendContentLength ? static_cast<ssize_t>(m_body.size()) : 0;
+        m_state = State::HEADER_DONE;
+        return header;
+    }
+
+    bool getBody(std::shared_ptr<AttachmentWriter> writer) override {
+        m_state = State::FETCHING_BODY;
+        m_thread = std::thread([this, writer] {
+            auto writeStatus = AttachmentWriter::WriteStatus::OK;
+            for (size_t offset = 0; offset < m_body.size(); offset += SOURCE_CHUNK_SIZE) {
+                auto size = std::min(SOURCE_CHUNK_SIZE, m_body.size() - offset);
+                writer->write(m_body.data() + offset, size, &writeStatus);
+            }
+            m_state = State::BODY_DONE;
+            writer->close();
+        });
+        return true;
+    }
+
+    void shutdown() override {
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    std::unique_ptr<HTTPContent> getContent(
+        FetchOptions option,
+        std::unique_ptr<AttachmentWriter> writer,
+        const std::vector<std::string>& customHeaders) override {
+        return nullptr;
+    }
+
+private:
+    const std::string m_url;
+    const std::string m_body;
+    const bool m_sendContentLength;
+    std::shared_future<void> m_reply;
+    std::atomic<State> m_state;
+    std::thread m_thread;
+};
+
+/**
+ * Creates @c LocalContentFetcher instances serving the same body for every URL.
+ */
+class LocalContentFetcherFactory : public HTTPContentFetcherInterfaceFactoryInterface {
+public:
+    std::unique_ptr<HTTPContentFetcherInterface> create(const std::string& url) override {
+        fetches++;
+        return std::unique_ptr<HTTPContentFetcherInterface>(new LocalContentFetcher(url, body, sendContentLength, reply));
+    }
+
+    /// The number of fetchers created, one per download attempt.
+    std::atomic<int> fetches{0};
+
+    /// The body served for every URL.
+    std::string body;
+
+    /// Whether the body size is announced in the headers.
+    bool sendContentLength = true;
+
+    /// When valid, the source replies only once this is ready.
+    std::shared_future<void> reply;
+};
+
+/**
+ * Records the cache events reported by the download manager.
+ */
+class RecordingObserver : public CachingDownloadManager::Observer {
+public:
+    void onCacheHit() override {
+        cacheHits++;
+    }
+
+    void onDownloadCoalesced() override {
+        coalescedDownloads++;
+    }
+
+    void onCacheEviction(uint64_t numberOfBytes) override {
+        evictions.push_back(numberOfBytes);
+    }
+
+    /// The number of packages served from the cache.
+    std::atomic<int> cacheHits{0};
+
+    /// The number of packages obtained from a download started by another request.
+    std::atomic<int> coalescedDownloads{0};
+
+    /// The sizes of the evicted packages, in eviction order.
+    std::vector<uint64_t> evictions;
+};
+
+class CachingDownloadManagerTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        char directoryTemplate[] = "/tmp/CachingDownloadManagerTestXXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(directoryTemplate));
+        m_directory = directoryTemplate;
+        m_fetcherFactory = std::make_shared<LocalContentFetcherFactory>();
+        m_downloadManager = createDownloadManager(1000, 0);
+    }
+
+    void TearDown() override {
+        m_downloadManager.reset();
+        if (system(("rm -rf " + m_directory).c_str()) != 0) {
+            std::cerr << "Failed to remove " << m_directory << std::endl;
+        }
+    }
+
+    /**
+     * Creates a download manager caching in the test directory.
+     *
+     * @param maxCacheSize Maximum number of cached packages.
+     * @param maxCacheSizeInBytes Maximum total size of cached packages in bytes, 0 for no limit.
+     * @return The download manager.
+     */
+    std::shared_ptr<CachingDownloadManager> createDownloadManager(
+        unsigned long maxCacheSize,
+        uint64_t maxCacheSizeInBytes) {
+        return std::make_shared<CachingDownloadManager>(
+            m_fetcherFactory,
+            600,
+            maxCacheSize,
+            maxCacheSizeInBytes,
+            std::make_shared<InMemoryMiscStorage>(),
+            std::make_shared<alexaClientSDK::registrationManager::CustomerDataManager>(),
+            m_directory + "/cache");
+    }
+
+    /**
+     * Retrieves @c url, serving @c body if it has to be downloaded.
+     *
+     * @return Whether the content was downloaded rather than served from the cache.
+     */
+    bool retrieveDownloads(const std::string& url, const std::string& body) {
+        m_fetcherFactory->body = body;
+        int fetches = m_fetcherFactory->fetches;
+        EXPECT_EQ(body, m_downloadManager->retrieveContent(url, m_observer));
+        return m_fetcherFactory->fetches != fetches;
+    }
+
+    /**
+     * Downloads a package of @c size bytes from a new URL, so that it is never served from the cache.
+     *
+     * @return The time taken for the content to be returned.
+     */
+    std::chrono::microseconds timeDownload(size_t size) {
+        m_fetcherFactory->body = std::string(size, 'x');
+        auto url = "http://localhost/package" + std::to_string(m_downloads++) + ".json";
+        auto start = std::chrono::steady_clock::now();
+        auto content = m_downloadManager->retrieveContent(url);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(m_fetcherFactory->body, content);
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    }
+
+protected:
+    std::string m_directory;
+    std::shared_ptr<LocalContentFetcherFactory> m_fetcherFactory;
+    std::shared_ptr<CachingDownloadManager> m_downloadManager;
+    std::shared_ptr<RecordingObserver> m_observer = std::make_shared<RecordingObserver>();
+    int m_downloads = 0;
+};
+
+TEST_F(CachingDownloadManagerTest, EntryLimitEvictsLeastRecentlyUsed) {
+    m_downloadManager = createDownloadManager(2, 0);
+    ASSERT_TRUE(retrieveDownloads("http://localhost/a.json", "a"));
+    ASSERT_TRUE(retrieveDownloads("http://localhost/b.json", "b"));
+    // Accessing a makes b the least recently used entry.
+    ASSERT_FALSE(retrieveDownloads("http://localhost/a.json", "a"));
+    ASSERT_TRUE(retrieveDownloads("http://localhost/c.json", "c"));
+
+    ASSERT_EQ(std::vector<uint64_t>{1}, m_observer->evictions);
+    ASSERT_FALSE(retrieveDownloads("http://localhost/a.json", "a"));
+    ASSERT_FALSE(retrieveDownloads("http://localhost/c.json", "c"));
+    ASSERT_TRUE(retrieveDownloads("http://localhost/b.json", "b"));
+}
+
+TEST_F(CachingDownloadManagerTest, ByteLimitEvictsLeastRecentlyUsed) {
+    m_downloadManager = createDownloadManager(1000, 3 * SMALL_PACKAGE_SIZE);
+    auto a = std::string(SMALL_PACKAGE_SIZE, 'a');
+    auto b = std::string(SMALL_PACKAGE_SIZE, 'b');
+    auto c = std::string(2 * SMALL_PACKAGE_SIZE, 'c');
+    ASSERT_TRUE(retrieveDownloads("http://localhost/a.json", a));
+    ASSERT_TRUE(retrieveDownloads("http://localhost/b.json", b));
+    // Accessing a makes b the least recently used entry.
+    ASSERT_FALSE(retrieveDownloads("http://localhost/a.json", a));
+    // c only fits once b is evicted.
+    ASSERT_TRUE(retrieveDownloads("http://localhost/c.json", c));
+
+    ASSERT_EQ(std::vector<uint64_t>{SMALL_PACKAGE_SIZE}, m_observer->evictions);
+    ASSERT_FALSE(retrieveDownloads("http://localhost/a.json", a));
+    ASSERT_FALSE(retrieveDownloads("http://localhost/c.json", c));
+    ASSERT_TRUE(retrieveDownloads("http://localhost/b.json", b));
+}
+
+TEST_F(CachingDownloadManagerTest, ConcurrentRequestsShareOneDownload) {
+    std::promise<void> reply;
+    m_fetcherFactory->reply = reply.get_future().share();
+    m_fetcherFactory->body = std::string(SMALL_PACKAGE_SIZE, 'z');
+
+    std::vector<std::string> contents(CONCURRENT_CALLERS);
+    std::vector<std::thread> callers;
+    for (int i = 0; i < CONCURRENT_CALLERS; i++) {
+        callers.emplace_back([this, &contents, i] {
+            contents[i] = m_downloadManager->retrieveContent("http://localhost/shared.json", m_observer);
+        });
+    }
+    std::this_thread::sleep_for(CONCURRENT_CALLERS_DELAY);
+    reply.set_value();
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    ASSERT_EQ(1, m_fetcherFactory->fetches);
+    for (auto& content : contents) {
+        ASSERT_EQ(m_fetcherFactory->body, content);
+    }
+    // Callers that joined the download got content that was not cached yet, so none of them is a cache hit.
+    ASSERT_EQ(CONCURRENT_CALLERS - 1, m_observer->coalescedDownloads);
+    ASSERT_EQ(0, m_observer->cacheHits);
+}
+
+TEST_F(CachingDownloadManagerTest, DownloadWithoutContentLength) {
+    m_fetcherFactory->sendContentLength = false;
+    m_fetcherFactory->body = std::string(LARGE_PACKAGE_SIZE, 'y');
+    ASSERT_EQ(m_fetcherFactory->body, m_downloadManager->retrieveContent("http://localhost/unsized.json"));
+}
+
+TEST_F(CachingDownloadManagerTest, SecondRequestServedFromCache) {
+    m_fetcherFactory->body = std::string(SMALL_PACKAGE_SIZE, 'z');
+    ASSERT_EQ(m_fetcherFactory->body, m_downloadManager->retrieveContent("http://localhost/cached.json"));
+    auto body = m_fetcherFactory->body;
+    m_fetcherFactory->body = "changed";
+    ASSERT_EQ(body, m_downloadManager->retrieveContent("http://localhost/cached.json"));
+}
+
+/**
+ * Measures the time to content for small and large packages served by the local source.
+ */
+TEST_F(CachingDownloadManagerTest, TimeToContentBenchmark) {
+    for (auto size : {SMALL_PACKAGE_SIZE, LARGE_PACKAGE_SIZE}) {
+        std::chrono::microseconds total{0};
+        for (int i = 0; i < BENCHMARK_DOWNLOADS; i++) {
+            total += timeDownload(size);
+        }
+        std::cout << "Time to content for " << size << " byte package: " << (total / BENCHMARK_DOWNLOADS).count()
+                  << " us" << std::endl;
+    }
+}
+
+}  // namespace test
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
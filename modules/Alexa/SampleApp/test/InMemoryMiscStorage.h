@@ -0,0 +1,116 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_TEST_INMEMORYMISCSTORAGE_H_
+#define ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_TEST_INMEMORYMISCSTORAGE_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <AVSCommon/SDKInterfaces/Storage/MiscStorageInterface.h>
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+namespace test {
+
+using alexaClientSDK::avsCommon::sdkInterfaces::storage::MiscStorageInterface;
+
+/**
+ * An in memory misc storage.
+ */
+class InMemoryMiscStorage : public MiscStorageInterface {
+public:
+    bool createDatabase() override {
+        return true;
+    }
+    bool open() override {
+        return true;
+    }
+    bool isOpened() override {
+        return true;
+    }
+    void close() override {
+    }
+    bool createTable(const std::string& component, const std::string& table, KeyType, ValueType) override {
+        tables[component + "." + table];
+        return true;
+    }
+    bool clearTable(const std::string& component, const std::string& table) override {
+        tables[component + "." + table].clear();
+        return true;
+    }
+    bool deleteTable(const std::string& component, const std::string& table) override {
+        tables.erase(component + "." + table);
+        return true;
+    }
+    bool get(const std::string& component, const std::string& table, const std::string& key, std::string* value)
+        override {
+        auto& rows = tables[component + "." + table];
+        auto it = rows.find(key);
+        if (it == rows.end()) {
+            return false;
+        }
+        *value = it->second;
+        return true;
+    }
+    bool add(const std::string& component, const std::string& table, const std::string& key, const std::string& value)
+        override {
+        return put(component, table, key, value);
+    }
+    bool update(
+        const std::string& component,
+        const std::string& table,
+        const std::string& key,
+        const std::string& value) override {
+        return put(component, table, key, value);
+    }
+    bool put(const std::string& component, const std::string& table, const std::string& key, const std::string& value)
+        override {
+        tables[component + "." + table][key] = value;
+        return true;
+    }
+    bool remove(const std::string& component, const std::string& table, const std::string& key) override {
+        tables[component + "." + table].erase(key);
+        return true;
+    }
+    bool tableEntryExists(const std::string& component, const std::string& table, const std::string& key, bool* exists)
+        override {
+        *exists = tables[component + "." + table].count(key) > 0;
+        return true;
+    }
+    bool tableExists(const std::string& component, const std::string& table, bool* exists) override {
+        *exists = tables.count(component + "." + table) > 0;
+        return true;
+    }
+    bool load(
+        const std::string& component,
+        const std::string& table,
+        std::unordered_map<std::string, std::string>* values) override {
+        for (auto& row : tables[component + "." + table]) {
+            (*values)[row.first] = row.second;
+        }
+        return true;
+    }
+
+    /// The tables, keyed by component and table name.
+    std::map<std::string, std::map<std::string, std::string>> tables;
+};
+
+}  // namespace test
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
+
+#endif  // ALEXA_SMART_SCREEN_SDK_SAMPLEAPP_TEST_INMEMORYMISCSTORAGE_H_
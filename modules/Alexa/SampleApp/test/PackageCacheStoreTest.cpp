@@ -0,0 +1,265 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <SampleApp/PackageCacheStore.h>
+
+#include "InMemoryMiscStorage.h"
+
+namespace alexaSmartScreenSDK {
+namespace sampleApp {
+namespace test {
+
+using namespace ::testing;
+
+/// A package source.
+static const std::string SOURCE = "https://arl.assets.apl-alexa.com/packages/alexa-layouts/1.2.0/document.json";
+
+/// Another package source.
+static const std::string OTHER_SOURCE = "https://arl.assets.apl-alexa.com/packages/alexa-styles/1.2.0/document.json";
+
+/// A package content.
+static const std::string CONTENT = R"({"type":"APL","version":"1.4","layouts":{}})";
+
+/// Another package content.
+static const std::string OTHER_CONTENT = R"({"type":"APL","version":"1.4","styles":{}})";
+
+/// The file marking the package directory as owned by the store.
+static const std::string MARKER_FILE_NAME = ".aplPackageCache";
+
+/// A file that does not belong to the store.
+static const std::string FOREIGN_FILE_NAME = "notes.txt";
+
+class PackageCacheStoreTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        char directoryTemplate[] = "/tmp/PackageCacheStoreTestXXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(directoryTemplate));
+        m_root = directoryTemplate;
+        m_directory = m_root + "/cache";
+        m_packageDirectory = m_directory + "/packages";
+        m_miscStorage = std::make_shared<InMemoryMiscStorage>();
+        m_store = PackageCacheStore::create(m_directory, m_miscStorage);
+        ASSERT_NE(nullptr, m_store);
+    }
+
+    void TearDown() override {
+        m_store.reset();
+        listFiles();
+        for (auto& name : m_files) {
+            unlink((m_packageDirectory + "/" + name).c_str());
+        }
+        unlink((m_packageDirectory + "/" + MARKER_FILE_NAME).c_str());
+        unlink((m_directory + "/" + FOREIGN_FILE_NAME).c_str());
+        rmdir(m_packageDirectory.c_str());
+        rmdir(m_directory.c_str());
+        rmdir(m_root.c_str());
+    }
+
+    /**
+     * Updates @c m_files with the files in the package directory, other than the marker.
+     */
+    void listFiles() {
+        m_files.clear();
+        if (auto dir = opendir(m_packageDirectory.c_str())) {
+            while (auto entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name != "." && name != ".." && name != MARKER_FILE_NAME) {
+                    m_files.push_back(name);
+                }
+            }
+            closedir(dir);
+        }
+    }
+
+protected:
+    std::string m_root;
+    std::string m_directory;
+    std::string m_packageDirectory;
+    std::shared_ptr<InMemoryMiscStorage> m_miscStorage;
+    std::shared_ptr<PackageCacheStore> m_store;
+    std::vector<std::string> m_files;
+};
+
+TEST_F(PackageCacheStoreTest, PutAndRead) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    ASSERT_EQ(SOURCE, entry.source);
+    ASSERT_EQ(CONTENT.size(), entry.size);
+    ASSERT_EQ(PackageCacheStore::contentFileName(CONTENT), entry.fileName);
+
+    std::string content;
+    ASSERT_TRUE(m_store->read(entry, &content));
+    ASSERT_EQ(CONTENT, content);
+}
+
+TEST_F(PackageCacheStoreTest, IdenticalContentSharesFile) {
+    PackageCacheStore::Entry entry;
+    PackageCacheStore::Entry otherEntry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    ASSERT_TRUE(m_store->put(OTHER_SOURCE, CONTENT, &otherEntry));
+    listFiles();
+    ASSERT_EQ(1u, m_files.size());
+
+    m_store->remove(entry);
+    std::string content;
+    ASSERT_TRUE(m_store->read(otherEntry, &content));
+    ASSERT_EQ(CONTENT, content);
+
+    m_store->remove(otherEntry);
+    listFiles();
+    ASSERT_TRUE(m_files.empty());
+}
+
+TEST_F(PackageCacheStoreTest, ReplacingContentRemovesOldFile) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    ASSERT_TRUE(m_store->put(SOURCE, OTHER_CONTENT, &entry));
+    listFiles();
+    ASSERT_EQ(std::vector<std::string>{PackageCacheStore::contentFileName(OTHER_CONTENT)}, m_files);
+}
+
+TEST_F(PackageCacheStoreTest, IndexSurvivesRestartWithoutReadingContent) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    std::ofstream(m_packageDirectory + "/" + PackageCacheStore::contentFileName(OTHER_CONTENT) + ".tmp0") << "partial";
+
+    auto store = PackageCacheStore::create(m_directory, m_miscStorage);
+    std::vector<PackageCacheStore::Entry> entries;
+    ASSERT_TRUE(store->loadIndex(&entries));
+    ASSERT_EQ(1u, entries.size());
+    ASSERT_EQ(SOURCE, entries[0].source);
+    ASSERT_EQ(entry.fileName, entries[0].fileName);
+    ASSERT_EQ(
+        std::chrono::duration_cast<std::chrono::seconds>(entry.importTime.time_since_epoch()),
+        std::chrono::duration_cast<std::chrono::seconds>(entries[0].importTime.time_since_epoch()));
+
+    listFiles();
+    ASSERT_EQ(std::vector<std::string>{entry.fileName}, m_files);
+
+    std::string content;
+    ASSERT_TRUE(store->read(entries[0], &content));
+    ASSERT_EQ(CONTENT, content);
+}
+
+TEST_F(PackageCacheStoreTest, MissingFileDropsIndexEntry) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    unlink((m_packageDirectory + "/" + entry.fileName).c_str());
+
+    std::string content;
+    ASSERT_FALSE(m_store->read(entry, &content));
+
+    std::vector<PackageCacheStore::Entry> entries;
+    ASSERT_TRUE(PackageCacheStore::create(m_directory, m_miscStorage)->loadIndex(&entries));
+    ASSERT_TRUE(entries.empty());
+}
+
+TEST_F(PackageCacheStoreTest, LegacyTableIsRemoved) {
+    m_miscStorage->put("SmartScreenSampleApp", "Packages", SOURCE, "0||||" + CONTENT);
+    ASSERT_NE(nullptr, PackageCacheStore::create(m_directory, m_miscStorage));
+
+    bool exists = true;
+    ASSERT_TRUE(m_miscStorage->tableExists("SmartScreenSampleApp", "Packages", &exists));
+    ASSERT_FALSE(exists);
+}
+
+TEST_F(PackageCacheStoreTest, ClearRemovesEverything) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    ASSERT_TRUE(m_store->clear());
+
+    listFiles();
+    ASSERT_TRUE(m_files.empty());
+    std::vector<PackageCacheStore::Entry> entries;
+    ASSERT_TRUE(m_store->loadIndex(&entries));
+    ASSERT_TRUE(entries.empty());
+}
+
+TEST_F(PackageCacheStoreTest, CollidingContentIsNotShared) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    // Stand in for a different content with the same hash and size.
+    std::string colliding(CONTENT.size(), 'x');
+    std::ofstream(m_packageDirectory + "/" + entry.fileName, std::ios::trunc) << colliding;
+
+    PackageCacheStore::Entry otherEntry;
+    ASSERT_TRUE(m_store->put(OTHER_SOURCE, CONTENT, &otherEntry));
+    ASSERT_NE(entry.fileName, otherEntry.fileName);
+    std::string content;
+    ASSERT_TRUE(m_store->read(otherEntry, &content));
+    ASSERT_EQ(CONTENT, content);
+
+    std::vector<PackageCacheStore::Entry> entries;
+    ASSERT_TRUE(PackageCacheStore::create(m_directory, m_miscStorage)->loadIndex(&entries));
+    ASSERT_EQ(2u, entries.size());
+}
+
+TEST_F(PackageCacheStoreTest, ForeignFilesAreKept) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    std::ofstream(m_directory + "/" + FOREIGN_FILE_NAME) << "foreign";
+    std::ofstream(m_packageDirectory + "/" + FOREIGN_FILE_NAME) << "foreign";
+
+    std::vector<PackageCacheStore::Entry> entries;
+    ASSERT_TRUE(m_store->loadIndex(&entries));
+    ASSERT_TRUE(m_store->clear());
+
+    listFiles();
+    ASSERT_EQ(std::vector<std::string>{FOREIGN_FILE_NAME}, m_files);
+    ASSERT_TRUE(std::ifstream(m_directory + "/" + FOREIGN_FILE_NAME).good());
+}
+
+TEST_F(PackageCacheStoreTest, MissingMarkerKeepsFiles) {
+    PackageCacheStore::Entry entry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    unlink((m_packageDirectory + "/" + MARKER_FILE_NAME).c_str());
+
+    m_store->clear();
+    listFiles();
+    ASSERT_EQ(std::vector<std::string>{entry.fileName}, m_files);
+}
+
+TEST_F(PackageCacheStoreTest, RemovingSupersededEntryKeepsLatest) {
+    PackageCacheStore::Entry entry;
+    PackageCacheStore::Entry latestEntry;
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &entry));
+    ASSERT_TRUE(m_store->put(SOURCE, CONTENT, &latestEntry));
+    ASSERT_EQ(entry.fileName, latestEntry.fileName);
+
+    m_store->remove(entry);
+    ASSERT_FALSE(m_store->touch(&entry));
+    std::string content;
+    ASSERT_TRUE(m_store->read(latestEntry, &content));
+    std::vector<PackageCacheStore::Entry> entries;
+    ASSERT_TRUE(PackageCacheStore::create(m_directory, m_miscStorage)->loadIndex(&entries));
+    ASSERT_EQ(1u, entries.size());
+
+    ASSERT_TRUE(m_store->touch(&latestEntry));
+    m_store->remove(latestEntry);
+    listFiles();
+    ASSERT_TRUE(m_files.empty());
+}
+
+}  // namespace test
+}  // namespace sampleApp
+}  // namespace alexaSmartScreenSDK
@@ -560,9 +560,15 @@ private:
 
     /**
      * This is a state machine function to handle the renderDocument event.
+     *
+     * @param info The directive to be handled.
+     * @param token The presentation token of the directive.
+     * @param windowId The target window id of the directive, empty if it has none.
      */
     void executeRenderDocumentEvent(
-        const std::shared_ptr<alexaClientSDK::avsCommon::avs::CapabilityAgent::DirectiveInfo> info);
+        const std::shared_ptr<alexaClientSDK::avsCommon::avs::CapabilityAgent::DirectiveInfo> info,
+        const std::string& token,
+        const std::string& windowId);
 
     /**
      * This is a state machine function to handle the execute command event.
@@ -618,6 +624,15 @@ private:
      */
     void executeProactiveStateReport();
 
+    /**
+     * Adds the presentationSession to a visual context, without parsing it.
+     *
+     * @param visualContext The visual context JSON object.
+     * @return The payload of the rendered document state, or just the presentationSession if the visual context is not
+     * a JSON object.
+     */
+    std::string addPresentationSession(const std::string& visualContext);
+
     /**
      * Request a proactive state report on the appropriate thread
      */
@@ -652,6 +667,12 @@ private:
     /// The directive corresponding to the RenderDocument directive.
     std::shared_ptr<alexaClientSDK::avsCommon::avs::CapabilityAgent::DirectiveInfo> m_lastDisplayedDirective;
 
+    /// The presentation token of @c m_lastDisplayedDirective.
+    std::string m_lastDisplayedToken;
+
+    /// The target window id of @c m_lastDisplayedDirective, empty if it has none.
+    std::string m_lastDisplayedWindowId;
+
     /// The last executeCommand directive.
     std::pair<std::string, std::shared_ptr<alexaClientSDK::avsCommon::avs::CapabilityAgent::DirectiveInfo>>
         m_lastExecuteCommandTokenAndDirective;
@@ -793,8 +814,8 @@ private:
     std::map<MetricEvent, uint64_t> m_currentActiveCountPoints;
     /// @}
 
-    /// The last state which was reported to AVS
-    std::string m_lastReportedState;
+    /// The hash of the last visual context which was reported to AVS, used to skip unchanged proactive reports
+    alexaClientSDK::avsCommon::utils::Optional<size_t> m_lastReportedStateHash;
 
     /// The time of the last state report
     std::chrono::time_point<std::chrono::steady_clock> m_lastReportTime;
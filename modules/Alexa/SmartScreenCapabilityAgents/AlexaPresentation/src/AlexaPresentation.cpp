@@ -13,6 +13,7 @@
  * permissions and limitations under the License.
  */
 
+#include <functional>
 #include <ostream>
 #include <regex>
 
@@ -72,6 +73,10 @@ static const std::string ALEXAPRESENTATION_STATE_REPORT_CHECK_INTERVAL_KEY = "st
 
 /// StaticRequestToken value for providing Change Report state
 static const int PROACTIVE_STATE_REQUEST_TOKEN = 0;
+
+/// The whitespace allowed around the visual context JSON object
+static const char WHITESPACE[] = " \t\r\n";
+
 /**
  * Create a LogEntry using this file's TAG and the specified event string.
  *
@@ -583,6 +588,23 @@ bool AlexaPresentation::parseDirectivePayload(std::shared_ptr<DirectiveInfo> inf
     }
 }
 
+/**
+ * Get the target windowId from the parsed payload of renderDocument message with APL document
+ *
+ * @param payload - the parsed payload of the message
+ * @return The windowId for APL payload, empty string otherwise.
+ */
+static const std::string getTargetWindowId(const rapidjson::Value& payload) {
+    std::string targetWindowId;
+    if (!jsonUtils::retrieveValue(payload, WINDOW_ID, &targetWindowId)) {
+        ACSDK_ERROR(LX("getTargetWindowIdFailed").d("reason", "Couldn't find windowId in APL document"));
+        return "";
+    }
+    ACSDK_DEBUG5(LX(__func__).d("Target Window Id", targetWindowId));
+
+    return targetWindowId;
+}
+
 void AlexaPresentation::handleRenderDocumentDirective(std::shared_ptr<DirectiveInfo> info) {
     ACSDK_DEBUG5(LX(__func__));
 
@@ -622,8 +644,9 @@ void AlexaPresentation::handleRenderDocumentDirective(std::shared_ptr<DirectiveI
         }
         m_documentInteractionTimeout = TimeoutTypeUtils::asDuration(maybeValidTimeout.value());
 
-        std::string APLdocument;
-        if (!jsonUtils::retrieveValue(payload, DOCUMENT_FIELD, &APLdocument)) {
+        // The document is only checked for here, it is extracted from the payload by the observers
+        rapidjson::Value::ConstMemberIterator iterator;
+        if (!jsonUtils::findNode(payload, DOCUMENT_FIELD, &iterator)) {
             ACSDK_ERROR(LX("handleRenderDocumentDirectiveFailedInExecutor").d("reason", "NoDocument"));
             sendExceptionEncounteredAndReportFailed(info, "missing APLdocument");
             notifyAbort();
@@ -631,23 +654,19 @@ void AlexaPresentation::handleRenderDocumentDirective(std::shared_ptr<DirectiveI
         }
 
         PresentationSession presentationSession = {};
-        rapidjson::Value::ConstMemberIterator iterator;
-        std::string presentationSessionPayload;
-        if (jsonUtils::findNode(payload, PRESENTATION_SESSION_FIELD, &iterator) &&
-            jsonUtils::convertToValue(iterator->value, &presentationSessionPayload)) {
+        if (jsonUtils::findNode(payload, PRESENTATION_SESSION_FIELD, &iterator) && iterator->value.IsObject()) {
+            const auto& doc = iterator->value;
             std::string skillId;
-            if (!jsonUtils::retrieveValue(presentationSessionPayload, SKILL_ID, &skillId)) {
+            if (!jsonUtils::retrieveValue(doc, SKILL_ID, &skillId)) {
                 ACSDK_WARN(
                     LX("handleRenderDocumentDirectiveInExecutor").m("Failed to find presentationSession skillId"));
             }
 
             std::string id;
-            if (!jsonUtils::retrieveValue(presentationSessionPayload, PRESENTATION_SESSION_ID, &id)) {
+            if (!jsonUtils::retrieveValue(doc, PRESENTATION_SESSION_ID, &id)) {
                 ACSDK_WARN(LX("handleRenderDocumentDirectiveInExecutor").m("Failed to find presentationSession id"));
             }
 
-            rapidjson::Document doc;
-            doc.Parse(presentationSessionPayload);
             std::vector<smartScreenSDKInterfaces::GrantedExtension> grantedExtensions;
             if (doc.HasMember(PRESENTATION_SESSION_GRANTEDEXTENSIONS) &&
                 doc[PRESENTATION_SESSION_GRANTEDEXTENSIONS].IsArray()) {
@@ -705,7 +724,8 @@ void AlexaPresentation::handleRenderDocumentDirective(std::shared_ptr<DirectiveI
             m_presentationSession = presentationSession;
         }
 
-        executeRenderDocumentEvent(info);
+        // The token and window id are kept with the directive, so that rendering it does not parse it again
+        executeRenderDocumentEvent(info, presentationToken, getTargetWindowId(payload));
     });
 }
 
@@ -848,17 +868,14 @@ void AlexaPresentation::handleUnknownDirective(std::shared_ptr<DirectiveInfo> in
 }
 
 /**
- * Get the token from payload of renderDocument message with APL document
+ * Get the token from the parsed payload of renderDocument message with APL document
  *
- * @param payload - the payload of the message
+ * @param payload - the parsed payload of the message
  * @return The token for APL payload, empty string otherwise.
  */
-static const std::string getAPLToken(const std::string& payload) {
-    rapidjson::Document document;
-    document.Parse(payload);
-
+static const std::string getAPLToken(const rapidjson::Value& payload) {
     std::string APLToken;
-    if (!jsonUtils::retrieveValue(document, PRESENTATION_TOKEN, &APLToken)) {
+    if (!jsonUtils::retrieveValue(payload, PRESENTATION_TOKEN, &APLToken)) {
         ACSDK_ERROR(LX("getAPLTokenFailed").d("reason", "Couldn't find token in APL document"));
         return "";
     }
@@ -868,23 +885,16 @@ static const std::string getAPLToken(const std::string& payload) {
 }
 
 /**
- * Get the target windowId from payload of renderDocument message with APL document
+ * Get the token from payload of renderDocument message with APL document
  *
  * @param payload - the payload of the message
- * @return The windowId for APL payload, empty string otherwise.
+ * @return The token for APL payload, empty string otherwise.
  */
-static const std::string getTargetWindowId(const std::string& payload) {
+static const std::string getAPLToken(const std::string& payload) {
     rapidjson::Document document;
     document.Parse(payload);
 
-    std::string targetWindowId;
-    if (!jsonUtils::retrieveValue(document, WINDOW_ID, &targetWindowId)) {
-        ACSDK_ERROR(LX("getTargetWindowIdFailed").d("reason", "Couldn't find windowId in APL document"));
-        return "";
-    }
-    ACSDK_DEBUG5(LX(__func__).d("Target Window Id", targetWindowId));
-
-    return targetWindowId;
+    return getAPLToken(document);
 }
 
 void AlexaPresentation::executeRenderDocumentCallbacks(bool isClearCard) {
@@ -893,8 +903,8 @@ void AlexaPresentation::executeRenderDocumentCallbacks(bool isClearCard) {
     std::string windowId;
 
     if (!isClearCard) {
-        newToken = getAPLToken(m_lastDisplayedDirective->directive->getPayload());
-        windowId = getTargetWindowId(m_lastDisplayedDirective->directive->getPayload());
+        newToken = m_lastDisplayedToken;
+        windowId = m_lastDisplayedWindowId;
     }
 
     ACSDK_DEBUG3(LX(__func__)
@@ -1170,9 +1180,13 @@ void AlexaPresentation::executeOnFocusChangedEvent(avsCommon::avs::FocusState ne
 }
 
 void AlexaPresentation::executeRenderDocumentEvent(
-    const std::shared_ptr<alexaClientSDK::avsCommon::avs::CapabilityAgent::DirectiveInfo> info) {
+    const std::shared_ptr<alexaClientSDK::avsCommon::avs::CapabilityAgent::DirectiveInfo> info,
+    const std::string& token,
+    const std::string& windowId) {
     smartScreenSDKInterfaces::State nextState = m_state;
     m_lastDisplayedDirective = info;
+    m_lastDisplayedToken = token;
+    m_lastDisplayedWindowId = windowId;
 
     switch (m_state) {
         case smartScreenSDKInterfaces::State::IDLE:
@@ -1299,7 +1313,7 @@ void AlexaPresentation::executeProvideState(unsigned int stateRequestToken) {
         m_visualStateProvider->provideState(m_lastRenderedAPLToken, stateRequestToken);
     } else {
         m_contextManager->setState(RENDERED_DOCUMENT_STATE, "", StateRefreshPolicy::SOMETIMES, stateRequestToken);
-        m_lastReportedState.clear();
+        m_lastReportedStateHash.reset();
     }
 }
 
@@ -1308,30 +1322,17 @@ void AlexaPresentation::onVisualContextAvailable(const unsigned int requestToken
     m_executor->submit([this, requestToken, visualContext]() {
         ACSDK_DEBUG3(LX("onVisualContextAvailableExecutor"));
 
-        rapidjson::Document doc;
-        std::string payload;
-
-        // If valid visualContext, add presentationSession to payload
-        if (!doc.Parse(visualContext).HasParseError()) {
-            rapidjson::StringBuffer buffer;
-            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-            m_presentationSession.addPresentationSessionPayload(&doc);
-            doc.Accept(writer);
-            payload = buffer.GetString();
-        } else {
-            // Otherwise make presentationSession the payload.
-            payload = m_presentationSession.getPresentationSessionPayload();
-        }
-
+        std::string payload = addPresentationSession(visualContext);
         CapabilityState state(payload);
         m_lastReportTime = std::chrono::steady_clock::now();
         m_stateReportPending = false;
         if (PROACTIVE_STATE_REQUEST_TOKEN == requestToken) {
             // Proactive visualContext report
-            if (m_lastReportedState != visualContext) {
+            auto stateHash = std::hash<std::string>()(visualContext);
+            if (!m_lastReportedStateHash.hasValue() || m_lastReportedStateHash.value() != stateHash) {
                 m_contextManager->reportStateChange(
                     RENDERED_DOCUMENT_STATE, state, AlexaStateChangeCauseType::ALEXA_INTERACTION);
-                m_lastReportedState = visualContext;
+                m_lastReportedStateHash.set(stateHash);
             }
         } else {
             if (m_lastDisplayedDirective && !m_lastRenderedAPLToken.empty() &&
@@ -1345,12 +1346,34 @@ void AlexaPresentation::onVisualContextAvailable(const unsigned int requestToken
                     m_presentationSession.getPresentationSessionPayload(),
                     StateRefreshPolicy::SOMETIMES,
                     requestToken);
-                m_lastReportedState.clear();
+                m_lastReportedStateHash.reset();
             }
         }
     });
 }
 
+std::string AlexaPresentation::addPresentationSession(const std::string& visualContext) {
+    // The visual context is a single JSON object written by the APL client, so the presentation session is spliced in
+    // rather than parsing and serializing the whole component tree again
+    auto start = visualContext.find_first_not_of(WHITESPACE);
+    auto end = visualContext.find_last_not_of(WHITESPACE);
+    if (start == std::string::npos || visualContext[start] != '{' || visualContext[end] != '}') {
+        ACSDK_WARN(LX("addPresentationSessionFailed").d("reason", "invalidVisualContext"));
+        return m_presentationSession.getPresentationSessionPayload();
+    }
+
+    auto session = m_presentationSession.getPresentationSessionPayload();
+    std::string payload;
+    payload.reserve(end - start + session.size());
+    payload.append(visualContext, start, end - start);
+    if (visualContext.find_first_not_of(WHITESPACE, start + 1) != end) {
+        payload.push_back(',');
+    }
+    // The session payload is an object holding just the presentationSession member
+    payload.append(session, 1, std::string::npos);
+    return payload;
+}
+
 void AlexaPresentation::setAPLMaxVersion(const std::string& APLMaxVersion) {
     ACSDK_DEBUG1(LX(__func__).d("APLVersion", APLMaxVersion));
 
@@ -33,6 +33,17 @@ public:
      * @param payload an arbitrary string
      */
     virtual void onMessage(const std::string& payload) = 0;
+
+    /**
+     * Called when a new message is available on the arbitrary source channel, handing over the payload.
+     * Listeners which keep the payload beyond the call should override this to take it without a copy.
+     *
+     * @note Blocking in this handler will block delivery of further messages.
+     * @param payload an arbitrary string
+     */
+    virtual void onMessage(std::string&& payload) {
+        onMessage(static_cast<const std::string&>(payload));
+    }
 };
 
 }  // namespace smartScreenSDKInterfaces
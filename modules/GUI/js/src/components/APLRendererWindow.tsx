@@ -74,6 +74,10 @@ export class WebsocketConnectionWrapper extends APLClient {
 export class WindowWebsocketClient extends APLClient {
   protected client : WebsocketConnectionWrapper;
   protected windowId : string;
+  // Results of the "measure" requests of the batch being answered, if any
+  protected measureBatchResults : any[];
+  // Names of the properties used in "dirtyDelta" messages, keyed by property id
+  protected dirtyPropertyNames : {[propertyId : string] : string} = {};
 
   constructor(client : WebsocketConnectionWrapper) {
     super();
@@ -85,6 +89,17 @@ export class WindowWebsocketClient extends APLClient {
   }
 
   public sendMessage(message : any) {
+    if (message.type === 'measure' && this.measureBatchResults) {
+      this.measureBatchResults.push(message.payload);
+      return;
+    }
+    if (message.type === 'build') {
+      // Batched measurement and delta encoded updates are handled here rather than in apl-client, see
+      // handleMeasureBatch and decodeDirtyDelta
+      message.payload.measureBatch = true;
+      message.payload.dirtyEncoding = 'delta';
+    }
+
     switch (message.type) {
       case 'executeCommands' :
       case 'renderComplete':
@@ -115,8 +130,53 @@ export class WindowWebsocketClient extends APLClient {
 
   public handleMessage(message : IAPLCoreMessage) {
     const unwrapped = message.payload;
+    if (unwrapped.type === 'measureBatch') {
+      this.handleMeasureBatch(unwrapped);
+      return;
+    }
+    if (unwrapped.type === 'dirtyDelta') {
+      this.onMessage(this.decodeDirtyDelta(unwrapped));
+      return;
+    }
     this.onMessage(unwrapped);
   }
+
+  /**
+   * apl-client only understands "dirty" messages. A "dirtyDelta" message carries the names of the properties it uses
+   * for the first time, keyed by property id, and updates which are either a full update in the "dirty" format or
+   * [id, propertyId, value, propertyId, value, ...]. It is turned back into the equivalent "dirty" message.
+   */
+  protected decodeDirtyDelta(message : any) : any {
+    Object.assign(this.dirtyPropertyNames, message.payload.names || {});
+    const dirty = message.payload.dirty.map((update : any) => {
+      if (!Array.isArray(update)) {
+        return update;
+      }
+      const component : any = {id: update[0]};
+      for (let i = 1; i < update.length; i += 2) {
+        component[this.dirtyPropertyNames[update[i]]] = update[i + 1];
+      }
+      return component;
+    });
+    return {type: 'dirty', seqno: message.seqno, payload: dirty};
+  }
+
+  /**
+   * apl-client only answers single "measure" requests. A batch is answered by handing each of its texts to
+   * apl-client as a "measure" request, which it answers synchronously, and replying with the results in order.
+   */
+  protected handleMeasureBatch(message : any) {
+    const results : any[] = [];
+    this.measureBatchResults = results;
+    try {
+      for (const payload of message.payload) {
+        this.onMessage({type: 'measure', seqno: message.seqno, payload});
+      }
+    } finally {
+      this.measureBatchResults = undefined;
+    }
+    this.sendMessage({type: 'measureBatch', seqno: message.seqno, payload: results});
+  }
 }
 
 interface IAPLRendererWindowState {
@@ -78,6 +78,7 @@ export class Client implements IClient {
     protected ws : WebSocket;
     protected onMessage : IOnMessageFunc;
     protected logger : ILogger;
+    protected textDecoder : TextDecoder = new TextDecoder();
 
     protected onclose(ev : CloseEvent) : void {
         this.connected = false;
@@ -116,10 +117,12 @@ export class Client implements IClient {
     protected wsOnMessage(event : MessageEvent) {
         this.logger.info('received message');
         let message : IBaseInboundMessage = undefined;
+        // Binary frames carry the same UTF-8 JSON as text frames
+        const data : string = typeof event.data === 'string' ? event.data : this.textDecoder.decode(event.data);
         try {
-            message = JSON.parse(event.data);
+            message = JSON.parse(data);
         } catch (e) {
-            this.logger.error(`error parsing data: ${event.data}`);
+            this.logger.error(`error parsing data: ${data}`);
         }
 
         if (this.onMessage) {
@@ -133,6 +136,7 @@ export class Client implements IClient {
         const callback = () => {
             that.timerId = undefined;
             that.ws = new WebSocket(that.url);
+            that.ws.binaryType = 'arraybuffer';
             that.ws.onmessage = that.wsOnMessage.bind(that);
             that.ws.onclose = that.onclose.bind(that);
             that.ws.onopen = that.onopen.bind(that);